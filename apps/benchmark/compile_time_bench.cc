@@ -0,0 +1,206 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file compile_time_bench.cc
+ * \brief Benchmark the time TVM takes to lower and build a fixed corpus of operators.
+ *
+ *  Each workload is scheduled, lowered through BuildStmt and built through
+ *  codegen::Build. The time of each phase is reported per workload, the time
+ *  of each lowering pass is taken from the lowering pipeline profile, and the
+ *  peak memory is the maximum resident set size of the process.
+ *
+ *  Usage: compile_time_bench [--target llvm] [--repeat 3] [workload ...]
+ */
+#include <dmlc/logging.h>
+#include <tvm/tvm.h>
+#include <tvm/build_module.h>
+#include <tvm/packed_func_ext.h>
+#include <tvm/runtime/registry.h>
+#include <topi/nn.h>
+#include <topi/nn/dense.h>
+#include <topi/nn/softmax.h>
+#include <topi/reduction.h>
+#include <topi/x86/default.h>
+#include <topi/x86/dense.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace tvm;
+
+/*! \brief An operator to be compiled. */
+struct Workload {
+  /*! \brief The name of the workload. */
+  std::string name;
+  /*! \brief Create the schedule and the arguments of the function. */
+  std::function<Schedule(const Target&, Array<Tensor>*)> fcreate;
+};
+
+Workload Conv2d(std::string name, int batch, int in_channel, int size,
+                int num_filter, int kernel, int stride, int pad) {
+  return {name, [=](const Target& target, Array<Tensor>* args) {
+      Tensor data = placeholder({batch, in_channel, size, size}, Float(32), "data");
+      Tensor weight = placeholder({num_filter, in_channel, kernel, kernel}, Float(32), "weight");
+      Tensor out = topi::conv2d_nchw(data, weight, pad, pad, stride, stride);
+      *args = {data, weight, out};
+      return topi::x86::default_schedule_auto_inline(target, {out});
+    }};
+}
+
+Workload DepthwiseConv2d(std::string name, int batch, int channel, int size,
+                         int kernel, int stride, int pad) {
+  return {name, [=](const Target& target, Array<Tensor>* args) {
+      Tensor data = placeholder({batch, channel, size, size}, Float(32), "data");
+      Tensor weight = placeholder({channel, 1, kernel, kernel}, Float(32), "weight");
+      Tensor out = topi::depthwise_conv2d_nchw(data, weight, pad, pad, stride, stride);
+      *args = {data, weight, out};
+      return topi::x86::default_schedule_auto_inline(target, {out});
+    }};
+}
+
+Workload Dense(std::string name, int batch, int in_dim, int out_dim) {
+  return {name, [=](const Target& target, Array<Tensor>* args) {
+      Tensor data = placeholder({batch, in_dim}, Float(32), "data");
+      Tensor weight = placeholder({out_dim, in_dim}, Float(32), "weight");
+      Tensor bias = placeholder({out_dim}, Float(32), "bias");
+      Tensor out = topi::x86::dense_x86(target, data, weight, bias);
+      *args = {data, weight, bias, out};
+      return topi::x86::schedule_dense(target, {out});
+    }};
+}
+
+Workload Softmax(std::string name, int batch, int num_class) {
+  return {name, [=](const Target& target, Array<Tensor>* args) {
+      Tensor data = placeholder({batch, num_class}, Float(32), "data");
+      Tensor out = topi::nn::softmax(data);
+      *args = {data, out};
+      return topi::x86::default_schedule(target, {out});
+    }};
+}
+
+Workload Reduce(std::string name, bool use_max, int rows, int cols) {
+  return {name, [=](const Target& target, Array<Tensor>* args) {
+      Tensor data = placeholder({rows, cols}, Float(32), "data");
+      Array<Integer> axis{Integer(1)};
+      Tensor out = use_max ? topi::max(data, axis) : topi::sum(data, axis);
+      *args = {data, out};
+      return topi::x86::default_schedule(target, {out});
+    }};
+}
+
+std::vector<Workload> Corpus() {
+  return {
+    Conv2d("conv2d_resnet_3x3", 1, 64, 56, 64, 3, 1, 1),
+    Conv2d("conv2d_resnet_1x1", 1, 256, 56, 64, 1, 1, 0),
+    Conv2d("conv2d_stride2", 1, 128, 28, 256, 3, 2, 1),
+    DepthwiseConv2d("depthwise_mobilenet", 1, 128, 56, 3, 1, 1),
+    DepthwiseConv2d("depthwise_stride2", 1, 256, 28, 3, 2, 1),
+    Dense("dense_1024", 1, 1024, 1024),
+    Dense("dense_batch", 64, 512, 2048),
+    Softmax("softmax_1000", 1, 1000),
+    Reduce("sum_rows", false, 128, 4096),
+    Reduce("max_rows", true, 128, 4096),
+  };
+}
+
+double Seconds(std::chrono::high_resolution_clock::time_point begin) {
+  return std::chrono::duration_cast<std::chrono::duration<double> >(
+      std::chrono::high_resolution_clock::now() - begin).count();
+}
+
+// peak resident set size in MB, ru_maxrss is in kilobytes on Linux.
+double PeakMemoryMB() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+const runtime::PackedFunc& GetGlobal(const std::string& name) {
+  const runtime::PackedFunc* f = runtime::Registry::Get(name);
+  CHECK(f != nullptr) << "Cannot find global function " << name;
+  return *f;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string target_name = "llvm";
+  int repeat = 3;
+  std::vector<std::string> selected;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--target" && i + 1 < argc) {
+      target_name = argv[++i];
+    } else if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, atoi(argv[++i]));
+    } else if (arg == "-h" || arg == "--help") {
+      printf("usage: %s [--target llvm] [--repeat 3] [workload ...]\n", argv[0]);
+      return 0;
+    } else {
+      selected.push_back(arg);
+    }
+  }
+  if (target_name == "llvm" && runtime::Registry::Get("codegen.build_llvm") == nullptr) {
+    LOG(INFO) << "LLVM is not enabled, build the C source instead";
+    target_name = "c";
+  }
+  Target target = Target::create(target_name);
+  BuildConfig config = build_config();
+
+  GetGlobal("_ResetLowerPassProfile")();
+  printf("%-24s %10s %10s %10s %10s %10s\n",
+         "workload", "schedule", "lower", "build", "total", "peak(MB)");
+  double sum_lower = 0, sum_build = 0;
+  for (const Workload& w : Corpus()) {
+    if (!selected.empty() &&
+        std::find(selected.begin(), selected.end(), w.name) == selected.end()) {
+      continue;
+    }
+    // the best of the repeats, the first run includes one-time initialization.
+    double t_schedule = 1e9, t_lower = 1e9, t_build = 1e9;
+    for (int r = 0; r < repeat; ++r) {
+      auto tbegin = std::chrono::high_resolution_clock::now();
+      Array<Tensor> args;
+      Schedule s = w.fcreate(target, &args);
+      t_schedule = std::min(t_schedule, Seconds(tbegin));
+
+      tbegin = std::chrono::high_resolution_clock::now();
+      std::unordered_map<Tensor, Buffer> binds;
+      Array<LoweredFunc> funcs = lower(s, args, w.name, binds, config);
+      t_lower = std::min(t_lower, Seconds(tbegin));
+
+      tbegin = std::chrono::high_resolution_clock::now();
+      runtime::Module m = build(funcs, target, Target(), config);
+      t_build = std::min(t_build, Seconds(tbegin));
+    }
+    sum_lower += t_lower;
+    sum_build += t_build;
+    printf("%-24s %10.4f %10.4f %10.4f %10.4f %10.1f\n",
+           w.name.c_str(), t_schedule, t_lower, t_build,
+           t_schedule + t_lower + t_build, PeakMemoryMB());
+  }
+  printf("%-24s %10s %10.4f %10.4f\n\n", "sum", "", sum_lower, sum_build);
+
+  // passes sorted by total time over all the runs.
+  Map<std::string, Array<Expr> > profile = GetGlobal("_GetLowerPassProfile")();
+  std::vector<std::pair<double, std::string> > passes;
+  for (const auto& kv : profile) {
+    passes.emplace_back(kv.second[1].as<ir::FloatImm>()->value, kv.first);
+  }
+  std::sort(passes.rbegin(), passes.rend());
+  printf("%-40s %8s %10s %10s\n", "pass", "calls", "total", "per call");
+  for (const auto& p : passes) {
+    int64_t num_calls = profile[p.second][0].as<ir::IntImm>()->value;
+    printf("%-40s %8ld %10.4f %10.6f\n", p.second.c_str(),
+           static_cast<long>(num_calls), p.first, p.first / num_calls);  // NOLINT(*)
+  }
+  return 0;
+}
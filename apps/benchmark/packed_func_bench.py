@@ -0,0 +1,51 @@
+"""Benchmark the overhead of global PackedFunc lookup and call.
+
+Each thread repeatedly looks up a global function by name, or calls
+a cached handle of it. The ctypes FFI releases the GIL during the C
+calls, so the multi-threaded numbers show the contention on the
+global registry.
+"""
+import argparse
+import threading
+import time
+
+import tvm
+
+
+def lookup(name, number):
+    for _ in range(number):
+        tvm.get_global_func(name)
+
+
+def call(name, number):
+    f = tvm.get_global_func(name)
+    for _ in range(number):
+        # device_type=cpu, device_id=0, attr=kExist
+        f(1, 0, 0)
+
+
+def evaluate(worker, name, num_threads, number):
+    threads = [threading.Thread(target=worker, args=(name, number))
+               for _ in range(num_threads)]
+    tic = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return (time.time() - tic) / number
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--number", type=int, default=100000)
+    parser.add_argument("--max-threads", type=int, default=4)
+    args = parser.parse_args()
+
+    name = "_GetDeviceAttr"
+    print("%-8s %-8s %s" % ("Threads", "Op", "Per op cost (us)"))
+    num_threads = 1
+    while num_threads <= args.max_threads:
+        for op, worker in [("lookup", lookup), ("call", call)]:
+            cost = evaluate(worker, name, num_threads, args.number)
+            print("%-8d %-8s %.3f" % (num_threads, op, cost * 1e6))
+        num_threads *= 2
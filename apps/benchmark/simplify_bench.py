@@ -0,0 +1,85 @@
+"""Benchmark the time spent in the expression simplifiers.
+
+The statements are captured from the lowering of the x86 conv2d and
+dense schedules, once before the canonical simplification and once
+after the loops are unrolled, where the same index expressions
+appear many times.
+"""
+import argparse
+import time
+
+import numpy as np
+import tvm
+import topi
+
+
+WORKLOADS = {
+    "conv2d_resnet_3x3": lambda: conv2d(1, 64, 56, 56, 64, 3, 1, 1),
+    "conv2d_resnet_1x1": lambda: conv2d(1, 256, 56, 56, 64, 1, 1, 0),
+    "conv2d_stride2": lambda: conv2d(1, 128, 28, 28, 256, 3, 2, 1),
+    "dense_1024": lambda: dense(1, 1024, 1024),
+    "dense_batch": lambda: dense(16, 512, 2048),
+}
+
+
+def conv2d(batch, in_channel, height, width, num_filter, kernel, stride, padding):
+    data = tvm.placeholder((batch, in_channel, height, width), name='data')
+    weight = tvm.placeholder((num_filter, in_channel, kernel, kernel), name='weight')
+    out = topi.nn.conv2d(data, weight, stride, padding, 1, 'NCHW', out_dtype='float32')
+    s = topi.generic.schedule_conv2d_nchw([out])
+    return s, [data, weight, out]
+
+
+def dense(batch, in_dim, out_dim):
+    data = tvm.placeholder((batch, in_dim), name='data')
+    weight = tvm.placeholder((out_dim, in_dim), name='weight')
+    out = topi.nn.dense(data, weight)
+    s = topi.generic.schedule_dense([out])
+    return s, [data, weight, out]
+
+
+def capture(s, args):
+    """Get the statements before simplification and after unrolling."""
+    stmts = {}
+
+    def make_pass(stage):
+        def _capture(stmt):
+            stmts[stage] = stmt
+            return stmt
+        return _capture
+
+    with tvm.build_config(add_lower_pass=[(0, make_pass("phase0")),
+                                          (2, make_pass("unrolled"))]):
+        tvm.lower(s, args)
+    return stmts
+
+
+def measure(fpass, stmt, repeat):
+    costs = []
+    for _ in range(repeat):
+        tic = time.time()
+        fpass(stmt)
+        costs.append(time.time() - tic)
+    return np.median(costs)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--workload", type=str, choices=['all'] + list(WORKLOADS), default='all')
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    passes = [("CanonicalSimplify", tvm.ir_pass.CanonicalSimplify),
+              ("Simplify", tvm.ir_pass.Simplify)]
+    names = sorted(WORKLOADS) if args.workload == 'all' else [args.workload]
+
+    print("%-20s %-10s %-18s %s" % ("Workload", "Stage", "Pass", "Time (ms)"))
+    for name in names:
+        with tvm.target.create(args.target):
+            sch, tensors = WORKLOADS[name]()
+        stmts = capture(sch, tensors)
+        for stage in ["phase0", "unrolled"]:
+            for pass_name, fpass in passes:
+                cost = measure(fpass, stmts[stage], args.repeat)
+                print("%-20s %-10s %-18s %.3f" % (name, stage, pass_name, cost * 1e3))
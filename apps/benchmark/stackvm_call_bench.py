@@ -0,0 +1,57 @@
+"""Benchmark the host side launch overhead of the stackvm interpreter.
+
+The host function packs a few arguments and calls a packed function
+in a loop, which is the pattern used to launch device kernels when
+the host is interpreted by stackvm. The llvm host is used as baseline
+when it is enabled.
+"""
+import argparse
+import time
+
+import numpy as np
+import tvm
+
+
+@tvm.register_func("tvm_stackvm_bench_nop")
+def _nop(*args):
+    return 0
+
+
+def build_launch_loop(num_args):
+    n = tvm.var('n')
+    Ab = tvm.decl_buffer((n, ), 'int64')
+    ib = tvm.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n, "i") as i:
+        call_args = [A[i] + k for k in range(num_args)]
+        ib.emit(tvm.call_packed("tvm_stackvm_bench_nop", *call_args))
+    fapi = tvm.ir_pass.MakeAPI(ib.get(), "launch_loop", [Ab], 0, True)
+    return tvm.ir_pass.LowerTVMBuiltin(fapi)
+
+
+def evaluate(target, fapi, length, repeat):
+    f = tvm.codegen.build_module(fapi, target)
+    a = tvm.nd.array(np.zeros(length, dtype='int64'))
+    f(a)
+    costs = []
+    for _ in range(repeat):
+        tic = time.time()
+        f(a)
+        costs.append(time.time() - tic)
+    return np.median(costs) / length
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-args", type=int, default=4)
+    parser.add_argument("--length", type=int, default=10000)
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    fapi = build_launch_loop(args.num_args)
+    print("%-10s %s" % ("Target", "Per call overhead (us)"))
+    for target in ["stackvm", "llvm"]:
+        if not tvm.module.enabled(target):
+            continue
+        cost = evaluate(target, fapi, args.length, args.repeat)
+        print("%-10s %.3f" % (target, cost * 1e6))
@@ -247,6 +247,19 @@ ExprIntSetMap EvalSetForEachSubExpr(
     Expr e,
     const std::unordered_map<const Variable*, IntSet>& dom_map);
 
+/*!
+ * \brief RAII scope that memoizes EvalSet in the current thread.
+ *
+ *  Within the scope, the set of each evaluated sub-expression is cached
+ *  and reused as long as the domains of its free variables are the same.
+ *  Scopes can be nested, the cache is dropped when the outermost one exits.
+ */
+class EvalSetCacheScope {
+ public:
+  EvalSetCacheScope();
+  ~EvalSetCacheScope();
+};
+
 /*!
  * \brief Create an union set of all sets
  * \param sets The sets to be unioned
@@ -68,6 +68,39 @@ inline NodeType LoadJSON(const std::string& json_str) {
   return NodeType(LoadJSON_(json_str));
 }
 
+/*!
+ * \brief save the node as well as all the node it depends on in binary format.
+ *  Compared to SaveJSON, the fields are stored as varints and the
+ *  NDArrays as raw data aligned to 64 bytes, which is faster to save
+ *  and load, and smaller for nodes with large constant tensors.
+ *
+ * \note The binary format can only be loaded by the same TVM version.
+ * \return The binary blob of the node.
+ */
+std::string SaveBinary(const NodeRef& node);
+
+/*!
+ * \brief Internal implementation of LoadBinary
+ * \param data The pointer to the binary blob.
+ * \param size The size of the binary blob.
+ *
+ * \return The shared_ptr of the Node.
+ */
+NodePtr<Node> LoadBinary_(const char* data, size_t size);
+
+/*!
+ * \brief Load the node from the binary blob saved by SaveBinary.
+ *
+ * \param blob The binary blob to load from.
+ *
+ * \tparam NodeType the nodetype
+ */
+template<typename NodeType,
+         typename = typename std::enable_if<std::is_base_of<NodeRef, NodeType>::value>::type >
+inline NodeType LoadBinary(const std::string& blob) {
+  return NodeType(LoadBinary_(blob.data(), blob.length()));
+}
+
 /*!
  * \brief Registry entry for NodeFactory.
  *
@@ -226,6 +226,18 @@ class BuildConfigNode : public Node {
   /*! \brief Whether to disable select rewriting. */
   bool disable_select_rewriting = false;
 
+  /*!
+   * \brief Whether to memoize the local lowering passes on each loop nest,
+   *  so that nests that are unchanged across builds are not lowered again.
+   */
+  bool incremental_lower = false;
+
+  /*!
+   * \brief The distance in bytes to prefetch the streaming loads of the innermost loops
+   *  ahead of their use on CPU. No prefetch is inserted if it is zero.
+   */
+  int cpu_prefetch_distance = 0;
+
   void VisitAttrs(AttrVisitor* v) final {
     v->Visit("data_alignment", &data_alignment);
     v->Visit("offset_factor", &offset_factor);
@@ -240,6 +252,8 @@ class BuildConfigNode : public Node {
     v->Visit("dump_pass_ir", &dump_pass_ir);
     v->Visit("instrument_bound_checkers", &instrument_bound_checkers);
     v->Visit("disable_select_rewriting", &disable_select_rewriting);
+    v->Visit("incremental_lower", &incremental_lower);
+    v->Visit("cpu_prefetch_distance", &cpu_prefetch_distance);
   }
 
   static constexpr const char* _type_key = "BuildConfig";
@@ -257,6 +257,15 @@ Stmt InjectVirtualThread(Stmt stmt);
  */
 Stmt InjectPrefetch(Stmt stmt);
 
+/*!
+ * \brief Prefetch the loads that advance by a constant stride
+ *  in the innermost loops, for CPU targets.
+ * \param stmt The statment to be transformed.
+ * \param distance The prefetch distance in bytes, no prefetch is inserted if it is not positive.
+ * \return Transformed stmt.
+ */
+Stmt InjectCPUPrefetch(Stmt stmt, int distance);
+
 /*!
  * \brief Inject double buffer into stmt.
  * \param stmt The statment to be transformed.
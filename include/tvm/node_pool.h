@@ -0,0 +1,278 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file tvm/node_pool.h
+ * \brief Pooled allocation of nodes that are created in large numbers.
+ *
+ *  Lowering a large network creates and destroys many small nodes.
+ *  make_pooled_node allocates them from per-type slabs, with a free list
+ *  cached by each thread, and recycles the memory through the deleter of
+ *  NodeBase instead of returning it to the general-purpose allocator.
+ */
+#ifndef TVM_NODE_POOL_H_
+#define TVM_NODE_POOL_H_
+
+#include <tvm/runtime/node_base.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+
+/*! \brief Allocation counters of the node pool of a type. */
+struct NodePoolStats {
+  /*! \brief The type key of the node. */
+  const char* type_key{nullptr};
+  /*! \brief The number of allocated nodes. */
+  std::atomic<int64_t> num_alloc{0};
+  /*! \brief The number of freed nodes. */
+  std::atomic<int64_t> num_free{0};
+  /*! \brief The number of slabs. */
+  std::atomic<int64_t> num_slab{0};
+  /*! \brief The total bytes of the slabs. */
+  std::atomic<int64_t> slab_bytes{0};
+};
+
+/*! \brief Registry of the counters of all the node pools. */
+class NodePoolRegistry {
+ public:
+  /*!
+   * \brief Add the counters of a pool.
+   * \param stats The counters, which live as long as the process.
+   */
+  void Register(NodePoolStats* stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools_.push_back(stats);
+  }
+  /*! \return The counters of all the pools. */
+  std::vector<const NodePoolStats*> List() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<const NodePoolStats*>(pools_.begin(), pools_.end());
+  }
+  /*! \return The global registry. */
+  static NodePoolRegistry* Global() {
+    static NodePoolRegistry inst;
+    return &inst;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<NodePoolStats*> pools_;
+};
+
+/*!
+ * \brief Slab allocator of a node type.
+ *
+ *  Nodes are carved from slabs of kSlabBytes, the free nodes are kept
+ *  in a list cached by each thread. Nodes freed by a thread are reused
+ *  by that thread, the cache is returned to the shared list of the type
+ *  when it grows too large or when the thread exits. Slabs are never
+ *  released, so the memory of the pool is bounded by its peak usage.
+ *
+ * \tparam T The node type.
+ */
+template<typename T>
+class NodePoolAllocator {
+ public:
+  /*! \brief The bytes of a slab. */
+  static constexpr size_t kSlabBytes = 64 * 1024;
+  /*!
+   * \brief Allocate and construct a node.
+   * \param args The arguments of the constructor.
+   * \return The node.
+   */
+  template<typename... Args>
+  static T* New(Args&&... args) {
+    void* data = Alloc();
+    try {
+      return new (data) T(std::forward<Args>(args)...);
+    } catch (...) {
+      Free(data);
+      throw;
+    }
+  }
+  /*! \return The deleter of the pooled nodes. */
+  static NodeBase::FDeleter Deleter() {
+    return Deleter_;
+  }
+  /*! \return The counters of the pool. */
+  static const NodePoolStats& Stats() {
+    return Pool()->stats;
+  }
+
+ private:
+  /*! \brief Link of a free node. */
+  struct FreeNode {
+    FreeNode* next;
+  };
+  /*! \brief The size and alignment of a slot. */
+  static constexpr size_t kSlotAlign =
+      alignof(T) > alignof(FreeNode) ? alignof(T) : alignof(FreeNode);
+  static constexpr size_t kSlotSize =
+      ((sizeof(T) > sizeof(FreeNode) ? sizeof(T) : sizeof(FreeNode)) +
+       kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+  /*! \brief The number of nodes in a slab. */
+  static constexpr size_t kSlabNodes =
+      kSlabBytes / kSlotSize > 16 ? kSlabBytes / kSlotSize : 16;
+  /*! \brief The number of nodes a thread keeps before returning half of them. */
+  static constexpr size_t kMaxCachedNodes = kSlabNodes * 4;
+  /*! \brief The shared state of the pool. */
+  struct SharedPool {
+    std::mutex mutex;
+    FreeNode* free_list{nullptr};
+    size_t num_free{0};
+    NodePoolStats stats;
+  };
+  /*! \brief The free list cached by a thread, trivially destructible. */
+  struct LocalCache {
+    FreeNode* head{nullptr};
+    size_t size{0};
+    bool guarded{false};
+    bool exited{false};
+  };
+  /*! \brief Return the cache to the shared pool when the thread exits. */
+  struct LocalCacheGuard {
+    LocalCache* cache;
+    explicit LocalCacheGuard(LocalCache* cache) : cache(cache) {}
+    ~LocalCacheGuard() {
+      ReturnToPool(cache, cache->size);
+      cache->exited = true;
+    }
+  };
+
+  static SharedPool* Pool() {
+    // leaked on purpose, nodes can be freed during static destruction.
+    static SharedPool* pool = [] {
+      SharedPool* p = new SharedPool();
+      p->stats.type_key = T::_type_key;
+      NodePoolRegistry::Global()->Register(&p->stats);
+      return p;
+    }();
+    return pool;
+  }
+
+  static LocalCache* Local() {
+    static thread_local LocalCache cache;
+    if (!cache.guarded) {
+      cache.guarded = true;
+      static thread_local LocalCacheGuard guard(&cache);
+    }
+    return &cache;
+  }
+
+  // Move the first n nodes of the cache to the shared list.
+  static void ReturnToPool(LocalCache* cache, size_t n) {
+    if (n == 0) return;
+    FreeNode* first = cache->head;
+    FreeNode* last = first;
+    for (size_t i = 1; i < n; ++i) {
+      last = last->next;
+    }
+    cache->head = last->next;
+    cache->size -= n;
+    SharedPool* pool = Pool();
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    last->next = pool->free_list;
+    pool->free_list = first;
+    pool->num_free += n;
+  }
+
+  // Refill the cache from the shared list, or from a new slab.
+  static void Refill(LocalCache* cache) {
+    SharedPool* pool = Pool();
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (pool->free_list != nullptr) {
+      size_t n = 0;
+      while (pool->free_list != nullptr && n < kSlabNodes) {
+        FreeNode* node = pool->free_list;
+        pool->free_list = node->next;
+        node->next = cache->head;
+        cache->head = node;
+        ++n;
+      }
+      pool->num_free -= n;
+      cache->size += n;
+      return;
+    }
+    char* slab = static_cast<char*>(::operator new(kSlabNodes * kSlotSize));
+    for (size_t i = kSlabNodes; i != 0; --i) {
+      FreeNode* node = reinterpret_cast<FreeNode*>(slab + (i - 1) * kSlotSize);
+      node->next = cache->head;
+      cache->head = node;
+    }
+    cache->size += kSlabNodes;
+    pool->stats.num_slab.fetch_add(1, std::memory_order_relaxed);
+    pool->stats.slab_bytes.fetch_add(kSlabNodes * kSlotSize, std::memory_order_relaxed);
+  }
+
+  static void* Alloc() {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "over-aligned nodes cannot be pooled");
+    Pool()->stats.num_alloc.fetch_add(1, std::memory_order_relaxed);
+    LocalCache* cache = Local();
+    if (cache->exited) {
+      // the thread is exiting, bypass the cache.
+      LocalCache tmp;
+      Refill(&tmp);
+      FreeNode* node = tmp.head;
+      tmp.head = node->next;
+      --tmp.size;
+      ReturnToPool(&tmp, tmp.size);
+      return node;
+    }
+    if (cache->head == nullptr) Refill(cache);
+    FreeNode* node = cache->head;
+    cache->head = node->next;
+    --cache->size;
+    return node;
+  }
+
+  static void Free(void* data) {
+    Pool()->stats.num_free.fetch_add(1, std::memory_order_relaxed);
+    FreeNode* node = static_cast<FreeNode*>(data);
+    LocalCache* cache = Local();
+    if (cache->exited) {
+      LocalCache tmp;
+      node->next = nullptr;
+      tmp.head = node;
+      tmp.size = 1;
+      ReturnToPool(&tmp, 1);
+      return;
+    }
+    node->next = cache->head;
+    cache->head = node;
+    if (++cache->size > kMaxCachedNodes) {
+      ReturnToPool(cache, cache->size / 2);
+    }
+  }
+
+  static void Deleter_(NodeBase* ptr) {
+    T* node = static_cast<T*>(ptr);
+    node->~T();
+    Free(node);
+  }
+};
+
+/*!
+ * \brief Allocate a node from the pool of its type.
+ *  Use it in place of make_node for the node types created in large numbers.
+ * \param args arguments to the constructor.
+ * \tparam T the node type.
+ * \return The NodePtr to the allocated object.
+ */
+template<typename T, typename... Args>
+inline NodePtr<T> make_pooled_node(Args&&... args) {
+  using Allocator = NodePoolAllocator<T>;
+  static_assert(std::is_base_of<NodeBase, T>::value,
+                "make_pooled_node can only be used to create NodeBase");
+  T* node = Allocator::New(std::forward<Args>(args)...);
+  node->deleter_ = Allocator::Deleter();
+  return NodePtr<T>(node);
+}
+
+}  // namespace tvm
+#endif  // TVM_NODE_POOL_H_
@@ -220,6 +220,15 @@ Expr DeadCodeElimination(const Expr& e);
  */
 Expr FoldConstant(const Expr& expr);
 
+/*!
+ * \brief Replace calls that compute the same value as a previous call
+ *  (same op, arguments and attributes) by that call.
+ *  Stateful operators are kept.
+ * \param expr the expression to be optimized.
+ * \return The optimized expression.
+ */
+Expr EliminateCommonSubexpr(const Expr& expr);
+
 /*!
  * \brief Fuse operations into expr into seperate functions.
  * \param expr The expression.
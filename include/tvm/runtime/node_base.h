@@ -25,10 +25,11 @@ class NodeRef;
  *
  * Node is a reference counted object which is used to construct AST.
  * Each node is backed by a custom deleter, which deletes the object.
- * Do not call create raw Node pointer, always use tvm::make_node.
+ * Do not call create raw Node pointer, always use tvm::make_node,
+ * or tvm::make_pooled_node for the nodes created in large numbers.
  *
  * \note In most cases, please inheritate tvm::Node.
- * \sa Node, NodePtr, make_node
+ * \sa Node, NodePtr, make_node, make_pooled_node
  */
 class NodeBase {
  public:
@@ -84,6 +85,8 @@ class NodeBase {
   friend class NodePtr;
   template<typename Y, typename... Args>
   friend NodePtr<Y> make_node(Args&&...);
+  template<typename Y, typename... Args>
+  friend NodePtr<Y> make_pooled_node(Args&&...);
 };
 
 /*!
@@ -235,6 +238,8 @@ class NodePtr {
   friend class NodePtr;
   template<typename Y, typename... Args>
   friend NodePtr<Y> make_node(Args&&...);
+  template<typename Y, typename... Args>
+  friend NodePtr<Y> make_pooled_node(Args&&...);
 };
 }  // namespace tvm
 
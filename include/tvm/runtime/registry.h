@@ -25,6 +25,7 @@
 #ifndef TVM_RUNTIME_REGISTRY_H_
 #define TVM_RUNTIME_REGISTRY_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include "packed_func.h"
@@ -80,6 +81,12 @@ class Registry {
   TVM_DLL static bool Remove(const std::string& name);
   /*!
    * \brief Get the global function by name.
+   *
+   *  The lookup does not take a lock. The returned pointer stays valid
+   *  for the lifetime of the program. Registering the name again, with
+   *  override or after Remove, sets the body in place, so the pointer
+   *  must not be called while the function is being registered again.
+   *
    * \param name The name of the function.
    * \return pointer to the registered function,
    *   nullptr if it does not exist.
@@ -99,6 +106,8 @@ class Registry {
   std::string name_;
   /*! \brief internal packed function */
   PackedFunc func_;
+  /*! \brief whether the function is removed */
+  std::atomic<bool> removed_{false};
   friend struct Manager;
 };
 
@@ -6,8 +6,10 @@
 #ifndef TVM_RUNTIME_THREADING_BACKEND_H_
 #define TVM_RUNTIME_THREADING_BACKEND_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace tvm {
@@ -77,6 +79,49 @@ void Yield();
  */
 int MaxConcurrency();
 
+/*!
+ * \brief Get the NUMA node to place the thread pool and memory of the
+ *  calling thread on.
+ *
+ *  Set by the TVM_NUMA_NODE environment variable, either to a node id,
+ *  or to "auto" to use the node the calling thread runs on, so that
+ *  the pools created by threads on different nodes are partitioned
+ *  per node.
+ *
+ * \return The node id, -1 if the placement is disabled or there is a single node.
+ */
+int NUMANode();
+
+/*!
+ * \brief Get the cpus of a NUMA node.
+ * \param node The node id.
+ * \return The cpus, empty if the node has no cpus or is unknown.
+ */
+std::vector<unsigned> NUMANodeCPUs(int node);
+
+/*!
+ * \brief Parse a cpu list of sysfs, such as "0-3,8,10-11".
+ * \param cpulist The cpu list.
+ * \return The cpus in the list.
+ */
+std::vector<unsigned> ParseCPUList(const std::string& cpulist);
+
+/*!
+ * \brief Get the granularity of the memory bound to the NUMA node.
+ * \return The page size, 0 when the placement is disabled or not supported.
+ */
+size_t NUMAPageSize();
+
+/*!
+ * \brief Prefer the NUMA node given by NUMANode for the pages of a memory range.
+ *  No-op when the placement is disabled or not supported by the system.
+ *  The range must be whole pages of its own allocation, aligned to and a
+ *  multiple of NUMAPageSize, so that no other object is moved.
+ * \param ptr The start of the memory range.
+ * \param nbytes The size of the memory range.
+ */
+void BindMemoryToNUMANode(void* ptr, size_t nbytes);
+
 
 }  // namespace threading
 }  // namespace runtime
@@ -112,12 +112,14 @@ def _make_tvm_args(args, temp_args):
         elif isinstance(arg, TVMContext):
             values[i].v_int64 = _ctx_to_int64(arg)
             type_codes[i] = TypeCode.TVM_CONTEXT
-        elif isinstance(arg, bytearray):
+        elif isinstance(arg, (bytearray, memoryview)):
+            # a writable memoryview is passed without copying its buffer.
+            nbytes = arg.nbytes if isinstance(arg, memoryview) else len(arg)
             arr = TVMByteArray()
             arr.data = ctypes.cast(
-                (ctypes.c_byte * len(arg)).from_buffer(arg),
+                (ctypes.c_byte * nbytes).from_buffer(arg),
                 ctypes.POINTER(ctypes.c_byte))
-            arr.size = len(arg)
+            arr.size = nbytes
             values[i].v_handle = ctypes.c_void_p(ctypes.addressof(arr))
             temp_args.append(arr)
             type_codes[i] = TypeCode.BYTES
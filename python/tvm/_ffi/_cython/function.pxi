@@ -116,12 +116,14 @@ cdef inline int make_arg(object arg,
         value[0].v_ctx = (<DLContext*>(
             <unsigned long long>ctypes.addressof(arg)))[0]
         tcode[0] = kTVMContext
-    elif isinstance(arg, bytearray):
+    elif isinstance(arg, (bytearray, memoryview)):
+        # a writable memoryview is passed without copying its buffer.
+        nbytes = arg.nbytes if isinstance(arg, memoryview) else len(arg)
         arr = TVMByteArray()
         arr.data = ctypes.cast(
-            (ctypes.c_byte * len(arg)).from_buffer(arg),
+            (ctypes.c_byte * nbytes).from_buffer(arg),
             ctypes.POINTER(ctypes.c_byte))
-        arr.size = len(arg)
+        arr.size = nbytes
         value[0].v_handle = <void*>(
             <unsigned long long>ctypes.addressof(arr))
         tcode[0] = kBytes
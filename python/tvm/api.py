@@ -151,6 +151,59 @@ def save_json(node):
     return _api_internal._save_json(node)
 
 
+def load_binary(blob):
+    """Load tvm object from the binary blob saved by save_binary.
+
+    Parameters
+    ----------
+    blob : bytearray or bytes
+        The binary blob
+
+    Returns
+    -------
+    node : Node
+        The loaded tvm node.
+    """
+    return _api_internal._load_binary(bytearray(blob))
+
+
+def save_binary(node):
+    """Save tvm object in binary format.
+
+    The binary format is faster to save and load than json and stores
+    the NDArrays raw, but can only be loaded by the same TVM version.
+
+    Parameters
+    ----------
+    node : Node
+        A TVM Node object to be saved.
+
+    Returns
+    -------
+    blob : bytearray
+        Saved binary blob.
+    """
+    return _api_internal._save_binary(node)
+
+
+def node_pool_stats():
+    """Get the allocation counters of the pooled node types.
+
+    Returns
+    -------
+    stats : dict of str to dict
+        The counters of each pooled type key: the number of allocated
+        nodes "alloc", freed nodes "free", live nodes "live", slabs
+        "slabs" and the bytes of the slabs "slab_bytes".
+    """
+    stats = {}
+    for key, value in _api_internal._node_pool_stats().items():
+        alloc, free, slabs, slab_bytes = [x.value for x in value]
+        stats[key] = {"alloc": alloc, "free": free, "live": alloc - free,
+                      "slabs": slabs, "slab_bytes": slab_bytes}
+    return stats
+
+
 def var(name="tindex", dtype=int32):
     """Create a new variable with specified name and dtype
 
@@ -127,7 +127,9 @@ class BuildConfig(NodeBase):
         "double_buffer_split_loop": 1,
         "dump_pass_ir": False,
         "instrument_bound_checkers": False,
-        "disable_select_rewriting": False
+        "disable_select_rewriting": False,
+        "incremental_lower": False,
+        "cpu_prefetch_distance": 0
     }
     _dump_ir = DumpIR()
 
@@ -233,6 +235,17 @@ def build_config(**kwargs):
 
     dump_pass_ir: dump ir of each pass into file idx_passname_ir.cc, default=False
 
+    incremental_lower: bool, default=False
+        Whether to memoize the local lowering passes on each loop nest.
+        Nests that are unchanged since a previous lowering, up to variable renaming,
+        reuse the cached result. This speeds up lowering many similar schedules
+        such as the candidates of autotuning.
+
+    cpu_prefetch_distance: int, default=0
+        The distance in bytes to prefetch the loads that advance by a constant
+        stride in the innermost loops, for CPU targets. If it is zero, no
+        prefetch is inserted.
+
     Returns
     -------
     config: BuildConfig
@@ -247,6 +260,47 @@ def build_config(**kwargs):
 
     return config
 
+def lower_pass_profile():
+    """Get the accumulated time of the lowering passes.
+
+    Returns
+    -------
+    profile : dict of str to tuple
+        Map from pass name to (number of calls, total seconds,
+        number of cached nests reused, number of nests lowered).
+    """
+    profile = _api_internal._GetLowerPassProfile()
+    return {k: (v[0].value, v[1].value, v[2].value, v[3].value)
+            for k, v in profile.items()}
+
+
+def reset_lower_pass_profile(clear_cache=False):
+    """Reset the lowering pass profile.
+
+    Parameters
+    ----------
+    clear_cache : bool, optional
+        Whether to also clear the cache of lowered loop nests.
+    """
+    _api_internal._ResetLowerPassProfile()
+    if clear_cache:
+        _api_internal._ClearLowerPassCache()
+
+
+def _run_pass(cfg, name, fpass, local=False):
+    """Wrap a pass so that it is timed in the lowering pass profile.
+    The local passes only depend on the content of each loop nest,
+    they are memoized when incremental lowering is enabled."""
+    return lambda stmt: _api_internal._RunLowerPass(
+        stmt, name, fpass, local, cfg.incremental_lower)
+
+
+def _time_phase(name, fphase):
+    """Run a lowering phase that is not a pass on a statement and time it
+    in the lowering pass profile."""
+    return _api_internal._TimeLowerPhase(name, fphase)
+
+
 def get_binds(args, binds=None):
     """Internal function to get binds and arg_list given arguments.
 
@@ -339,43 +393,56 @@ def lower(sch,
     if isinstance(sch, schedule.Schedule):
         # normalize schedule first
         sch = sch.normalize()
-        bounds = schedule.InferBound(sch)
-        stmt = schedule.ScheduleOps(sch, bounds)
-        stmt = ir_pass.InjectPrefetch(stmt)
+        bounds = _time_phase("InferBound", lambda: schedule.InferBound(sch))
+        stmt = _time_phase("ScheduleOps", lambda: schedule.ScheduleOps(sch, bounds))
+        stmt = _run_pass(cfg, "InjectPrefetch", ir_pass.InjectPrefetch)(stmt)
 
     for f in lower_phase0:
         stmt = f(stmt)
     # Phase 1
-    stmt = ir_pass.StorageFlatten(stmt, binds, 64, cfg.instrument_bound_checkers)
-    stmt = ir_pass.CanonicalSimplify(stmt)
+    stmt = _run_pass(
+        cfg, "StorageFlatten",
+        lambda x: ir_pass.StorageFlatten(x, binds, 64, cfg.instrument_bound_checkers))(stmt)
+    stmt = _run_pass(cfg, "CanonicalSimplify", ir_pass.CanonicalSimplify, True)(stmt)
     for f in lower_phase1:
         stmt = f(stmt)
     # Phase 2
     if not simple_mode:
-        stmt = ir_pass.LoopPartition(stmt, cfg.partition_const_loop)
-    stmt = ir_pass.VectorizeLoop(stmt)
-    stmt = ir_pass.InjectVirtualThread(stmt)
-    stmt = ir_pass.InjectDoubleBuffer(stmt, cfg.double_buffer_split_loop)
-    stmt = ir_pass.StorageRewrite(stmt)
-    stmt = ir_pass.UnrollLoop(
-        stmt,
-        cfg.auto_unroll_max_step,
-        cfg.auto_unroll_max_depth,
-        cfg.auto_unroll_max_extent,
-        cfg.unroll_explicit)
+        stmt = _run_pass(
+            cfg, "LoopPartition(%d)" % cfg.partition_const_loop,
+            lambda x: ir_pass.LoopPartition(x, cfg.partition_const_loop), True)(stmt)
+    stmt = _run_pass(cfg, "VectorizeLoop", ir_pass.VectorizeLoop, True)(stmt)
+    stmt = _run_pass(cfg, "InjectVirtualThread", ir_pass.InjectVirtualThread)(stmt)
+    stmt = _run_pass(
+        cfg, "InjectDoubleBuffer",
+        lambda x: ir_pass.InjectDoubleBuffer(x, cfg.double_buffer_split_loop))(stmt)
+    stmt = _run_pass(cfg, "StorageRewrite", ir_pass.StorageRewrite)(stmt)
+    unroll_args = (cfg.auto_unroll_max_step,
+                   cfg.auto_unroll_max_depth,
+                   cfg.auto_unroll_max_extent,
+                   cfg.unroll_explicit)
+    stmt = _run_pass(
+        cfg, "UnrollLoop(%d,%d,%d,%d)" % unroll_args,
+        lambda x: ir_pass.UnrollLoop(x, *unroll_args), True)(stmt)
+    if cfg.cpu_prefetch_distance > 0:
+        stmt = _run_pass(
+            cfg, "InjectCPUPrefetch(%d)" % cfg.cpu_prefetch_distance,
+            lambda x: ir_pass.InjectCPUPrefetch(x, cfg.cpu_prefetch_distance), True)(stmt)
     for f in lower_phase2:
         stmt = f(stmt)
     # Phase 3
-    stmt = ir_pass.Simplify(stmt)
-    stmt = ir_pass.LowerStorageAccessInfo(stmt)
-    stmt = ir_pass.RemoveNoOp(stmt)
+    stmt = _run_pass(cfg, "Simplify", ir_pass.Simplify, True)(stmt)
+    stmt = _run_pass(cfg, "LowerStorageAccessInfo", ir_pass.LowerStorageAccessInfo)(stmt)
+    stmt = _run_pass(cfg, "RemoveNoOp", ir_pass.RemoveNoOp, True)(stmt)
     if not cfg.disable_select_rewriting:
-        stmt = ir_pass.RewriteUnsafeSelect(stmt)
+        stmt = _run_pass(
+            cfg, "RewriteUnsafeSelect", ir_pass.RewriteUnsafeSelect, True)(stmt)
     for f in lower_phase3:
         stmt = f(stmt)
     # Instrument BoundCheckers
     if cfg.instrument_bound_checkers:
-        stmt = ir_pass.InstrumentBoundCheckers(stmt)
+        stmt = _run_pass(
+            cfg, "InstrumentBoundCheckers", ir_pass.InstrumentBoundCheckers)(stmt)
     if simple_mode:
         return stmt
     return ir_pass.MakeAPI(stmt, name, arg_list, 0, cfg.restricted_func)
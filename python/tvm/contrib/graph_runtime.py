@@ -213,10 +213,13 @@ class GraphModule(object):
 
         Parameters
         ----------
-        params_bytes : bytearray
-            The serialized parameter dict.
+        params_bytes : bytearray or memoryview
+            The serialized parameter dict. A bytearray or a writable
+            memoryview is read in place, other bytes are copied.
         """
-        self._load_params(bytearray(params_bytes))
+        if not isinstance(params_bytes, (bytearray, memoryview)):
+            params_bytes = bytearray(params_bytes)
+        self._load_params(params_bytes)
 
     def __getitem__(self, key):
         """Get internal module function
@@ -0,0 +1,273 @@
+"""Manage the residency of multiple graph runtime models in one process.
+
+Each graph runtime keeps its storage pool, which also holds the
+parameters, for as long as it lives. The model manager creates the
+graph runtimes on demand, keeps the recently used ones resident under a
+memory budget, and releases the least recently used ones when the
+budget is exceeded. A released model is created again and its
+parameters reloaded the next time it is requested.
+"""
+from __future__ import absolute_import as _abs
+
+import json
+import mmap
+import time
+from collections import OrderedDict
+
+from .._ffi.base import string_types
+from .._ffi.runtime_ctypes import TVMType
+from . import graph_runtime
+
+
+def graph_memory_bytes(graph_json_str):
+    """Get the bytes of the storage pool of a graph.
+
+    This follows the storage planning of the graph runtime, where the
+    parameters and the activations share the same pool.
+
+    Parameters
+    ----------
+    graph_json_str : str
+        The graph in json format.
+
+    Returns
+    -------
+    nbytes : int
+        The total bytes allocated by the graph runtime on all devices.
+    """
+    attrs = json.loads(graph_json_str)["attrs"]
+    shapes = attrs["shape"][1]
+    dltypes = attrs["dltype"][1]
+    storage_ids = attrs["storage_id"][1]
+    pool = {}
+    for shape, dltype, sid in zip(shapes, dltypes, storage_ids):
+        size = 1
+        for dim in shape:
+            size *= dim
+        dtype = TVMType(dltype)
+        nbytes = (dtype.bits * dtype.lanes + 7) // 8 * size
+        pool[sid] = max(pool.get(sid, 0), nbytes)
+    return sum(pool.values())
+
+
+class ModelStats(object):
+    """Residency and latency statistics of a model.
+
+    Attributes
+    ----------
+    hits : int
+        The number of requests served by the resident model.
+
+    loads : int
+        The number of times the model was created and its parameters loaded.
+
+    evictions : int
+        The number of times the model was released.
+
+    last_load_ms : float
+        The latency of the last load in milliseconds.
+
+    total_load_ms : float
+        The total latency of the loads in milliseconds.
+    """
+    def __init__(self):
+        self.hits = 0
+        self.loads = 0
+        self.evictions = 0
+        self.last_load_ms = 0.0
+        self.total_load_ms = 0.0
+
+    def __repr__(self):
+        return ("ModelStats(hits=%d, loads=%d, evictions=%d, "
+                "last_load_ms=%.3f, total_load_ms=%.3f)" % (
+                    self.hits, self.loads, self.evictions,
+                    self.last_load_ms, self.total_load_ms))
+
+
+class _ModelEntry(object):
+    """The information to create a model and its resident graph module."""
+    def __init__(self, graph_json_str, libmod, ctx, params):
+        self.graph_json_str = graph_json_str
+        self.libmod = libmod
+        self.ctx = ctx
+        self.params = params
+        self.nbytes = graph_memory_bytes(graph_json_str)
+        self.module = None
+        self.stats = ModelStats()
+
+
+class ModelManager(object):
+    """Keep the recently used models resident under a memory budget.
+
+    Parameters
+    ----------
+    budget_bytes : int, optional
+        The maximum bytes of the storage pools of the resident models.
+        None means no limit.
+
+    Note
+    ----
+    The manager only drops its own reference to a released model, a
+    graph module still held by the caller stays alive until it is
+    released by the caller too.
+    """
+    def __init__(self, budget_bytes=None):
+        self.budget_bytes = budget_bytes
+        # resident models are moved to the end when used.
+        self._entries = OrderedDict()
+        self._resident_bytes = 0
+
+    def add(self, name, graph_json_str, libmod, ctx, params=None):
+        """Register a model, it is created the first time it is requested.
+
+        Parameters
+        ----------
+        name : str
+            The name of the model.
+
+        graph_json_str : str
+            The graph in json format.
+
+        libmod : tvm.Module
+            The module of the compiled functions.
+
+        ctx : TVMContext or list of TVMContext
+            The context to run the model.
+
+        params : dict of str to NDArray, bytearray or str, optional
+            The parameters, either as a dict, the serialized parameter
+            dict, or the path of the file of the serialized parameter
+            dict. When a path is given, the file is mapped and loaded
+            again each time the model is created, so a released model
+            does not hold the parameters in memory.
+        """
+        if name in self._entries:
+            raise ValueError("Model %s is already added" % name)
+        self._entries[name] = _ModelEntry(graph_json_str, libmod, ctx, params)
+
+    def remove(self, name):
+        """Release the model and remove it from the manager.
+
+        Parameters
+        ----------
+        name : str
+            The name of the model.
+        """
+        self.evict(name)
+        del self._entries[name]
+
+    def get(self, name):
+        """Get the graph module of the model, create it if it is not resident.
+
+        Other least recently used models are released if the budget
+        is exceeded.
+
+        Parameters
+        ----------
+        name : str
+            The name of the model.
+
+        Returns
+        -------
+        graph_module : GraphModule
+            The resident graph module.
+        """
+        entry = self._entries.pop(name)
+        self._entries[name] = entry
+        if entry.module is not None:
+            entry.stats.hits += 1
+            return entry.module
+        self._reserve(entry.nbytes, name)
+        tic = time.time()
+        module = graph_runtime.create(entry.graph_json_str, entry.libmod, entry.ctx)
+        self._load_params(module, entry.params)
+        cost = (time.time() - tic) * 1000.0
+        entry.module = module
+        entry.stats.loads += 1
+        entry.stats.last_load_ms = cost
+        entry.stats.total_load_ms += cost
+        self._resident_bytes += entry.nbytes
+        return module
+
+    def evict(self, name):
+        """Release the graph module of the model if it is resident.
+
+        Parameters
+        ----------
+        name : str
+            The name of the model.
+        """
+        entry = self._entries[name]
+        if entry.module is None:
+            return
+        entry.module = None
+        entry.stats.evictions += 1
+        self._resident_bytes -= entry.nbytes
+
+    def is_resident(self, name):
+        """Whether the model is resident."""
+        return self._entries[name].module is not None
+
+    def memory_bytes(self, name=None):
+        """Get the bytes of the storage pool of a model.
+
+        Parameters
+        ----------
+        name : str, optional
+            The name of the model, default to the total of the resident models.
+
+        Returns
+        -------
+        nbytes : int
+            The bytes of the model, or of all the resident models.
+        """
+        if name is None:
+            return self._resident_bytes
+        return self._entries[name].nbytes
+
+    def stats(self, name):
+        """Get the residency and latency statistics of the model.
+
+        Parameters
+        ----------
+        name : str
+            The name of the model.
+
+        Returns
+        -------
+        stats : ModelStats
+            The statistics.
+        """
+        return self._entries[name].stats
+
+    def _reserve(self, nbytes, keep):
+        """Release the least recently used models until nbytes fit in the budget."""
+        if self.budget_bytes is None:
+            return
+        for name, entry in list(self._entries.items()):
+            if self._resident_bytes + nbytes <= self.budget_bytes:
+                break
+            if name != keep and entry.module is not None:
+                self.evict(name)
+
+    @staticmethod
+    def _load_params(module, params):
+        if params is None:
+            return
+        if isinstance(params, dict):
+            module.set_input(**params)
+        elif isinstance(params, string_types):
+            # a private mapping is writable for the FFI without copying
+            # the file, the parameters are read from the mapped pages.
+            with open(params, "rb") as f:
+                blob = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+                try:
+                    view = memoryview(blob)
+                    try:
+                        module.load_params(view)
+                    finally:
+                        view.release()
+                finally:
+                    blob.close()
+        else:
+            module.load_params(params)
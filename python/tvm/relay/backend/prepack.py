@@ -0,0 +1,239 @@
+"""
+Prepacking of the weight transformations of a Relay function.
+
+The layout passes rewrite the weights of operators such as conv2d and dense
+into the layout their schedules expect (NCHWc, blocked dense, the winograd
+transformation). Unless the weights are bound as constants, these transforms
+run on every inference, and even when they are bound, the transformed weights
+are only computed at compile time and can't be persisted.
+
+The prepacking moves every expression that only depends on the weights into
+a separate function. The main function takes the results as parameters named
+``"{weight}@{target}"``, so the packed weights of several targets can be
+stored next to the raw ones in a single parameter dict.
+"""
+from __future__ import absolute_import
+import json
+
+from .. import ir_pass
+from ..expr import Var, Constant, Call, Tuple, TupleGetItem, Function
+from ..expr_functor import ExprMutator
+from ..op import Op
+from ..ty import TensorType
+from ... import nd as _nd
+from ...contrib import graph_runtime as _graph_rt
+
+
+class _WeightExtractor(ExprMutator):
+    """Replace the maximal weight-only tensor expressions by new variables."""
+
+    def __init__(self, weights, target):
+        super(_WeightExtractor, self).__init__()
+        self.weights = weights
+        self.target = target
+        self.packed = []
+        self._kind = {}
+        self._names = set()
+
+    def kind(self, expr):
+        """Get whether expr is "weight" (depends on a weight and constants
+        only), "const", or "other"."""
+        if expr in self._kind:
+            return self._kind[expr]
+        if isinstance(expr, Var):
+            ret = "weight" if expr in self.weights else "other"
+        elif isinstance(expr, Constant):
+            ret = "const"
+        elif isinstance(expr, (Call, Tuple)):
+            if isinstance(expr, Call) and not isinstance(expr.op, Op):
+                ret = "other"
+            else:
+                fields = expr.args if isinstance(expr, Call) else expr.fields
+                kinds = [self.kind(x) for x in fields]
+                if "other" in kinds:
+                    ret = "other"
+                elif "weight" in kinds:
+                    ret = "weight"
+                else:
+                    ret = "const"
+        elif isinstance(expr, TupleGetItem):
+            ret = self.kind(expr.tuple_value)
+        else:
+            ret = "other"
+        self._kind[expr] = ret
+        return ret
+
+    def _weight_name(self, expr):
+        name = None
+        for var in ir_pass.free_vars(expr):
+            name = var.name_hint
+            break
+        name = "%s@%s" % (name, self.target)
+        if name in self._names:
+            index = 1
+            while "%s.%d" % (name, index) in self._names:
+                index += 1
+            name = "%s.%d" % (name, index)
+        self._names.add(name)
+        return name
+
+    def visit(self, expr):
+        if (not isinstance(expr, Var) and
+                self.kind(expr) == "weight" and
+                isinstance(expr.checked_type, TensorType)):
+            found = self.memo_map.get(expr)
+            if found is None:
+                found = Var(self._weight_name(expr), expr.checked_type)
+                self.packed.append((found, expr))
+                self.memo_map[expr] = found
+            return found
+        return super(_WeightExtractor, self).visit(expr)
+
+
+def extract_weight_transforms(func, weight_names, target):
+    """Split the transformations of the weights out of a function.
+
+    Parameters
+    ----------
+    func : tvm.relay.Function
+        The type checked function.
+
+    weight_names : list of str
+        The names of the parameters that are weights.
+
+    target : tvm.target.Target
+        The target the function is optimized for.
+
+    Returns
+    -------
+    main_func : tvm.relay.Function
+        The function taking the transformed weights as parameters.
+
+    prepack_func : tvm.relay.Function or None
+        The function computing the transformed weights as a tuple, in the
+        order of packed_names, or None if no weight is transformed.
+
+    packed_names : list of str
+        The names of the transformed weights.
+    """
+    weights = set(x for x in func.params if x.name_hint in weight_names)
+    extractor = _WeightExtractor(weights, target)
+    body = extractor.visit(func.body)
+    if not extractor.packed:
+        return func, None, []
+    packed_vars = [var for var, _ in extractor.packed]
+    used = set(ir_pass.free_vars(body))
+    params = [x for x in func.params if x in used] + packed_vars
+    main_func = Function(params, body, func.ret_type, func.type_params, func.attrs)
+    fields = Tuple([expr for _, expr in extractor.packed])
+    prepack_func = Function(ir_pass.free_vars(fields), fields)
+    return main_func, prepack_func, [x.name_hint for x in packed_vars]
+
+
+class WeightPrepacker(object):
+    """Compute the transformed weights of a function built by
+    :py:func:`tvm.relay.build_prepacked`.
+
+    Parameters
+    ----------
+    target : tvm.target.Target
+        The target the weights are packed for.
+
+    input_names : list of str
+        The names of the inputs of the main graph.
+
+    packed_names : list of str
+        The names of the transformed weights.
+
+    graph_json : str or None
+        The graph of the weight transformations.
+
+    mod : tvm.Module or None
+        The module of the weight transformations.
+
+    params : dict of str to NDArray
+        The constant parameters of the weight transformations.
+    """
+    def __init__(self, target, input_names, packed_names,
+                 graph_json=None, mod=None, params=None):
+        self.target = target
+        self.input_names = set(input_names)
+        self.packed_names = packed_names
+        self.graph_json = graph_json
+        self.mod = mod
+        self.params = params if params else {}
+        self.weight_names = []
+        if graph_json is not None:
+            graph = json.loads(graph_json)
+            for nid in graph["arg_nodes"]:
+                name = graph["nodes"][nid]["name"]
+                if name not in self.params:
+                    self.weight_names.append(name)
+        # the raw weights of the last transformation and their packed weights.
+        self._cache_key = None
+        self._cache = None
+
+    def prepack(self, params, ctx=None):
+        """Transform the weights.
+
+        Parameters
+        ----------
+        params : dict of str to NDArray or numpy.ndarray
+            The raw weights.
+
+        ctx : TVMContext, optional
+            The context to transform the weights on.
+
+        Returns
+        -------
+        packed : dict of str to NDArray
+            The transformed weights, to be stored with the raw ones.
+        """
+        if not self.packed_names:
+            return {}
+        ctx = ctx if ctx else _nd.context(str(self.target), 0)
+        module = _graph_rt.create(self.graph_json, self.mod, ctx)
+        module.set_input(**self.params)
+        for name in self.weight_names:
+            if name not in params:
+                raise ValueError("weight %s is required to prepack %s" %
+                                 (name, self.packed_names))
+            module.set_input(name, params[name])
+        module.run()
+        packed = {}
+        for i, name in enumerate(self.packed_names):
+            packed[name] = module.get_output(i).copyto(_nd.cpu(0))
+        return packed
+
+    def load_params(self, module, params, ctx=None):
+        """Set the parameters of a graph module built for the target.
+
+        The transformed weights are taken from params when they were
+        prepacked, otherwise they are computed from the raw weights. The
+        result is reused while the same raw weight arrays are loaded again.
+        The parameters that are not inputs of the graph, such as the weights
+        packed for other targets, are skipped.
+
+        Parameters
+        ----------
+        module : tvm.contrib.graph_runtime.GraphModule
+            The graph module of the main function.
+
+        params : dict of str to NDArray or numpy.ndarray
+            The raw and the transformed weights.
+
+        ctx : TVMContext, optional
+            The context to transform the weights on.
+        """
+        inputs = {k: v for k, v in params.items() if k in self.input_names}
+        missing = [x for x in self.packed_names if x not in params]
+        if missing:
+            # the arrays are kept with the cache, so their ids are not reused.
+            key = tuple(params.get(name) for name in self.weight_names)
+            if (self._cache_key is None or
+                    any(a is not b for a, b in zip(key, self._cache_key))):
+                self._cache = self.prepack(params, ctx)
+                self._cache_key = key
+            for name in missing:
+                inputs[name] = self._cache[name]
+        module.set_input(**inputs)
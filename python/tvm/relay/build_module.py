@@ -12,13 +12,17 @@ from . import ir_pass
 from . import expr
 from .backend import interpreter as _interpreter
 from .backend import graph_runtime_codegen as _graph_gen
+from .backend import prepack as _prepack
 
 # List of optimization pass and level when switch on
 OPT_PASS_LEVEL = {
     "SimplifyInference": 0,
     "OpFusion": 1,
     "FoldConstant": 2,
+    "EliminateCommonSubexpr": 2,
     "CombineParallelConv2D": 3,
+    "CombineParallelDense": 3,
+    "CombineParallelBatchMatmul": 3,
     "FoldScaleAxis": 3,
     "AlterOpLayout": 3,
 }
@@ -161,10 +165,22 @@ def optimize(func, target, params=None):
         func = ir_pass.infer_type(func)
         func = ir_pass.simplify_inference(func)
 
+    if cfg.pass_enabled("EliminateCommonSubexpr"):
+        func = ir_pass.infer_type(func)
+        func = ir_pass.eliminate_common_subexpr(func)
+
     if cfg.pass_enabled("CombineParallelConv2D"):
         func = ir_pass.infer_type(func)
         func = ir_pass.combine_parallel_conv2d(func)
 
+    if cfg.pass_enabled("CombineParallelDense"):
+        func = ir_pass.infer_type(func)
+        func = ir_pass.combine_parallel_dense(func)
+
+    if cfg.pass_enabled("CombineParallelBatchMatmul"):
+        func = ir_pass.infer_type(func)
+        func = ir_pass.combine_parallel_batch_matmul(func)
+
     # The constant folding pass is necessary because FoldScaleAxis pass needs
     # to check the constantness and positiveness of scales.
     if cfg.pass_enabled("FoldConstant"):
@@ -246,19 +262,9 @@ def build(func, target=None, target_host=None, params=None):
         raise ValueError("target must be the type of str, tvm.target.Target," +
                          "or dict of device name to target")
 
-    # If current dispatch context is fallback context (the default root context),
-    # then load pre-tuned parameters from TopHub
-    if isinstance(autotvm.DispatchContext.current, autotvm.FallbackContext):
-        if isinstance(target, dict):
-            tophub_context = autotvm.tophub.context(list(target.values()))
-        else:
-            tophub_context = autotvm.tophub.context(target)
-    else:
-        tophub_context = autotvm.util.EmptyContext()
-
     cfg = BuildConfig.current
 
-    with tophub_context:
+    with _tophub_context(target):
         func = optimize(func, target, params)
         # Annotate the ops for heterogeneous execution.
         if isinstance(target, dict):
@@ -276,6 +282,94 @@ def build(func, target=None, target_host=None, params=None):
     return graph_json, mod, params
 
 
+def build_prepacked(func, target=None, target_host=None, params=None):
+    """Build a function to run on TVM graph runtime, with the transformations
+    of its weights split into a separate graph.
+
+    The weights are not bound as constants. Instead, each expression that only
+    depends on the weights, such as the layout transformations inserted by
+    AlterOpLayout, becomes a parameter named ``"{weight}@{target}"``. These
+    are computed once by the returned prepacker, and can be stored along with
+    the raw weights so that neither the startup nor the inference transforms
+    them again.
+
+    Parameters
+    ----------
+    func: relay.Function
+        The function to build.
+
+    target : str or :any:`tvm.target.Target`, optional
+        The build target. Heterogeneous compilation is not supported.
+
+    target_host : str or :any:`tvm.target.Target`, optional
+        Host compilation target, if target is device.
+
+    params : dict of str to NDArray
+        The weights of the function.
+
+    Returns
+    -------
+    graph_json : str
+        The json string that can be accepted by graph runtime.
+
+    mod : tvm.Module
+        The module containing necessary libraries.
+
+    params : dict
+        The parameters of the final graph, without the transformed weights.
+
+    prepacker : :py:class:`~tvm.relay.backend.prepack.WeightPrepacker`
+        The prepacker that computes and loads the transformed weights.
+    """
+    target = target if target else _target.current_target()
+    if target is None:
+        raise ValueError("Target is not set in env or passed as argument.")
+    if not isinstance(target, (str, _target.Target)):
+        raise ValueError("weight prepacking only supports homogeneous compilation")
+    target = _target.create(target)
+    params = params if params else {}
+    cfg = BuildConfig.current
+
+    with _tophub_context(target):
+        func = optimize(func, target)
+        func = ir_pass.infer_type(func)
+        func, prepack_func, packed_names = _prepack.extract_weight_transforms(
+            func, set(params.keys()), target)
+        func = ir_pass.infer_type(func)
+        func = ir_pass.fuse_ops(func, cfg.opt_level)
+        func = ir_pass.infer_type(func)
+        graph_gen = _graph_gen.GraphRuntimeCodegen(mod=None, target=target)
+        graph_json, lowered_funcs, consts = graph_gen.codegen(func)
+        mod = _tvm_build_module(
+            lowered_funcs, target=target, target_host=target_host)
+
+    input_names = [x.name_hint for x in func.params] + list(consts.keys())
+    out_params = dict(consts)
+    for name in input_names:
+        if name in params:
+            out_params[name] = params[name]
+    if prepack_func is None:
+        prepacker = _prepack.WeightPrepacker(target, input_names, packed_names)
+    else:
+        prepack_graph, prepack_mod, prepack_params = build(
+            prepack_func, target, target_host)
+        prepacker = _prepack.WeightPrepacker(
+            target, input_names, packed_names,
+            prepack_graph, prepack_mod, prepack_params)
+    return graph_json, mod, out_params, prepacker
+
+
+def _tophub_context(target):
+    """Get the context loading the pre-tuned parameters from TopHub, if the
+    current dispatch context is the fallback context (the default root context).
+    """
+    if isinstance(autotvm.DispatchContext.current, autotvm.FallbackContext):
+        if isinstance(target, dict):
+            return autotvm.tophub.context(list(target.values()))
+        return autotvm.tophub.context(target)
+    return autotvm.util.EmptyContext()
+
+
 def _update_heterogeneous_inputs(target):
     """Update the target and fallback device required for heterogeneous
     compilation. CPU is used as the fallback device if it wasn't provided.
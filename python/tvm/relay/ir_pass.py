@@ -388,7 +388,24 @@ def fuse_ops(expr, opt_level=1):
     return _ir_pass.FuseOps(expr, opt_level)
 
 
-def combine_parallel_conv2d(expr):
+def eliminate_common_subexpr(expr):
+    """Eliminate common subexpressions: a call with the same op,
+    arguments and attributes as a previous call is replaced by it.
+
+    Parameters
+    ----------
+    expr : tvm.relay.Expr
+        The input expression.
+
+    Returns
+    -------
+    transformed_expr : tvm.relay.Expr
+        Transformed expression
+    """
+    return _ir_pass.eliminate_common_subexpr(expr)
+
+
+def combine_parallel_conv2d(expr, min_num_branches=2):
     """Fold multiple conv2d into one.
 
     Parameters
@@ -396,12 +413,84 @@ def combine_parallel_conv2d(expr):
     expr : tvm.relay.Expr
         The input expression.
 
+    min_num_branches : int
+        The minimum number of parallel branches when the transformation should be applied.
+
+    Returns
+    -------
+    transformed_expr : tvm.relay.Expr
+        Transformed expression
+    """
+    return _ir_pass.CombineParallelConv2D(expr, min_num_branches)
+
+
+def combine_parallel_dense(expr, min_num_branches=3):
+    """Fold multiple dense sharing the same input into one,
+    by concatenating their weights along the units.
+
+    Parameters
+    ----------
+    expr : tvm.relay.Expr
+        The input expression.
+
+    min_num_branches : int
+        The minimum number of parallel branches when the transformation should be applied.
+
+    Returns
+    -------
+    transformed_expr : tvm.relay.Expr
+        Transformed expression
+    """
+    return _ir_pass.CombineParallelDense(expr, min_num_branches)
+
+
+def combine_parallel_batch_matmul(expr, min_num_branches=3):
+    """Fold multiple batch_matmul sharing the same first input into one,
+    by concatenating their second inputs along the N axis.
+
+    Parameters
+    ----------
+    expr : tvm.relay.Expr
+        The input expression.
+
+    min_num_branches : int
+        The minimum number of parallel branches when the transformation should be applied.
+
+    Returns
+    -------
+    transformed_expr : tvm.relay.Expr
+        Transformed expression
+    """
+    return _ir_pass.CombineParallelBatchMatmul(expr, min_num_branches)
+
+
+def combine_parallel_op_batch(expr, op_name, min_num_branches=3):
+    """Fold multiple element-wise or broadcast ops sharing the same first
+    input into one, by stacking their other inputs on a new leading axis.
+    Ops with attributes, such as the axis of bias_add, are not combined.
+
+    This pass is not part of :any:`tvm.relay.build`: it combines a single op
+    given by name, and stacking the inputs of cheap element-wise ops costs a
+    concatenate that can outweigh the saved kernels, so it is only applied
+    explicitly to the graphs where it pays off.
+
+    Parameters
+    ----------
+    expr : tvm.relay.Expr
+        The input expression.
+
+    op_name : str
+        The name of the op that starts the parallel branches, e.g. "add".
+
+    min_num_branches : int
+        The minimum number of parallel branches when the transformation should be applied.
+
     Returns
     -------
     transformed_expr : tvm.relay.Expr
         Transformed expression
     """
-    return _ir_pass.CombineParallelConv2D(expr)
+    return _ir_pass.CombineParallelOpBatch(expr, op_name, min_num_branches)
 
 
 def alter_op_layout(expr):
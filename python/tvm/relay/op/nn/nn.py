@@ -485,6 +485,31 @@ def dense(data, weight, units=None):
     return _make.dense(data, weight, units)
 
 
+def batch_matmul(x, y):
+    r"""
+    Computes matrix multiplication of `x` and `y` when `x` and `y` are data
+    in batch.
+
+    .. math::
+
+        \mbox{batch_matmul}(x, y)[i, :, :] = \mbox{matmul}(x[i, :, :], y[i, :, :]^T)
+
+    Parameters
+    ----------
+    x : tvm.relay.Expr
+        The first input, 3-D with shape (batch, M, K).
+
+    y : tvm.relay.Expr
+        The second input, 3-D with shape (batch, N, K).
+
+    Returns
+    -------
+    result: tvm.relay.Expr
+        The computed result, 3-D with shape (batch, M, N).
+    """
+    return _make.batch_matmul(x, y)
+
+
 def relu(data):
     """Rectified linear unit.
 
@@ -0,0 +1,279 @@
+#pylint: disable=unused-argument
+"""Automatic quantization toolkit."""
+from __future__ import absolute_import
+import math
+import numpy as np
+
+from . import _quantize
+from .. import expr as _expr
+from .. import ir_pass as _ir_pass
+from ..build_module import _bind_params_by_name, create_executor
+from ..op import op as _op
+from ... import make as _make
+
+
+class QAnnotateKind(object):
+    """Denote the kind of annotation field, corresponding
+    to different nbit configure."""
+    INPUT = 1
+    WEIGHT = 2
+    ACTIVATION = 3
+
+
+class QConfig(object):
+    """Configuration scope of the quantization passes.
+
+    Parameters
+    ----------
+    kwargs
+        Keyword arguments of configurations to set.
+    """
+    current = None
+    defaults = {
+        "nbit_input": 8,
+        "nbit_weight": 8,
+        "nbit_activation": 32,
+        "dtype_input": "int8",
+        "dtype_weight": "int8",
+        "dtype_activation": "int32",
+        "global_scale": 8.0,
+        "skip_k_conv": 1,
+        "round_for_shift": True,
+    }
+
+    def __init__(self, **kwargs):
+        self._old_scope = None
+        for k, _ in kwargs.items():
+            if k not in QConfig.defaults:
+                raise ValueError("invalid argument %s, candidates are %s" %
+                                 (k, QConfig.defaults.keys()))
+        self._attr = kwargs
+
+    def __getattr__(self, name):
+        if name not in self._attr:
+            return QConfig.defaults[name]
+        return self._attr[name]
+
+    def __enter__(self):
+        # pylint: disable=protected-access
+        self._old_scope = QConfig.current
+        attr = QConfig.current._attr.copy()
+        attr.update(self._attr)
+        self._attr = attr
+        QConfig.current = self
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        assert self._old_scope
+        QConfig.current = self._old_scope
+
+    def get_nbit_by_kind(self, kind):
+        """Get the number of bits of an annotation kind."""
+        name = {QAnnotateKind.INPUT: "nbit_input",
+                QAnnotateKind.WEIGHT: "nbit_weight",
+                QAnnotateKind.ACTIVATION: "nbit_activation"}[kind]
+        return getattr(self, name)
+
+    def node(self):
+        """Get the configuration node passed to the passes."""
+        attr = QConfig.defaults.copy()
+        attr.update(self._attr)
+        return _make.node("relay.quantize.QConfig", **attr)
+
+
+QConfig.current = QConfig()
+
+
+def qconfig(**kwargs):
+    """Configure the quantization behavior by setting config variables.
+
+    Parameters
+    ---------
+    nbit_input: int, default=8
+        Number of bits of the quantized inputs of conv2d and dense.
+
+    nbit_weight: int, default=8
+        Number of bits of the quantized weights.
+
+    nbit_activation: int, default=32
+        Number of bits of the accumulated activations.
+
+    dtype_input: str, default="int8"
+        Data type of the quantized inputs.
+
+    dtype_weight: str, default="int8"
+        Data type of the quantized weights.
+
+    dtype_activation: str, default="int32"
+        Data type of the accumulated activations.
+
+    global_scale: float, default=8.0
+        The range of the activations when no dataset is given to calibrate.
+
+    skip_k_conv: int, default=1
+        The number of leading conv2d kept in float.
+
+    round_for_shift: bool, default=True
+        Whether to add a rounding bias before the right shifts.
+
+    Returns
+    -------
+    config: QConfig
+        The quantization configuration
+    """
+    return QConfig(**kwargs)
+
+
+def current_qconfig():
+    """Get the current quantization configuration."""
+    return QConfig.current
+
+
+def annotate(graph):
+    """Insert simulated_quantize before the inputs and weights of
+    conv2d/dense and the elementwise operators between them.
+
+    Parameters
+    ---------
+    graph: Function
+        The original graph, with the weights bound as constants.
+
+    Returns
+    -------
+    ret: Function
+        The graph after annotation. The scale and the clip range of
+        each simulated_quantize are free variables.
+    """
+    return _quantize.annotate(graph, current_qconfig().node())
+
+
+def _power2_scale(arr):
+    """Smallest power of two larger than the absolute values of arr."""
+    val = np.amax(np.abs(arr))
+    return 2**math.ceil(math.log(val, 2)) if val > 0 else 1.0
+
+
+def calibrate(graph, dataset=None):
+    """Bind the scale and the clip range of each simulated_quantize.
+
+    The scale of a weight is the power of two covering its values.
+    The scale of the other fields is the power of two covering their
+    values on the dataset, or global_scale if no dataset is given.
+
+    Parameters
+    ---------
+    graph: Function
+        The annotated graph.
+
+    dataset: list of dict of str to NDArray, optional
+        The inputs of the graph used to collect the activation ranges.
+
+    Returns
+    -------
+    ret: Function
+        The graph with the scales bound as constants.
+    """
+    cfg = current_qconfig()
+    quantize_op = _op.get("relay.op.annotation.simulated_quantize")
+    calls = []
+
+    def _collect(expr):
+        if isinstance(expr, _expr.Call) and expr.op == quantize_op:
+            calls.append(expr)
+    _ir_pass.post_order_visit(graph, _collect)
+
+    def _bind_scales(expr, scales):
+        const_params = {}
+        for call, scale in zip(calls, scales):
+            valid_range = 2**(cfg.get_nbit_by_kind(call.attrs.kind) - call.attrs.sign)
+            _, ndom_scale, nclip_min, nclip_max = call.args
+            const_params[ndom_scale] = _expr.const(scale / valid_range, "float32")
+            const_params[nclip_min] = _expr.const(-(valid_range - 1), "float32")
+            const_params[nclip_max] = _expr.const(valid_range - 1, "float32")
+        return _expr.bind(expr, const_params)
+
+    scales = []
+    for call in calls:
+        if call.attrs.kind == QAnnotateKind.WEIGHT:
+            data = call.args[0]
+            assert isinstance(data, _expr.Constant), \
+                "weights must be bound as constants before calibration"
+            scales.append(_power2_scale(data.data.asnumpy()))
+        else:
+            scales.append(cfg.global_scale)
+
+    fields = [i for i, call in enumerate(calls)
+              if call.attrs.kind != QAnnotateKind.WEIGHT]
+    if dataset and fields:
+        profile = _expr.Function(graph.params,
+                                 _expr.Tuple([calls[i].args[0] for i in fields]))
+        profile = _bind_scales(profile, scales)
+        func = create_executor("debug").evaluate(profile)
+        amax = [0.0] * len(fields)
+        for inputs in dataset:
+            outputs = func(**inputs)
+            for k, out in enumerate(outputs):
+                amax[k] = max(amax[k], np.amax(np.abs(out.asnumpy())))
+        for k, i in enumerate(fields):
+            scales[i] = _power2_scale(amax[k])
+
+    return _bind_scales(graph, scales)
+
+
+def realize(graph):
+    """Realize the calibrated simulated_quantize into integer operators:
+    conv2d/dense on int8 operands with int32 accumulation, followed by
+    requantization with shift, clip and cast.
+
+    Parameters
+    ---------
+    graph: Function
+        The calibrated graph.
+
+    Returns
+    -------
+    ret: Function
+        The realized graph.
+    """
+    return _quantize.realize(graph, current_qconfig().node())
+
+
+def quantize(graph, params=None, dataset=None):
+    """ The quantization procedure. Before running the three main
+    procedure of quantization, "annotate", "calibrate" and "realize",
+    we need to do "SimplifyInference", "FoldScaleAxis" and "FoldConstant"
+    first for optimizing.
+
+    Parameters
+    ---------
+    graph: Function
+        The original graph.
+
+    params : dict of str to NDArray
+        Input parameters to the graph that do not change
+        during inference time. Used for constant folding.
+
+    dataset: list of dict of str to NDArray, optional
+        The inputs used to calibrate the activation ranges.
+
+    Returns
+    -------
+    ret: Function
+        The graph after quantization
+    """
+    if params:
+        graph = _bind_params_by_name(graph, params)
+    graph = _ir_pass.infer_type(graph)
+    graph = _ir_pass.simplify_inference(graph)
+    graph = _ir_pass.fold_constant(graph)
+    graph = _ir_pass.infer_type(graph)
+    graph = _ir_pass.backward_fold_scale_axis(graph)
+    graph = _ir_pass.infer_type(graph)
+    graph = _ir_pass.forward_fold_scale_axis(graph)
+    graph = _ir_pass.fold_constant(graph)
+
+    graph = annotate(graph)
+    graph = calibrate(graph, dataset)
+    graph = realize(graph)
+    graph = _ir_pass.fold_constant(graph)
+    return graph
@@ -40,6 +40,45 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def get_async_function(self, name, module=None):
+        """Get a function that calls the remote without waiting for the return.
+
+        Calling the result function sends the request and returns its id
+        immediately, so several calls can be in flight at the same time.
+        The remote handles them in order. Each id must be passed to
+        :any:`wait` to get the return value.
+
+        Parameters
+        ----------
+        name : str
+            The name of the function
+
+        module : Module, optional
+            The remote module that contains the function,
+            default to the global functions of the session.
+
+        Returns
+        -------
+        f : Function
+            The result function.
+        """
+        return base._GetAsyncFunction(module or self._sess, name)
+
+    def wait(self, request_id):
+        """Wait for the return of an asynchronous call.
+
+        Parameters
+        ----------
+        request_id : int
+            The id returned by the function of :any:`get_async_function`.
+
+        Returns
+        -------
+        ret : object
+            The return value of the call.
+        """
+        return base._WaitAsync(self._sess, request_id)
+
     def context(self, dev_type, dev_id=0):
         """Construct a remote context.
 
@@ -7,6 +7,7 @@
 #include <tvm/expr.h>
 #include <tvm/tensor.h>
 #include <tvm/api_registry.h>
+#include <tvm/node_pool.h>
 
 namespace tvm {
 TVM_REGISTER_API("_format_str")
@@ -30,6 +31,34 @@ TVM_REGISTER_API("_save_json")
 TVM_REGISTER_API("_load_json")
 .set_body_typed<NodeRef(std::string)>(LoadJSON<NodeRef>);
 
+TVM_REGISTER_API("_save_binary")
+.set_body([](TVMArgs args,  TVMRetValue *ret) {
+    std::string blob = SaveBinary(args[0]);
+    TVMByteArray arr;
+    arr.data = blob.c_str();
+    arr.size = blob.length();
+    *ret = arr;
+  });
+
+TVM_REGISTER_API("_load_binary")
+.set_body([](TVMArgs args,  TVMRetValue *ret) {
+    std::string blob = args[0];
+    *ret = LoadBinary<NodeRef>(blob);
+  });
+
+TVM_REGISTER_API("_node_pool_stats")
+.set_body([](TVMArgs args,  TVMRetValue *ret) {
+    Map<std::string, Array<Expr> > stats;
+    for (const NodePoolStats* pool : NodePoolRegistry::Global()->List()) {
+      stats.Set(pool->type_key, Array<Expr>{
+          make_const(Int(64), pool->num_alloc.load(std::memory_order_relaxed)),
+          make_const(Int(64), pool->num_free.load(std::memory_order_relaxed)),
+          make_const(Int(64), pool->num_slab.load(std::memory_order_relaxed)),
+          make_const(Int(64), pool->slab_bytes.load(std::memory_order_relaxed))});
+    }
+    *ret = stats;
+  });
+
 TVM_REGISTER_API("_TVMSetStream")
 .set_body([](TVMArgs args,  TVMRetValue *ret) {
     TVMSetStream(args[0], args[1], args[2]);
@@ -4,11 +4,15 @@
  * \brief Canonicalize simplification.
  */
 #include <tvm/ir_mutator.h>
+#include <tvm/ir_visitor.h>
 #include <tvm/arithmetic.h>
 #include <tvm/ir_pass.h>
+#include <dmlc/common.h>
 #include <algorithm>
 #include <map>
 #include <limits>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include "canonical.h"
 #include "compute_expr.h"
@@ -30,21 +34,6 @@ struct ComExprEntry {
   ComExprEntry() {}
   ComExprEntry(Expr value, int level)
       : value(value), level(level) {}
-  inline bool operator<(const ComExprEntry& other) const {
-    if (level < other.level) return true;
-    if (level > other.level) return false;
-    // compare top operator of entries and sort on that if possible (fast check)
-    if (value.type_index() < other.value.type_index()) return true;
-    if (value.type_index() > other.value.type_index()) return false;
-    // if none of the above distinguishes the terms, compare the expression tree of the entries.
-    // This is a slower check.
-    int compare_result = Compare(value, other.value);
-    if (compare_result < 0) return true;
-    if (compare_result > 0) return false;
-    // it's a problem if we see identical entries at this point. They should've been merged earlier.
-    LOG(WARNING) << "we should not have identical entries at this point";
-    return false;
-  }
 };
 
 // canonical expression for communicative expression.
@@ -130,6 +119,106 @@ struct BinaryExpr {
 };
 
 
+// Hash consing table of expressions.
+// Structurally equal expressions are mapped to the same representative,
+// so that they can be compared by pointer.
+class ExprHashCons : public IRVisitor {
+ public:
+  // Get the representative of the expression.
+  Expr Intern(const Expr& e) {
+    auto it = repr_.find(e.get());
+    if (it != repr_.end()) return it->second;
+    std::vector<Expr>& bucket = table_[Hash(e)];
+    Expr ret;
+    for (const Expr& v : bucket) {
+      if (v.type() == e.type() && Compare(v, e) == 0) {
+        ret = v; break;
+      }
+    }
+    if (!ret.defined()) {
+      bucket.push_back(e);
+      ret = e;
+    }
+    repr_[e.get()] = ret;
+    return ret;
+  }
+  // Structural hash of the node, memoized on the node.
+  size_t Hash(const NodeRef& node) {
+    auto it = hash_.find(node.get());
+    if (it != hash_.end()) return it->second.second;
+    size_t parent = value_;
+    value_ = node->type_index();
+    IRVisitor::Visit(node);
+    size_t ret = value_;
+    value_ = parent;
+    // keep the node alive, so the pointer keys stay valid.
+    hash_[node.get()] = std::make_pair(node, ret);
+    return ret;
+  }
+  void Visit(const NodeRef& node) final {
+    Mix(node.defined() ? Hash(node) : 0);
+  }
+  void Visit_(const Variable* op) final {
+    Mix(reinterpret_cast<size_t>(op));
+  }
+  void Visit_(const IntImm* op) final {
+    MixType(op->type);
+    Mix(static_cast<size_t>(op->value));
+  }
+  void Visit_(const UIntImm* op) final {
+    MixType(op->type);
+    Mix(static_cast<size_t>(op->value));
+  }
+  void Visit_(const FloatImm* op) final {
+    MixType(op->type);
+    Mix(std::hash<double>()(op->value));
+  }
+  void Visit_(const StringImm* op) final {
+    Mix(std::hash<std::string>()(op->value));
+  }
+  void Visit_(const Cast* op) final {
+    MixType(op->type);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Load* op) final {
+    MixType(op->type);
+    this->Visit(op->buffer_var);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Let* op) final {
+    this->Visit(op->var);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Call* op) final {
+    MixType(op->type);
+    Mix(std::hash<std::string>()(op->name));
+    Mix(static_cast<size_t>(op->value_index));
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Broadcast* op) final {
+    Mix(static_cast<size_t>(op->lanes));
+    IRVisitor::Visit_(op);
+  }
+
+ private:
+  void Mix(size_t value) {
+    value_ = dmlc::HashCombine(value_, value);
+  }
+  void MixType(const Type& t) {
+    Mix(static_cast<size_t>(t.code()));
+    Mix(static_cast<size_t>(t.bits()));
+    Mix(static_cast<size_t>(t.lanes()));
+  }
+  // hash value of the node being visited.
+  size_t value_{0};
+  // memoized hash of each node.
+  std::unordered_map<const Node*, std::pair<NodeRef, size_t> > hash_;
+  // representative of each interned node.
+  std::unordered_map<const Node*, Expr> repr_;
+  // the representatives, indexed by hash.
+  std::unordered_map<size_t, std::vector<Expr> > table_;
+};
+
 template<typename T>
 inline Expr Binary_(const T* op,
                     const Expr& e,
@@ -188,6 +277,10 @@ class Canonical::Internal : public IRMutator {
   };
   // Set range and level of var.
   void SetRange(Var v, Range r, int level) {
+    // results simplified under the old context are no longer valid.
+    if (var_level_.count(v.get()) || free_var_.count(v.get())) {
+      cache_expr_.clear();
+    }
     var_range_[v.get()] = IntSet::range(r);
     var_level_[v.get()] = level;
     var_rec_.push_back(v);
@@ -198,6 +291,20 @@ class Canonical::Internal : public IRMutator {
     return stmt;
   }
   Expr MutateExpr_(Expr expr) {
+    // reuse the result of a structurally equal expression.
+    Expr key;
+    if (!expr.as<Variable>() && !is_const(expr)) {
+      key = hash_cons_.Intern(expr);
+      auto it = cache_expr_.find(key.get());
+      if (it != cache_expr_.end()) {
+        if (stack_.size() != 0) {
+          StackEntry& prev = stack_.back();
+          prev.max_level = std::max(prev.max_level, it->second.max_level);
+        }
+        ret_entry_ = it->second;
+        return it->second.value;
+      }
+    }
     stack_.push_back(StackEntry());
     expr = IRMutator::Mutate(expr);
     // update result of parent automatically during pop
@@ -213,7 +320,13 @@ class Canonical::Internal : public IRMutator {
     stack_.pop_back();
     CHECK(expr.defined());
     if (const IntImm* op = expr.as<IntImm>()) {
-      return Mutate_(op, expr);
+      expr = Mutate_(op, expr);
+    }
+    expr = hash_cons_.Intern(expr);
+    if (key.defined() && !ret_entry_.has_side_effect) {
+      CacheEntry& entry = cache_expr_[key.get()];
+      entry = ret_entry_;
+      entry.value = expr;
     }
     return expr;
   }
@@ -303,6 +416,8 @@ class Canonical::Internal : public IRMutator {
     auto it = var_level_.find(op);
     if (it != var_level_.end()) {
       stack_.back().max_level = it->second;
+    } else {
+      free_var_.insert(op);
     }
     return IRMutator::Mutate_(op, e);
   }
@@ -448,6 +563,31 @@ class Canonical::Internal : public IRMutator {
       return ret;
     }
   }
+  // Compare two entries of a sum, sort by level, then by top operator
+  // and only compare the expression trees if that does not distinguish them.
+  bool EntryLess(const ComExprEntry& a, const ComExprEntry& b) {
+    if (a.level != b.level) return a.level < b.level;
+    if (a.value.type_index() != b.value.type_index()) {
+      return a.value.type_index() < b.value.type_index();
+    }
+    Expr va = hash_cons_.Intern(a.value);
+    Expr vb = hash_cons_.Intern(b.value);
+    if (va.same_as(vb)) {
+      // it's a problem if we see identical entries at this point.
+      // They should've been merged earlier.
+      LOG(WARNING) << "we should not have identical entries at this point";
+      return false;
+    }
+    // values are hash consed, so the result of the slow tree
+    // comparison can be memoized on the pointers.
+    auto key = std::make_pair(va.get(), vb.get());
+    auto it = cache_compare_.find(key);
+    if (it != cache_compare_.end()) return it->second < 0;
+    int order = Compare(va, vb);
+    cache_compare_[key] = order;
+    cache_compare_[std::make_pair(vb.get(), va.get())] = -order;
+    return order < 0;
+  }
   // return entry
   CacheEntry ret_entry_;
   // internal information stack
@@ -458,6 +598,14 @@ class Canonical::Internal : public IRMutator {
   std::map<BinaryExpr, Expr> cache_binary_;
   // cache of int constant
   std::unordered_map<int64_t, Expr> cache_intimm_;
+  // hash consing table of the expressions.
+  ExprHashCons hash_cons_;
+  // cache of the result, indexed by the representative of the input.
+  std::unordered_map<const Node*, CacheEntry> cache_expr_;
+  // cache of the comparison between representatives.
+  std::map<std::pair<const Node*, const Node*>, int> cache_compare_;
+  // vars which were used without a range.
+  std::unordered_set<const Variable*> free_var_;
   // range of each var
   std::unordered_map<const Variable*, IntSet> var_range_;
   // level of each var
@@ -656,7 +804,7 @@ class Canonical::Internal : public IRMutator {
           n->elem.push_back(e);
         }
         ++i; ++j;
-      } else if (a < b) {
+      } else if (EntryLess(a, b)) {
         n->elem.push_back(a);
         ++i;
       } else {
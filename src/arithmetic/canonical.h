@@ -17,7 +17,8 @@ namespace arith {
  *
  *  Simplify and CSE with canonicalization expressions.
  *  Each call's result will get cached, so next call will
- *  simply return the cached result.
+ *  simply return the cached result. Expressions are hash consed,
+ *  so structurally equal sub-expressions are only simplified once.
  */
 class Canonical {
  public:
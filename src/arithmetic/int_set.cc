@@ -7,8 +7,13 @@
 #include <tvm/ir_pass.h>
 #include <tvm/arithmetic.h>
 #include <tvm/ir_functor_ext.h>
+#include <tvm/ir_visitor.h>
+#include <dmlc/thread_local.h>
 #include <arithmetic/Interval.h>
+#include <algorithm>
+#include <iterator>
 #include <unordered_map>
+#include <vector>
 #include "compute_expr.h"
 #include "int_set_internal.h"
 
@@ -436,17 +441,149 @@ inline IntSet Combine(const IntSet& a, const IntSet &b) {
   return CombineSets<OP>(a, b);
 }
 
+// Cache of the evaluated sets, active within EvalSetCacheScope.
+// The set of an expression only depends on the domain of its free
+// variables, so a result is reused whenever these domains are the same.
+class EvalSetCache {
+ public:
+  // Number of active scopes.
+  int depth{0};
+  // Find a result computed under the same domain of the free variables.
+  bool Lookup(const Expr& e,
+              const std::unordered_map<const Variable*, IntSet>& dom_map,
+              IntSet* result) {
+    ExprInfo& info = GetInfo(e);
+    for (const Entry& entry : info.entries) {
+      bool match = true;
+      for (size_t i = 0; i < info.vars.size() && match; ++i) {
+        auto it = dom_map.find(info.vars[i]);
+        match = SameSet(it != dom_map.end() ? it->second : IntSet(), entry.dom[i]);
+      }
+      if (match) {
+        *result = entry.result;
+        return true;
+      }
+    }
+    return false;
+  }
+  // Record the result under the current domain.
+  void Insert(const Expr& e,
+              const std::unordered_map<const Variable*, IntSet>& dom_map,
+              const IntSet& result) {
+    ExprInfo& info = GetInfo(e);
+    Entry entry;
+    for (const Variable* v : info.vars) {
+      auto it = dom_map.find(v);
+      entry.dom.push_back(it != dom_map.end() ? it->second : IntSet());
+    }
+    entry.result = result;
+    if (info.entries.size() >= kMaxEntryPerExpr) {
+      info.entries.erase(info.entries.begin());
+    }
+    info.entries.emplace_back(std::move(entry));
+  }
+  // Drop all cached results.
+  void Clear() {
+    info_.clear();
+  }
+  static EvalSetCache* ThreadLocal() {
+    return dmlc::ThreadLocalStore<EvalSetCache>::Get();
+  }
+
+ private:
+  // Maximum number of domains remembered for each expression.
+  static constexpr size_t kMaxEntryPerExpr = 8;
+  // A result and the domain of each free variable it was computed under.
+  struct Entry {
+    std::vector<IntSet> dom;
+    IntSet result;
+  };
+  struct ExprInfo {
+    // keep the expression alive, so the pointer key stays valid.
+    Expr expr;
+    // The free variables, sorted by address.
+    std::vector<const Variable*> vars;
+    std::vector<Entry> entries;
+  };
+  // Collect the direct children of an expression.
+  class ChildCollector : public IRVisitor {
+   public:
+    void Visit(const NodeRef& node) final {
+      if (node.defined()) children.push_back(node);
+    }
+    std::vector<NodeRef> children;
+  };
+  ExprInfo& GetInfo(const Expr& e) {
+    auto it = info_.find(e.get());
+    if (it != info_.end()) return it->second;
+    std::vector<const Variable*> vars;
+    if (const Variable* v = e.as<Variable>()) {
+      vars.push_back(v);
+    } else {
+      ChildCollector collector;
+      collector.IRVisitor::Visit(e);
+      for (const NodeRef& child : collector.children) {
+        const std::vector<const Variable*>& cvars =
+            GetInfo(Expr(child.node_)).vars;
+        std::vector<const Variable*> merged;
+        std::set_union(vars.begin(), vars.end(), cvars.begin(), cvars.end(),
+                       std::back_inserter(merged));
+        vars.swap(merged);
+      }
+    }
+    ExprInfo& info = info_[e.get()];
+    info.expr = e;
+    info.vars = std::move(vars);
+    return info;
+  }
+  static bool SameSet(const IntSet& a, const IntSet& b) {
+    if (a.same_as(b)) return true;
+    if (!a.defined() || !b.defined()) return false;
+    const IntervalSet* a_int = a.as<IntervalSet>();
+    const IntervalSet* b_int = b.as<IntervalSet>();
+    return a_int && b_int &&
+        Equal(a_int->i.min, b_int->i.min) &&
+        Equal(a_int->i.max, b_int->i.max);
+  }
+  std::unordered_map<const Node*, ExprInfo> info_;
+};
+
+EvalSetCacheScope::EvalSetCacheScope() {
+  ++EvalSetCache::ThreadLocal()->depth;
+}
+
+EvalSetCacheScope::~EvalSetCacheScope() {
+  EvalSetCache* cache = EvalSetCache::ThreadLocal();
+  if (--cache->depth == 0) {
+    cache->Clear();
+  }
+}
+
 class IntSetEvaluator :
       public ExprFunctor<IntSet(const Expr&, const Expr&)> {
  public:
+  using Base = ExprFunctor<IntSet(const Expr&, const Expr&)>;
   explicit IntSetEvaluator(
       const std::unordered_map<const Variable*, IntSet>& dom_map,
       bool eval_vec = false)
-      : dom_map_(dom_map), eval_vec_(eval_vec) {}
+      : dom_map_(dom_map), eval_vec_(eval_vec) {
+    EvalSetCache* cache = EvalSetCache::ThreadLocal();
+    if (!eval_vec && cache->depth != 0) cache_ = cache;
+  }
   // Evaluate.
   IntSet Eval(const Expr& e) {
     return this->VisitExpr(e, e);
   }
+  IntSet VisitExpr(const Expr& n, const Expr& e) override {
+    if (cache_ == nullptr || n.as<Variable>() || is_const(n)) {
+      return Base::VisitExpr(n, e);
+    }
+    IntSet ret;
+    if (cache_->Lookup(n, dom_map_, &ret)) return ret;
+    ret = Base::VisitExpr(n, e);
+    cache_->Insert(n, dom_map_, ret);
+    return ret;
+  }
   IntSet VisitExpr_(const IntImm* op, const Expr& e) final {
     return IntSet::single_point(e);
   }
@@ -549,6 +686,8 @@ class IntSetEvaluator :
 
   const std::unordered_map<const Variable*, IntSet>& dom_map_;
   bool eval_vec_{false};
+  // The active cache, if any.
+  EvalSetCache* cache_{nullptr};
 };
 
 IntSet EvalSet(Expr e,
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <mutex>
 #include <stack>
+#include "../pass/lower_pipeline.h"
 
 namespace tvm {
 
@@ -357,36 +358,89 @@ Stmt BuildStmt(Schedule sch,
   GetBinds(args, binds, &out_binds, out_arg_list, config);
 
   sch = sch.normalize();
+  ir::LowerPipeline pipeline(config->incremental_lower);
 
   // Phase 0
-  auto bounds = schedule::InferBound(sch);
-  auto stmt = schedule::ScheduleOps(sch, bounds, false);
-  stmt = ir::InjectPrefetch(stmt);
+  Map<IterVar, Range> bounds;
+  Stmt stmt;
+  ir::LowerPipeline::Time("InferBound", [&]() {
+      bounds = schedule::InferBound(sch);
+    });
+  ir::LowerPipeline::Time("ScheduleOps", [&]() {
+      stmt = schedule::ScheduleOps(sch, bounds, false);
+    });
+  stmt = pipeline.Run("InjectPrefetch", stmt, [](Stmt s) {
+      return ir::InjectPrefetch(s);
+    });
 
   // Phase 1
-  stmt = ir::StorageFlatten(stmt, out_binds, 64,
-                            config->instrument_bound_checkers);
-  stmt = ir::CanonicalSimplify(stmt);
+  stmt = pipeline.Run("StorageFlatten", stmt, [&](Stmt s) {
+      return ir::StorageFlatten(s, out_binds, 64,
+                                config->instrument_bound_checkers);
+    });
+  stmt = pipeline.Run("CanonicalSimplify", stmt, [](Stmt s) {
+      return ir::CanonicalSimplify(s);
+    }, true);
   if (loop_partition) {
-    stmt = ir::LoopPartition(stmt, config->partition_const_loop);
+    bool split_const_loop = config->partition_const_loop;
+    stmt = pipeline.Run(
+        "LoopPartition(" + std::to_string(split_const_loop) + ")", stmt,
+        [split_const_loop](Stmt s) {
+          return ir::LoopPartition(s, split_const_loop);
+        }, true);
+  }
+  stmt = pipeline.Run("VectorizeLoop", stmt, [](Stmt s) {
+      return ir::VectorizeLoop(s);
+    }, true);
+  stmt = pipeline.Run("InjectVirtualThread", stmt, [](Stmt s) {
+      return ir::InjectVirtualThread(s);
+    });
+  stmt = pipeline.Run("InjectDoubleBuffer", stmt, [&](Stmt s) {
+      return ir::InjectDoubleBuffer(s, config->double_buffer_split_loop);
+    });
+  stmt = pipeline.Run("StorageRewrite", stmt, [](Stmt s) {
+      return ir::StorageRewrite(s);
+    });
+  std::ostringstream unroll_key;
+  unroll_key << "UnrollLoop(" << config->auto_unroll_max_step
+             << "," << config->auto_unroll_max_depth
+             << "," << config->auto_unroll_max_extent
+             << "," << config->unroll_explicit << ")";
+  stmt = pipeline.Run(unroll_key.str(), stmt, [&](Stmt s) {
+      return ir::UnrollLoop(s, config->auto_unroll_max_step, config->auto_unroll_max_depth,
+                            config->auto_unroll_max_extent, config->unroll_explicit);
+    }, true);
+  if (config->cpu_prefetch_distance > 0) {
+    int distance = config->cpu_prefetch_distance;
+    stmt = pipeline.Run(
+        "InjectCPUPrefetch(" + std::to_string(distance) + ")", stmt,
+        [distance](Stmt s) {
+          return ir::InjectCPUPrefetch(s, distance);
+        }, true);
   }
-  stmt = ir::VectorizeLoop(stmt);
-  stmt = ir::InjectVirtualThread(stmt);
-  stmt = ir::InjectDoubleBuffer(stmt, config->double_buffer_split_loop);
-  stmt = ir::StorageRewrite(stmt);
-  stmt = ir::UnrollLoop(stmt, config->auto_unroll_max_step, config->auto_unroll_max_depth,
-    config->auto_unroll_max_extent, config->unroll_explicit);
 
   // Phase 2
-  stmt = ir::Simplify(stmt);
-  stmt = ir::LowerStorageAccessInfo(stmt);
-  stmt = ir::RemoveNoOp(stmt);
+  stmt = pipeline.Run("Simplify", stmt, [](Stmt s) {
+      return ir::Simplify(s);
+    }, true);
+  stmt = pipeline.Run("LowerStorageAccessInfo", stmt, [](Stmt s) {
+      return ir::LowerStorageAccessInfo(s);
+    });
+  stmt = pipeline.Run("RemoveNoOp", stmt, [](Stmt s) {
+      return ir::RemoveNoOp(s);
+    }, true);
 
-  if (!(config->disable_select_rewriting))
-    stmt = ir::RewriteUnsafeSelect(stmt);
+  if (!(config->disable_select_rewriting)) {
+    stmt = pipeline.Run("RewriteUnsafeSelect", stmt, [](Stmt s) {
+        return ir::RewriteUnsafeSelect(s);
+      }, true);
+  }
 
-  if (config->instrument_bound_checkers)
-    stmt = ir::InstrumentBoundCheckers(stmt);
+  if (config->instrument_bound_checkers) {
+    stmt = pipeline.Run("InstrumentBoundCheckers", stmt, [](Stmt s) {
+        return ir::InstrumentBoundCheckers(s);
+      });
+  }
 
   return stmt;
 }
@@ -538,7 +592,8 @@ TVM_STATIC_IR_FUNCTOR(IRPrinter, vtable)
   p->stream << "partition_const_loop=" << op->partition_const_loop << ", ";
   p->stream << "dump_pass_ir=" << op->dump_pass_ir << ", ";
   p->stream << "instrument_bound_checkers=" << op->instrument_bound_checkers << ", ";
-  p->stream << "disable_select_rewriting=" << op->disable_select_rewriting;
+  p->stream << "disable_select_rewriting=" << op->disable_select_rewriting << ", ";
+  p->stream << "cpu_prefetch_distance=" << op->cpu_prefetch_distance;
   p->stream << ")";
 });
 
@@ -3,6 +3,7 @@
  * \file codegen_c_host.cc
  */
 #include <tvm/packed_func_ext.h>
+#include <tvm/ir_pass.h>
 #include <vector>
 #include <string>
 #include "codegen_c_host.h"
@@ -16,8 +17,6 @@ CodeGenCHost::CodeGenCHost() {
 }
 
 void CodeGenCHost::Init(bool output_ssa) {
-  decl_stream << "#include \"tvm/runtime/c_runtime_api.h\"\n";
-  decl_stream << "#include \"tvm/runtime/c_backend_api.h\"\n";
   decl_stream << "extern void* " << module_name << " = NULL;\n";
   CodeGenC::Init(output_ssa);
 }
@@ -31,6 +30,7 @@ void CodeGenCHost::AddFunction(LoweredFunc f) {
   for (const auto & kv : f->handle_data_type) {
     RegisterHandleType(kv.first.get(), kv.second.type());
   }
+  function_name_ = f->name;
 
   this->stream << "#ifdef __cplusplus\n";
   this->stream << "extern \"C\"\n";
@@ -74,7 +74,12 @@ void CodeGenCHost::AddFunction(LoweredFunc f) {
 }
 
 std::string CodeGenCHost::Finish() {
-  return CodeGenC::Finish();
+  std::ostringstream code;
+  code << "#include \"tvm/runtime/c_runtime_api.h\"\n";
+  code << "#include \"tvm/runtime/c_backend_api.h\"\n";
+  code << vec_type_decl_.str();
+  code << CodeGenC::Finish();
+  return code.str();
 }
 
 void CodeGenCHost::PrintType(Type t, std::ostream& os) {  // NOLINT(*)
@@ -87,52 +92,143 @@ void CodeGenCHost::PrintType(Type t, std::ostream& os) {  // NOLINT(*)
   if (t == Bool()) {
     os << "bool"; return;
   }
-  bool fail = false;
+  std::string scalar;
   if (t.is_float()) {
     switch (t.bits()) {
-      case 16:
-        os << "half";
-        break;
-      case 32: os << "float"; break;
-      case 64:
-        os << "double";
-        break;
-      default: fail = true; break;
-    }
-    if (!fail && lanes == 1) return;
-    if (!fail && (lanes >= 2 && lanes <= 16)) {
-      os << lanes; return;
+      case 16: scalar = "half"; break;
+      case 32: scalar = "float"; break;
+      case 64: scalar = "double"; break;
+      default: break;
     }
   } else if (t.is_uint() || t.is_int()) {
-    if (t.is_uint()) {
-      os << 'u';
-    }
     switch (t.bits()) {
-      case 8: os << "int8_t"; break;
-      case 16: os << "int16_t"; break;
-      case 32: os << "int32_t"; break;
-      case 64: os << "int64_t"; break;
-      case 1: os << "int32_t"; break;
-      default: fail = true; break;
+      case 8: scalar = "int8_t"; break;
+      case 16: scalar = "int16_t"; break;
+      case 32: scalar = "int32_t"; break;
+      case 64: scalar = "int64_t"; break;
+      case 1: scalar = "int32_t"; break;
+      default: break;
     }
-    if (!fail && lanes == 1) return;
-    if (!fail && (lanes >= 2 && lanes <= 16)) {
-      os << lanes; return;
+    if (t.is_uint() && !scalar.empty()) scalar = "u" + scalar;
+  }
+  if (!scalar.empty() && lanes == 1) {
+    os << scalar; return;
+  }
+  // Vector types are declared with the vector extension of GCC and Clang,
+  // comparisons yield signed integer vectors, the boolean vectors are int32
+  // and converted to the width of the compared or selected lanes.
+  if (!scalar.empty() && !(t.is_float() && t.bits() == 16) &&
+      lanes >= 2 && lanes <= 64 && (lanes & (lanes - 1)) == 0) {
+    int bits = t.bits() == 1 ? 32 : t.bits();
+    if (t.bits() == 1) scalar = "int32_t";
+    std::ostringstream name;
+    name << (t.is_float() ? "float" : (t.is_uint() && t.bits() != 1 ? "uint" : "int"))
+         << bits << 'x' << lanes;
+    if (!declared_vec_types_.count(name.str())) {
+      declared_vec_types_.insert(name.str());
+      // Only align to the element so that vector loads and stores
+      // can be done on any element of a buffer.
+      vec_type_decl_ << "typedef " << scalar << ' ' << name.str()
+                     << " __attribute__((vector_size(" << bits / 8 * lanes
+                     << "), aligned(" << bits / 8 << ")));\n";
     }
+    os << name.str(); return;
   }
   LOG(FATAL) << "Cannot convert type " << t << " to C type";
 }
 
+void CodeGenCHost::VisitExpr_(const Ramp* op, std::ostream& os) {  // NOLINT(*)
+  std::string base = PrintExpr(op->base);
+  std::string stride = PrintExpr(op->stride);
+  os << "((";
+  PrintType(op->type, os);
+  os << "){";
+  for (int i = 0; i < op->lanes; ++i) {
+    if (i != 0) os << ", ";
+    os << "(" << base << ")+(" << stride << "*" << i << ")";
+  }
+  os << "})";
+}
+
 void CodeGenCHost::VisitExpr_(const Broadcast* op, std::ostream& os) {   // NOLINT(*)
   std::string v = PrintExpr(op->value);
   os << "((";
   PrintType(op->type, os);
-  os << ")(";
+  os << "){";
   for (int i = 0; i < op->lanes; ++i) {
     if (i != 0) os << ", ";
     os << v;
   }
-  os << "))";
+  os << "})";
+}
+
+void CodeGenCHost::PrintVecBinaryOp(
+    const std::string& op, Type t,
+    Expr lhs, Expr rhs, std::ostream& os) {  // NOLINT(*)
+  if (op == "min" || op == "max") {
+    // the vector extension has no min and max, select on the comparison.
+    std::string a = PrintExpr(lhs);
+    std::string b = PrintExpr(rhs);
+    os << "((" << a << (op == "min" ? " < " : " > ") << b << ") ? "
+       << a << " : " << b << ")";
+  } else if (t.is_bool() && !lhs.type().is_bool() && lhs.type().bits() != 32) {
+    // the comparison yields lanes of the width of its operands,
+    // convert them to the int32 lanes of the boolean vectors.
+    std::ostringstream cmp;
+    CodeGenC::PrintVecBinaryOp(op, t, lhs, rhs, cmp);
+    os << CastBoolVector(cmp.str(), Int(32, t.lanes()));
+  } else {
+    CodeGenC::PrintVecBinaryOp(op, t, lhs, rhs, os);
+  }
+}
+
+void CodeGenCHost::VisitExpr_(const Select* op, std::ostream& os) {  // NOLINT(*)
+  int bits = op->type.is_bool() ? 32 : op->type.bits();
+  if (op->condition.type().lanes() == 1 || bits == 32) {
+    CodeGenC::VisitExpr_(op, os);
+    return;
+  }
+  // the lanes of the mask must have the width of the selected values.
+  std::string cond = CastBoolVector(
+      PrintExpr(op->condition), Int(bits, op->type.lanes()));
+  os << "(" << cond << " ? ";
+  PrintExpr(op->true_value, os);
+  os << " : ";
+  PrintExpr(op->false_value, os);
+  os << ")";
+}
+
+std::string CodeGenCHost::CastBoolVector(const std::string& value, Type target) {
+  std::ostringstream os;
+  os << "__builtin_convertvector(" << value << ", ";
+  this->PrintType(target, os);
+  os << ")";
+  return os.str();
+}
+
+void CodeGenCHost::PrintVecElemLoad(const std::string& vec,
+                                    Type t, int i,
+                                    std::ostream& os) {  // NOLINT(*)
+  os << vec << '[' << i << ']';
+}
+
+void CodeGenCHost::PrintVecElemStore(const std::string& vec,
+                                     Type t, int i,
+                                     const std::string& value) {
+  this->PrintIndent();
+  stream << vec << '[' << i << "] = " << value << ";\n";
+}
+
+std::string CodeGenCHost::CastFromTo(std::string value, Type from, Type target) {
+  if (from == target || target.lanes() == 1) {
+    return CodeGenC::CastFromTo(value, from, target);
+  }
+  // a C cast of vectors reinterprets the bits, convert the lanes instead.
+  std::ostringstream os;
+  os << "__builtin_convertvector(" << value << ", ";
+  this->PrintType(target, os);
+  os << ")";
+  return os.str();
 }
 
 void CodeGenCHost::PrintGetFuncFromBackend(std::string func_name, std::string packed_func_name) {
@@ -232,6 +328,179 @@ void CodeGenCHost::VisitStmt_(const AssertStmt *op) { // NOLINT(*)
   this->PrintStmt(op->body);
 }
 
+void CodeGenCHost::VisitStmt_(const AttrStmt* op) { // NOLINT(*)
+  if (op->attr_key == "pragma_parallel_stride_pattern") {
+    CHECK(parallel_env_.task_id.defined())
+        << "Pragma parallel_stride_pattern only valid in parallel launch";
+    parallel_env_.stride_pattern = true;
+    this->PrintStmt(op->body);
+  } else if (op->attr_key == "pragma_parallel_launch_point") {
+    CreateParallelLaunch(op->body, 0);
+  } else if (op->attr_key == "pragma_parallel_barrier_when_finish") {
+    CHECK(parallel_env_.task_id.defined())
+        << "Cannot run barrier without parallel environment";
+    CHECK(!parallel_env_.in_parallel_loop)
+        << "Cannot not place within parallel loop as the workload may differ, "
+        << " place it between parallel and parallel_launch_point";
+    this->PrintStmt(op->body);
+    PrintIndent();
+    stream << "TVMBackendParallelBarrier(" << GetVarID(parallel_env_.task_id.get())
+           << ", " << parallel_env_.penv << ");\n";
+  } else {
+    CodeGenC::VisitStmt_(op);
+  }
+}
+
+void CodeGenCHost::VisitStmt_(const For* op) { // NOLINT(*)
+  if (op->for_type != ForType::Parallel) {
+    CodeGenC::VisitStmt_(op);
+    return;
+  }
+  if (!parallel_env_.task_id.defined()) {
+    CreateParallelLaunch(
+        For::make(
+            op->loop_var, op->min, op->extent,
+            op->for_type, op->device_api, op->body), 0);
+    return;
+  }
+  // already in parallel env, run the share of the iterations of this task.
+  CHECK(is_zero(op->min));
+  CHECK(!parallel_env_.in_parallel_loop)
+      << "Nested parallel loop is not supported by threadpool, try fuse them instead";
+  parallel_env_.in_parallel_loop = true;
+  std::string task_id = GetVarID(parallel_env_.task_id.get());
+  std::string num_task = GetVarID(parallel_env_.num_task.get());
+  std::string extent = PrintExpr(op->extent);
+  std::string vid = AllocVarID(op->loop_var.get());
+  if (parallel_env_.stride_pattern) {
+    PrintIndent();
+    stream << "for (";
+    PrintType(op->loop_var.type(), stream);
+    stream << ' ' << vid << " = " << task_id << "; "
+           << vid << " < " << extent << "; "
+           << vid << " += " << num_task << ") {\n";
+  } else {
+    std::string step = GetUniqueName(vid + "_step");
+    std::string begin = GetUniqueName(vid + "_begin");
+    std::string end = GetUniqueName(vid + "_end");
+    PrintIndent();
+    PrintType(op->loop_var.type(), stream);
+    stream << ' ' << step << " = (" << extent << " + " << num_task << " - 1) / "
+           << num_task << ";\n";
+    PrintIndent();
+    PrintType(op->loop_var.type(), stream);
+    stream << ' ' << begin << " = " << task_id << " * " << step << ";\n";
+    PrintIndent();
+    PrintType(op->loop_var.type(), stream);
+    stream << ' ' << end << " = (" << extent << " < " << begin << " + " << step << ") ? "
+           << extent << " : " << begin << " + " << step << ";\n";
+    PrintIndent();
+    stream << "for (";
+    PrintType(op->loop_var.type(), stream);
+    stream << ' ' << vid << " = " << begin << "; "
+           << vid << " < " << end << "; ++" << vid << ") {\n";
+  }
+  int for_scope = BeginScope();
+  PrintStmt(op->body);
+  this->EndScope(for_scope);
+  PrintIndent();
+  stream << "}\n";
+  parallel_env_.in_parallel_loop = false;
+  ++parallel_env_.parallel_loop_count;
+}
+
+void CodeGenCHost::PrintClosureFieldType(const Var& v, std::ostream& os) { // NOLINT(*)
+  auto it = handle_data_type_.find(v.get());
+  if (v.type().is_handle() && it != handle_data_type_.end()) {
+    PrintType(it->second, os);
+    os << '*';
+  } else {
+    PrintType(v.type(), os);
+  }
+}
+
+void CodeGenCHost::CreateParallelLaunch(const Stmt& body, int num_task) {
+  // The lambda and its closure are defined before the current function,
+  // the names are prefixed as the name table is reset for each function.
+  std::string lambda_name = GetUniqueName(function_name_ + "_parallel_lambda");
+  std::string closure_type = GetUniqueName(function_name_ + "_parallel_closure");
+  Array<Var> vfields = ir::UndefinedVars(body, {});
+  std::vector<std::string> fields;
+  decl_stream << "typedef struct {\n";
+  for (const Var& v : vfields) {
+    fields.push_back(GetUniqueName(v->name_hint));
+    decl_stream << "  ";
+    PrintClosureFieldType(v, decl_stream);
+    decl_stream << ' ' << fields.back() << ";\n";
+  }
+  // keep the struct non-empty, which is required by C.
+  if (vfields.size() == 0) {
+    decl_stream << "  int32_t __dummy;\n";
+  }
+  decl_stream << "} " << closure_type << ";\n";
+  // pack the closure and launch the lambda.
+  std::string cdata = GetUniqueName("cdata");
+  PrintIndent();
+  stream << closure_type << ' ' << cdata << ";\n";
+  for (size_t i = 0; i < vfields.size(); ++i) {
+    PrintIndent();
+    stream << cdata << '.' << fields[i] << " = " << GetVarID(vfields[i].get()) << ";\n";
+  }
+  PrintIndent();
+  stream << "if (TVMBackendParallelLaunch(" << lambda_name << ", &" << cdata
+         << ", " << num_task << ") != 0) {\n";
+  int launch_scope = BeginScope();
+  PrintIndent();
+  stream << "return -1;\n";
+  EndScope(launch_scope);
+  PrintIndent();
+  stream << "}\n";
+  // Print the lambda into its own stream, the captured variables are
+  // unpacked into locals of the same name as the closure fields.
+  std::ostringstream lambda_stream;
+  std::swap(stream, lambda_stream);
+  int indent = indent_;
+  indent_ = 0;
+  auto var_idmap = var_idmap_;
+  ParallelEnv par_env;
+  par_env.task_id = Var("task_id", Int(32));
+  par_env.num_task = Var("num_task", Int(32));
+  par_env.penv = GetUniqueName("penv");
+  std::string task_id = AllocVarID(par_env.task_id.get());
+  std::string num_task_id = AllocVarID(par_env.num_task.get());
+  std::string lambda_cdata = GetUniqueName("cdata");
+  std::string closure = GetUniqueName("closure");
+  stream << "static int " << lambda_name << "(int " << task_id
+         << ", TVMParallelGroupEnv* " << par_env.penv
+         << ", void* " << lambda_cdata << ") {\n";
+  int lambda_scope = BeginScope();
+  PrintIndent();
+  stream << "int " << num_task_id << " = " << par_env.penv << "->num_task;\n";
+  PrintIndent();
+  stream << closure_type << "* " << closure << " = ("
+         << closure_type << "*)" << lambda_cdata << ";\n";
+  for (size_t i = 0; i < vfields.size(); ++i) {
+    var_idmap_[vfields[i].get()] = fields[i];
+    PrintIndent();
+    PrintClosureFieldType(vfields[i], stream);
+    stream << ' ' << fields[i] << " = " << closure << "->" << fields[i] << ";\n";
+  }
+  std::swap(parallel_env_, par_env);
+  this->PrintStmt(body);
+  std::swap(parallel_env_, par_env);
+  PrintIndent();
+  stream << "return 0;\n";
+  EndScope(lambda_scope);
+  stream << "}\n\n";
+  CHECK_NE(par_env.parallel_loop_count, 0)
+      << "Cannot find parallel loop within parallel launch";
+  decl_stream << stream.str();
+  // back to the current function.
+  std::swap(stream, lambda_stream);
+  indent_ = indent;
+  var_idmap_ = var_idmap;
+}
+
 runtime::Module BuildCHost(Array<LoweredFunc> funcs) {
   using tvm::runtime::Registry;
   bool output_ssa = false;
@@ -9,6 +9,7 @@
 #include <tvm/codegen.h>
 #include <tvm/packed_func_ext.h>
 #include <string>
+#include <unordered_set>
 #include "codegen_c.h"
 
 namespace tvm {
@@ -24,12 +25,55 @@ class CodeGenCHost final : public CodeGenC {
   void PrintType(Type t, std::ostream& os) final; // NOLINT(*)
 
   // overload visitor functions
+  void VisitExpr_(const Ramp* op, std::ostream& os) final; // NOLINT(*)
   void VisitExpr_(const Broadcast* op, std::ostream& os) final; // NOLINT(*)
   void VisitExpr_(const Call *op, std::ostream& os) final; // NOLINT(*)
+  void VisitExpr_(const Select* op, std::ostream& os) final; // NOLINT(*)
   void VisitStmt_(const AssertStmt *op) final; // NOLINT(*)
+  void VisitStmt_(const AttrStmt* op) final; // NOLINT(*)
+  void VisitStmt_(const For* op) final; // NOLINT(*)
+
+  // vector support through the GCC/Clang vector extension
+  void PrintVecBinaryOp(
+      const std::string& op, Type op_type,
+      Expr lhs, Expr rhs, std::ostream& os) final;  // NOLINT(*)
+  void PrintVecElemLoad(
+      const std::string& vec, Type t, int i, std::ostream& os) final;  // NOLINT(*)
+  void PrintVecElemStore(
+      const std::string& vec, Type t, int i, const std::string& value) final;
+  std::string CastFromTo(std::string value, Type from, Type target) final;
 
  private:
+  /*! \brief The parallel environment of the current parallel lambda. */
+  struct ParallelEnv {
+    /*! \brief The task id, undefined outside of parallel lambda. */
+    Var task_id;
+    /*! \brief The number of tasks. */
+    Var num_task;
+    /*! \brief The name of the TVMParallelGroupEnv pointer. */
+    std::string penv;
+    /*! \brief Whether the parallel loops are strided over the tasks. */
+    bool stride_pattern{false};
+    /*! \brief Whether we are inside a parallel loop. */
+    bool in_parallel_loop{false};
+    /*! \brief The number of parallel loops in the lambda. */
+    int parallel_loop_count{0};
+  };
   std::string module_name;
+  /*! \brief The name of the current function, prefix of its lambdas. */
+  std::string function_name_;
+  /*! \brief The current parallel environment. */
+  ParallelEnv parallel_env_;
+  /*! \brief The typedefs of the vector types used by the module. */
+  std::ostringstream vec_type_decl_;
+  /*! \brief The vector types that are already declared. */
+  std::unordered_set<std::string> declared_vec_types_;
+  // Lower the body into a lambda run by TVMBackendParallelLaunch.
+  void CreateParallelLaunch(const Stmt& body, int num_task);
+  // Convert the lanes of a boolean vector to the integer vector type target.
+  std::string CastBoolVector(const std::string& value, Type target);
+  // Print the type of a variable captured by the lambda closure.
+  void PrintClosureFieldType(const Var& v, std::ostream& os);  // NOLINT(*)
   void PrintGetFuncFromBackend(std::string func_name, std::string packed_func_name);
   void PrintFuncCall(std::string packed_func_name, int num_args);
 };
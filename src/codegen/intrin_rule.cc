@@ -34,6 +34,17 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.default.sigmoid")
     *rv = one / (one + exp(-call->args[0]));
   });
 
+// the locality and the cache type follow the llvm intrinsic,
+// the builtin only takes the locality and prefetches data.
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.c.prefetch")
+.set_body([](const TVMArgs& args, TVMRetValue* rv){
+    Expr e = args[0];
+    const Call* call = e.as<Call>();
+    CHECK(call != nullptr);
+    *rv = Call::make(call->type, "__builtin_prefetch",
+                     {call->args[0], call->args[1], call->args[2]}, Call::Extern);
+  });
+
 }  // namespace intrin
 }  // namespace codegen
 }  // namespace tvm
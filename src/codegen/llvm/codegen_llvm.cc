@@ -895,6 +895,27 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Load* op) {
     // vector load
     unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(
       buffer->getType())->getAddressSpace();
+    if (!is_one(op->predicate)) {
+      // masked load, the masked lanes are zero.
+      llvm::Value* mask = MakeValue(op->predicate);
+      llvm::Value* passthru = llvm::Constant::getNullValue(LLVMType(t));
+      const Ramp* ramp = op->index.as<Ramp>();
+      if (ramp && is_one(ramp->stride)) {
+        int alignment, native_bits;
+        GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+        llvm::Value* ptr = CreateBufferPtr(
+            t.element_of(), buffer, MakeValue(ramp->base));
+        ptr = builder_->CreatePointerCast(ptr, LLVMType(t)->getPointerTo(addrspace));
+        llvm::CallInst* load = builder_->CreateMaskedLoad(ptr, alignment, mask, passthru);
+        AddAliasInfo(load, op->buffer_var.get(), op->index, t);
+        return load;
+      }
+      llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, index);
+      llvm::CallInst* load = builder_->CreateMaskedGather(
+          ptrs, t.bits() / 8, mask, passthru);
+      AddAliasInfo(load, op->buffer_var.get(), Expr(), t);
+      return load;
+    }
     if (const Ramp* ramp = op->index.as<Ramp>()) {
       if (is_one(ramp->stride)) {
         int alignment, native_bits;
@@ -951,7 +972,6 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Broadcast* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const Store* op) {
-  CHECK(is_one(op->predicate));
   Type t = op->value.type();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -959,6 +979,7 @@ void CodeGenLLVM::VisitStmt_(const Store* op) {
   llvm::Value* value = MakeValue(op->value);
 
   if (t.lanes() == 1) {
+    CHECK(is_one(op->predicate));
     int alignment, native_bits;
     GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
     llvm::Value* ptr = CreateBufferPtr(t, buffer, index);
@@ -969,6 +990,26 @@ void CodeGenLLVM::VisitStmt_(const Store* op) {
     // vector store
     unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(
         buffer->getType())->getAddressSpace();
+    if (!is_one(op->predicate)) {
+      // masked store, the masked lanes are left untouched.
+      llvm::Value* mask = MakeValue(op->predicate);
+      const Ramp* ramp = op->index.as<Ramp>();
+      if (ramp && is_one(ramp->stride)) {
+        int alignment, native_bits;
+        GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+        llvm::Value* ptr = CreateBufferPtr(
+            t.element_of(), buffer, MakeValue(ramp->base));
+        ptr = builder_->CreatePointerCast(ptr, LLVMType(t)->getPointerTo(addrspace));
+        llvm::CallInst* store = builder_->CreateMaskedStore(value, ptr, alignment, mask);
+        AddAliasInfo(store, op->buffer_var.get(), op->index, op->value.type());
+        return;
+      }
+      llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, index);
+      llvm::CallInst* store = builder_->CreateMaskedScatter(
+          value, ptrs, t.bits() / 8, mask);
+      AddAliasInfo(store, op->buffer_var.get(), Expr(), op->value.type());
+      return;
+    }
     if (const Ramp* ramp = op->index.as<Ramp>()) {
       if (is_one(ramp->stride)) {
         int alignment, native_bits;
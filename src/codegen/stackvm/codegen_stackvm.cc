@@ -136,12 +136,20 @@ void CodeGenStackVM::VisitExpr_(const Call* op) {
   } else if (op->is_intrinsic(intrinsic::tvm_struct_get)) {
     CHECK_EQ(op->args.size(), 3U);
     int kind = op->args[2].as<IntImm>()->value;
-    this->Push(op->args[0]);
     const IntImm* index = op->args[1].as<IntImm>();
     CHECK(index != nullptr);
     StackVM::Code code;
-    code.op_code = StackVM::TVM_STRUCT_GET;
-    vm_.code.push_back(code);
+    if (const Variable* v = op->args[0].as<Variable>()) {
+      // fuse the load of the struct handle.
+      code.op_code = StackVM::LOAD_HEAP_STRUCT_GET;
+      vm_.code.push_back(code);
+      code.v_int = GetVarID(v);
+      vm_.code.push_back(code);
+    } else {
+      this->Push(op->args[0]);
+      code.op_code = StackVM::TVM_STRUCT_GET;
+      vm_.code.push_back(code);
+    }
     code.v_int = index->value;
     vm_.code.push_back(code);
     code.v_int = kind;
@@ -150,8 +158,13 @@ void CodeGenStackVM::VisitExpr_(const Call* op) {
     CHECK_GE(op->args.size(), 5U);
     const StringImm* s = op->args[0].as<StringImm>();
     CHECK(s != nullptr) << "tvm_call_global expect first argument as function name";
-    this->Push(op->args[1]);
-    this->Push(op->args[2]);
+    const Variable* value_stack = op->args[1].as<Variable>();
+    const Variable* type_stack = op->args[2].as<Variable>();
+    bool fuse_load = value_stack != nullptr && type_stack != nullptr;
+    if (!fuse_load) {
+      this->Push(op->args[1]);
+      this->Push(op->args[2]);
+    }
     int begin = op->args[3].as<IntImm>()->value;
     int end = op->args[4].as<IntImm>()->value;
     // find the fuction id.
@@ -167,8 +180,18 @@ void CodeGenStackVM::VisitExpr_(const Call* op) {
     }
     // CALL_PACKED_FUNC
     StackVM::Code code;
-    code.op_code = StackVM::CALL_PACKED_LOWERED;
-    vm_.code.push_back(code);
+    if (fuse_load) {
+      // the argument stacks are usually stored in heap by LetStmt.
+      code.op_code = StackVM::CALL_PACKED_HEAP;
+      vm_.code.push_back(code);
+      code.v_int = GetVarID(value_stack);
+      vm_.code.push_back(code);
+      code.v_int = GetVarID(type_stack);
+      vm_.code.push_back(code);
+    } else {
+      code.op_code = StackVM::CALL_PACKED_LOWERED;
+      vm_.code.push_back(code);
+    }
     code.v_int = fid;
     vm_.code.push_back(code);
     code.v_int = begin;
@@ -360,6 +383,7 @@ void CodeGenStackVM::VisitExpr_(const Or *op) {
   this->Push(op->a);
   int64_t pc_jump = this->GetPC();
   int64_t opr_index = this->PushOp(StackVM::RJUMP_IF_TRUE, 0);
+  this->PushOp(StackVM::POP);
   this->Push(op->b);
   int64_t diff = this->GetPC() - pc_jump;
   this->SetOperand(opr_index, diff);
@@ -12,7 +12,10 @@
 #include <tvm/runtime/packed_func.h>
 #include <dmlc/json.h>
 #include <dmlc/memory_io.h>
+#include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 #include "../common/base64.h"
 
 namespace dmlc {
@@ -427,6 +430,432 @@ NodePtr<Node> LoadJSON_(std::string json_str) {
   return nodes.at(jgraph.root);
 }
 
+/*! \brief Magic number of the binary node format */
+constexpr uint64_t kTVMNodeBinaryMagic = 0x9A1C7E3B5D0F2468;
+/*! \brief Version of the binary node format */
+constexpr uint64_t kTVMNodeBinaryVersion = 1;
+/*! \brief Alignment of the tensor payloads in the binary format */
+constexpr size_t kTVMNodeBinaryAlign = 64;
+
+// Writer of the binary node format.
+//
+// Integers are stored as LEB128 varints, signed ones zigzag encoded.
+// Doubles and tensor payloads are stored raw in little endian.
+class BinaryWriter {
+ public:
+  std::string* buf_;
+
+  explicit BinaryWriter(std::string* buf) : buf_(buf) {}
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buf_->push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buf_->push_back(static_cast<char>(value));
+  }
+  void WriteSigned(int64_t value) {
+    WriteVarint((static_cast<uint64_t>(value) << 1) ^
+                static_cast<uint64_t>(value >> 63));
+  }
+  void WriteString(const std::string& value) {
+    WriteVarint(value.length());
+    buf_->append(value);
+  }
+  template<typename T>
+  void WriteRaw(T value) {
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(&value, sizeof(T), 1);
+    }
+    buf_->append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  // pad the buffer so that the next write is aligned
+  void Align(size_t alignment) {
+    size_t rem = buf_->length() % alignment;
+    if (rem != 0) buf_->append(alignment - rem, '\0');
+  }
+};
+
+// Reader of the binary node format, over a contiguous buffer.
+class BinaryReader {
+ public:
+  const char* data_;
+  size_t size_;
+  size_t pos_{0};
+
+  BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; ; shift += 7) {
+      CHECK_LT(pos_, size_) << "BinaryReader: unexpected end of data";
+      CHECK_LT(shift, 64) << "BinaryReader: varint overflow";
+      uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+  }
+  int64_t ReadSigned() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  std::string ReadString() {
+    size_t begin = Skip(ReadVarint());
+    return std::string(data_ + begin, data_ + pos_);
+  }
+  template<typename T>
+  T ReadRaw() {
+    T value;
+    std::memcpy(&value, data_ + Skip(sizeof(T)), sizeof(T));
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(&value, sizeof(T), 1);
+    }
+    return value;
+  }
+  void Align(size_t alignment) {
+    size_t rem = pos_ % alignment;
+    if (rem != 0) Skip(alignment - rem);
+  }
+  // skip nbytes and return the position before skipping
+  size_t Skip(uint64_t nbytes) {
+    CHECK_LE(nbytes, size_ - pos_) << "BinaryReader: unexpected end of data";
+    size_t begin = pos_;
+    pos_ += static_cast<size_t>(nbytes);
+    return begin;
+  }
+};
+
+class BinaryAttrGetter : public AttrVisitor {
+ public:
+  const std::unordered_map<Node*, size_t>* node_index_;
+  const std::unordered_map<DLTensor*, size_t>* tensor_index_;
+  BinaryWriter* writer_;
+
+  void Visit(const char* key, double* value) final {
+    writer_->WriteRaw(*value);
+  }
+  void Visit(const char* key, int64_t* value) final {
+    writer_->WriteSigned(*value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    writer_->WriteVarint(*value);
+  }
+  void Visit(const char* key, int* value) final {
+    writer_->WriteSigned(*value);
+  }
+  void Visit(const char* key, bool* value) final {
+    writer_->WriteVarint(*value);
+  }
+  void Visit(const char* key, std::string* value) final {
+    writer_->WriteString(*value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, Type* value) final {
+    writer_->WriteVarint(value->code());
+    writer_->WriteVarint(value->bits());
+    writer_->WriteVarint(value->lanes());
+  }
+  void Visit(const char* key, NodeRef* value) final {
+    writer_->WriteVarint(node_index_->at(value->node_.get()));
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    writer_->WriteVarint(
+        tensor_index_->at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  // Write the content of a normal node
+  void Get(Node* node) {
+    if (node->is_type<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& sp : n->data) {
+        writer_->WriteVarint(node_index_->at(sp.get()));
+      }
+    } else if (node->is_type<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& kv : n->data) {
+        writer_->WriteVarint(node_index_->at(kv.first.get()));
+        writer_->WriteVarint(node_index_->at(kv.second.get()));
+      }
+    } else if (node->is_type<StrMapNode>()) {
+      StrMapNode* n = static_cast<StrMapNode*>(node);
+      writer_->WriteVarint(n->data.size());
+      for (const auto& kv : n->data) {
+        writer_->WriteString(kv.first);
+        writer_->WriteVarint(node_index_->at(kv.second.get()));
+      }
+    } else {
+      node->VisitAttrs(this);
+    }
+  }
+};
+
+class BinaryAttrSetter : public AttrVisitor {
+ public:
+  const std::vector<NodePtr<Node> >* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  BinaryReader* reader_;
+
+  void Visit(const char* key, double* value) final {
+    *value = reader_->ReadRaw<double>();
+  }
+  void Visit(const char* key, int64_t* value) final {
+    *value = reader_->ReadSigned();
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    *value = reader_->ReadVarint();
+  }
+  void Visit(const char* key, int* value) final {
+    *value = static_cast<int>(reader_->ReadSigned());
+  }
+  void Visit(const char* key, bool* value) final {
+    *value = reader_->ReadVarint() != 0;
+  }
+  void Visit(const char* key, std::string* value) final {
+    *value = reader_->ReadString();
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, Type* value) final {
+    int code = static_cast<int>(reader_->ReadVarint());
+    int bits = static_cast<int>(reader_->ReadVarint());
+    int lanes = static_cast<int>(reader_->ReadVarint());
+    *value = Type(static_cast<halideir_type_code_t>(code), bits, lanes);
+  }
+  void Visit(const char* key, NodeRef* value) final {
+    value->node_ = GetNode();
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    size_t index = reader_->ReadVarint();
+    CHECK_LT(index, tensor_list_->size());
+    *value = tensor_list_->at(index);
+  }
+  NodePtr<Node> GetNode() {
+    size_t index = reader_->ReadVarint();
+    CHECK_LT(index, node_list_->size());
+    return node_list_->at(index);
+  }
+  // Read the content of a normal node
+  void Set(Node* node) {
+    if (node->is_type<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      size_t size = reader_->ReadVarint();
+      n->data.clear();
+      for (size_t i = 0; i < size; ++i) {
+        n->data.push_back(GetNode());
+      }
+    } else if (node->is_type<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      size_t size = reader_->ReadVarint();
+      for (size_t i = 0; i < size; ++i) {
+        NodePtr<Node> k = GetNode();
+        n->data[k] = GetNode();
+      }
+    } else if (node->is_type<StrMapNode>()) {
+      StrMapNode* n = static_cast<StrMapNode*>(node);
+      size_t size = reader_->ReadVarint();
+      for (size_t i = 0; i < size; ++i) {
+        std::string k = reader_->ReadString();
+        n->data[k] = GetNode();
+      }
+    } else {
+      node->VisitAttrs(this);
+    }
+  }
+};
+
+// Binary layout:
+//
+//   magic, version       raw uint64
+//   tvm_version          string
+//   type keys            count, strings
+//   node table           count, then per node:
+//                          type key index + 1 (0 is null),
+//                          global key or byte size and content
+//   root                 node index
+//   tensors              count, then per tensor:
+//                          dtype, shape, byte size,
+//                          padding to 64 bytes, raw data
+//
+// Fields are written in the order of VisitAttrs, so the format
+// relies on the reflection of the same TVM version, which is
+// checked on load.
+std::string SaveBinary(const NodeRef& root) {
+  NodeIndexer indexer;
+  indexer.MakeIndex(root.node_.get());
+
+  std::string blob;
+  BinaryWriter writer(&blob);
+  writer.WriteRaw(kTVMNodeBinaryMagic);
+  writer.WriteRaw(kTVMNodeBinaryVersion);
+  writer.WriteString(TVM_VERSION);
+  // type key table
+  std::unordered_map<std::string, size_t> type_index;
+  std::vector<std::string> type_keys;
+  for (Node* n : indexer.node_list) {
+    if (n == nullptr) continue;
+    if (type_index.count(n->type_key())) continue;
+    type_index[n->type_key()] = type_keys.size();
+    type_keys.push_back(n->type_key());
+  }
+  writer.WriteVarint(type_keys.size());
+  for (const std::string& key : type_keys) {
+    writer.WriteString(key);
+  }
+  // node table
+  std::string content;
+  BinaryWriter content_writer(&content);
+  BinaryAttrGetter getter;
+  getter.node_index_ = &indexer.node_index;
+  getter.tensor_index_ = &indexer.tensor_index;
+  getter.writer_ = &content_writer;
+  writer.WriteVarint(indexer.node_list.size());
+  for (Node* n : indexer.node_list) {
+    if (n == nullptr) {
+      writer.WriteVarint(0);
+      continue;
+    }
+    writer.WriteVarint(type_index.at(n->type_key()) + 1);
+    auto* f = dmlc::Registry<NodeFactoryReg>::Find(n->type_key());
+    CHECK(f != nullptr)
+        << "Node type \'" << n->type_key() << "\' is not registered in TVM";
+    // global object only need its key
+    if (f->fglobal_key != nullptr) {
+      writer.WriteString(f->fglobal_key(n));
+      continue;
+    }
+    content.clear();
+    getter.Get(n);
+    writer.WriteString(content);
+  }
+  writer.WriteVarint(indexer.node_index.at(root.node_.get()));
+  // tensors
+  writer.WriteVarint(indexer.tensor_list.size());
+  for (DLTensor* tensor : indexer.tensor_list) {
+    writer.WriteVarint(tensor->dtype.code);
+    writer.WriteVarint(tensor->dtype.bits);
+    writer.WriteVarint(tensor->dtype.lanes);
+    writer.WriteVarint(tensor->ndim);
+    int64_t num_elems = 1;
+    for (int i = 0; i < tensor->ndim; ++i) {
+      writer.WriteSigned(tensor->shape[i]);
+      num_elems *= tensor->shape[i];
+    }
+    int type_bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+    size_t data_byte_size = static_cast<size_t>(type_bytes * num_elems);
+    writer.WriteVarint(data_byte_size);
+    writer.Align(kTVMNodeBinaryAlign);
+    size_t offset = blob.length();
+    blob.resize(offset + data_byte_size);
+    char* dst = &blob[0] + offset;
+    if (tensor->ctx.device_type == kDLCPU &&
+        tensor->strides == nullptr &&
+        tensor->byte_offset == 0) {
+      std::memcpy(dst, tensor->data, data_byte_size);
+    } else {
+      CHECK_EQ(TVMArrayCopyToBytes(tensor, dst, data_byte_size), 0)
+          << TVMGetLastError();
+    }
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(dst, type_bytes, num_elems);
+    }
+  }
+  return blob;
+}
+
+NodePtr<Node> LoadBinary_(const char* data, size_t size) {
+  BinaryReader reader(data, size);
+  CHECK(size >= sizeof(uint64_t) &&
+        reader.ReadRaw<uint64_t>() == kTVMNodeBinaryMagic)
+      << "Invalid binary node format";
+  uint64_t version = reader.ReadRaw<uint64_t>();
+  CHECK_EQ(version, kTVMNodeBinaryVersion)
+      << "Unsupported binary node format version " << version;
+  std::string tvm_version = reader.ReadString();
+  CHECK_EQ(tvm_version, TVM_VERSION)
+      << "Binary node format saved by TVM " << tvm_version
+      << " cannot be loaded by TVM " << TVM_VERSION;
+  // type key table
+  std::vector<NodeFactoryReg*> factories(reader.ReadVarint());
+  for (size_t i = 0; i < factories.size(); ++i) {
+    std::string type_key = reader.ReadString();
+    factories[i] = dmlc::Registry<NodeFactoryReg>::Find(type_key);
+    CHECK(factories[i] != nullptr)
+        << "Node type \'" << type_key << "\' is not registered in TVM";
+  }
+  // create all the nodes first, their content can refer to later nodes.
+  size_t num_nodes = reader.ReadVarint();
+  std::vector<NodePtr<Node> > nodes;
+  // position and size of the content of each node, 0 for global objects
+  std::vector<std::pair<size_t, size_t> > contents;
+  nodes.reserve(num_nodes);
+  contents.reserve(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    size_t type = reader.ReadVarint();
+    if (type == 0) {
+      nodes.emplace_back(NodePtr<Node>());
+      contents.emplace_back(0, 0);
+      continue;
+    }
+    CHECK_LE(type, factories.size());
+    NodeFactoryReg* f = factories[type - 1];
+    if (f->fglobal_key != nullptr) {
+      nodes.emplace_back(f->fcreator(reader.ReadString()));
+      contents.emplace_back(0, 0);
+    } else {
+      size_t nbytes = reader.ReadVarint();
+      nodes.emplace_back(f->fcreator(std::string()));
+      contents.emplace_back(reader.Skip(nbytes), nbytes);
+    }
+  }
+  size_t root = reader.ReadVarint();
+  CHECK_LT(root, nodes.size());
+  // tensors
+  std::vector<runtime::NDArray> tensors(reader.ReadVarint());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    DLDataType dtype;
+    dtype.code = static_cast<uint8_t>(reader.ReadVarint());
+    dtype.bits = static_cast<uint8_t>(reader.ReadVarint());
+    dtype.lanes = static_cast<uint16_t>(reader.ReadVarint());
+    std::vector<int64_t> shape(reader.ReadVarint());
+    int64_t num_elems = 1;
+    for (size_t k = 0; k < shape.size(); ++k) {
+      shape[k] = reader.ReadSigned();
+      num_elems *= shape[k];
+    }
+    int type_bytes = (dtype.bits * dtype.lanes + 7) / 8;
+    size_t data_byte_size = reader.ReadVarint();
+    CHECK_EQ(data_byte_size, static_cast<size_t>(type_bytes * num_elems))
+        << "Invalid binary node format";
+    reader.Align(kTVMNodeBinaryAlign);
+    const char* src = data + reader.Skip(data_byte_size);
+    DLContext cpu_ctx;
+    cpu_ctx.device_type = kDLCPU;
+    cpu_ctx.device_id = 0;
+    tensors[i] = runtime::NDArray::Empty(shape, dtype, cpu_ctx);
+    std::memcpy(tensors[i]->data, src, data_byte_size);
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(tensors[i]->data, type_bytes, num_elems);
+    }
+  }
+  // fill in the content of the nodes
+  BinaryAttrSetter setter;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (contents[i].second == 0) continue;
+    BinaryReader content_reader(data + contents[i].first, contents[i].second);
+    setter.reader_ = &content_reader;
+    setter.Set(nodes[i].get());
+    CHECK_EQ(content_reader.pos_, content_reader.size_)
+        << "Invalid content of node type \'" << nodes[i]->type_key() << "\'";
+  }
+  return nodes.at(root);
+}
+
 class NodeAttrSetter : public AttrVisitor {
  public:
   std::string type_key;
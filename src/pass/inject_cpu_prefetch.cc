@@ -0,0 +1,156 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file inject_cpu_prefetch.cc
+ * \brief Prefetch the loads that stream through memory in the innermost loops.
+ *
+ *  A load whose flattened index advances by a constant stride with the loop
+ *  variable touches a new cache line every few iterations. The pass prefetches
+ *  the address the load reaches distance bytes ahead, once per cache line.
+ */
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_visitor.h>
+#include <tvm/ir_pass.h>
+#include <tvm/arithmetic.h>
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+#include "ir_util.h"
+
+namespace tvm {
+namespace ir {
+
+// A stream of loads buffer[stride * loop_var + base].
+struct LoadStream {
+  Var buffer_var;
+  Type type;
+  int64_t stride;
+  Expr base;
+};
+
+// Collect the load streams of a loop body.
+class LoadStreamCollector : public IRVisitor {
+ public:
+  explicit LoadStreamCollector(Var loop_var) : loop_var_(loop_var) {}
+
+  void Visit_(const For* op) final {
+    has_loop = true;
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const LetStmt* op) final {
+    defined_.insert(op->var.get());
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Let* op) final {
+    defined_.insert(op->var.get());
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Allocate* op) final {
+    defined_.insert(op->buffer_var.get());
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Load* op) final {
+    IRVisitor::Visit_(op);
+    Expr index = op->index;
+    if (const Ramp* ramp = index.as<Ramp>()) {
+      index = ramp->base;
+    }
+    Array<Expr> coeff = arith::DetectLinearEquation(index, {loop_var_});
+    if (coeff.size() != 2) return;
+    const int64_t* stride = as_const_int(coeff[0]);
+    if (stride == nullptr || *stride == 0) return;
+    for (const LoadStream& s : loads_) {
+      // loads of a buffer at the same stride share the cache lines.
+      if (s.buffer_var.same_as(op->buffer_var) && s.stride == *stride) return;
+    }
+    loads_.push_back(LoadStream{op->buffer_var, op->type.element_of(), *stride, coeff[1]});
+  }
+
+  // The streams that are addressable at the beginning of the body.
+  std::vector<LoadStream> Streams() const {
+    std::vector<LoadStream> ret;
+    for (const LoadStream& s : loads_) {
+      if (defined_.count(s.buffer_var.get()) || ExprUseVar(s.base, defined_)) continue;
+      ret.push_back(s);
+    }
+    return ret;
+  }
+
+  bool has_loop{false};
+
+ private:
+  Var loop_var_;
+  std::vector<LoadStream> loads_;
+  std::unordered_set<const Variable*> defined_;
+};
+
+class CPUPrefetchInjector : public IRMutator {
+ public:
+  explicit CPUPrefetchInjector(int distance) : distance_(distance) {}
+
+  Stmt Mutate_(const AttrStmt* op, const Stmt& s) final {
+    // kernels of the gpu targets
+    if (op->attr_key == attr::thread_extent) return s;
+    return IRMutator::Mutate_(op, s);
+  }
+
+  Stmt Mutate_(const For* op, const Stmt& s) final {
+    LoadStreamCollector collector(op->loop_var);
+    collector.Visit(op->body);
+    if (collector.has_loop) {
+      return IRMutator::Mutate_(op, s);
+    }
+    const int64_t* extent = as_const_int(op->extent);
+    std::vector<Stmt> prefetches;
+    for (const LoadStream& stream : collector.Streams()) {
+      if (prefetches.size() == kMaxStreams) break;
+      int64_t stride_bytes = std::abs(stream.stride) * stream.type.bytes();
+      // the loop touches less than a cache line.
+      if (extent != nullptr && *extent * stride_bytes < kCacheLineBytes) continue;
+      int64_t ahead = (distance_ + stride_bytes - 1) / stride_bytes;
+      Expr index = make_const(stream.base.type(), stream.stride) *
+          (op->loop_var + make_const(op->loop_var.type(), ahead)) + stream.base;
+      Expr load = Load::make(stream.type, stream.buffer_var, Simplify(index),
+                             const_true(stream.type.lanes()));
+      Expr address = Call::make(Handle(), intrinsic::tvm_address_of, {load},
+                                Call::PureIntrinsic);
+      // read, high locality, data cache.
+      Stmt prefetch = Evaluate::make(
+          Call::make(Int(32), Call::prefetch, {address, 0, 3, 1}, Call::Intrinsic));
+      // the iterations that share a cache line, rounded down to a power of two.
+      int64_t interval = 1;
+      while (interval * 2 * stride_bytes <= kCacheLineBytes) interval *= 2;
+      if (interval > 1) {
+        Expr iter = Simplify(op->loop_var - op->min);
+        prefetch = IfThenElse::make(
+            Mod::make(iter, make_const(iter.type(), interval)) == make_zero(iter.type()),
+            prefetch);
+      }
+      prefetches.push_back(prefetch);
+    }
+    if (prefetches.empty()) return s;
+    prefetches.push_back(op->body);
+    return For::make(op->loop_var, op->min, op->extent, op->for_type, op->device_api,
+                     MergeSeq(prefetches));
+  }
+
+ private:
+  /*! \brief The bytes of a cache line. */
+  static constexpr int64_t kCacheLineBytes = 64;
+  /*! \brief The maximum number of streams prefetched by a loop. */
+  static constexpr size_t kMaxStreams = 4;
+  // prefetch distance in bytes.
+  int distance_;
+};
+
+Stmt InjectCPUPrefetch(Stmt stmt, int distance) {
+  if (distance <= 0) return stmt;
+  return CPUPrefetchInjector(distance).Mutate(stmt);
+}
+
+}  // namespace ir
+}  // namespace tvm
@@ -4,6 +4,9 @@
  */
 #include <tvm/ir_pass.h>
 #include <tvm/ir_functor_ext.h>
+#include <unordered_map>
+#include <unordered_set>
+#include "lower_pipeline.h"
 
 namespace tvm {
 namespace ir {
@@ -41,6 +44,17 @@ class IRDeepCompare :
     return order_;
   }
 
+  // Equality up to a one to one renaming of all the variables.
+  bool EqualRename(const Stmt& lhs, const Stmt& rhs,
+                   std::unordered_map<const Variable*, const Variable*>* vmap) {
+    tie_def_ = true;
+    rename_ = true;
+    VisitStmt(lhs, rhs);
+    if (order_ != 0) return false;
+    *vmap = std::move(vmap_);
+    return true;
+  }
+
   void VisitExpr(const Expr& n, const Expr& other) override {
     if (order_ != 0) return;
     if (n.same_as(other)) return;
@@ -60,7 +74,7 @@ class IRDeepCompare :
     const LetStmt* rhs = other.as<LetStmt>();
     if (CompareExpr(op->value, rhs->value) != 0) return;
     if (tie_def_) {
-      vmap_[op->var.get()] = rhs->var.get();
+      TieVar(op->var.get(), rhs->var.get());
     } else {
       if (CompareExpr(op->var, rhs->var) != 0) return;
     }
@@ -87,7 +101,7 @@ class IRDeepCompare :
     if (CompareExpr(op->min, rhs->min) != 0) return;
     if (CompareExpr(op->extent, rhs->extent) != 0) return;
     if (tie_def_) {
-      vmap_[op->loop_var.get()] = rhs->loop_var.get();
+      TieVar(op->loop_var.get(), rhs->loop_var.get());
     } else {
       if (CompareExpr(op->loop_var, rhs->loop_var) != 0) return;
     }
@@ -97,7 +111,7 @@ class IRDeepCompare :
   void VisitStmt_(const Allocate* op, const Stmt& other) final {
     const Allocate* rhs = other.as<Allocate>();
     if (tie_def_) {
-      vmap_[op->buffer_var.get()] = rhs->buffer_var.get();
+      TieVar(op->buffer_var.get(), rhs->buffer_var.get());
     } else {
       if (CompareExpr(op->buffer_var, rhs->buffer_var) != 0) return;
     }
@@ -176,7 +190,12 @@ class IRDeepCompare :
   void VisitExpr_(const Variable* op, const Expr& other) final {
     const Variable* rhs = other.as<Variable>();
     auto it = vmap_.find(op);
-    if (it != vmap_.end()) op = it->second;
+    if (it != vmap_.end()) {
+      op = it->second;
+    } else if (rename_) {
+      TieVar(op, rhs);
+      return;
+    }
     if (op < rhs) {
       order_ = -1;
     } else if (op > rhs) {
@@ -193,7 +212,7 @@ class IRDeepCompare :
   void VisitExpr_(const Let* op, const Expr& other) final {
     const Let* rhs = other.as<Let>();
     if (tie_def_) {
-      vmap_[op->var.get()] = rhs->var.get();
+      TieVar(op->var.get(), rhs->var.get());
     } else {
       if (CompareExpr(op->var, rhs->var) != 0) return;
     }
@@ -219,7 +238,7 @@ class IRDeepCompare :
       if (CompareExpr(op->axis[i]->dom->min, rhs->axis[i]->dom->min) != 0) return;
       if (CompareExpr(op->axis[i]->dom->extent, rhs->axis[i]->dom->extent) != 0) return;
       if (tie_def_) {
-        vmap_[op->axis[i]->var.get()] = rhs->axis[i]->var.get();
+        TieVar(op->axis[i]->var.get(), rhs->axis[i]->var.get());
       } else {
         if (CompareExpr(op->axis[i]->var, rhs->axis[i]->var) != 0) return;
       }
@@ -341,6 +360,9 @@ class IRDeepCompare :
 
   int CompareNodeRef(const NodeRef& lhs, const NodeRef& rhs) {
     if (order_ != 0) return order_;
+    if (rename_ && lhs.as<Variable>() && rhs.as<Variable>()) {
+      return CompareExpr(Expr(lhs.node_), Expr(rhs.node_));
+    }
     if (lhs.get() < rhs.get()) {
       order_ = -1; return order_;
     }
@@ -408,8 +430,30 @@ class IRDeepCompare :
   // However, the comparison is no longer in total order.
   // Only equality/non-equality information is valid.
   bool tie_def_{false};
+  // Whether free variables can also be renamed.
+  bool rename_{false};
   // varaible remap if any
   std::unordered_map<const Variable*, const Variable*> vmap_;
+  // the variables on the rhs that are already mapped, only used by rename.
+  std::unordered_set<const Variable*> mapped_;
+
+  void TieVar(const Variable* lhs, const Variable* rhs) {
+    if (!rename_) {
+      vmap_[lhs] = rhs;
+      return;
+    }
+    // keep the renaming one to one.
+    auto it = vmap_.find(lhs);
+    if (it != vmap_.end()) {
+      if (it->second != rhs) order_ = -1;
+      return;
+    }
+    if (!mapped_.insert(rhs).second) {
+      order_ = -1;
+      return;
+    }
+    vmap_[lhs] = rhs;
+  }
 };
 
 
@@ -438,5 +482,10 @@ int Compare(const Expr& lhs, const Expr& rhs) {
   return IRDeepCompare().Compare(lhs, rhs);
 }
 
+bool EqualRename(const Stmt& lhs, const Stmt& rhs,
+                 std::unordered_map<const Variable*, const Variable*>* vmap) {
+  return IRDeepCompare().EqualRename(lhs, rhs, vmap);
+}
+
 }  // namespace ir
 }  // namespace tvm
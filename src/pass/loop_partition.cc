@@ -9,6 +9,7 @@
 #include <tvm/arithmetic.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "../arithmetic/int_set_internal.h"
 #include "../runtime/thread_storage_scope.h"
 
@@ -166,13 +167,18 @@ class PartitionFinder : public IRVisitor {
 
   void Visit_(const Call* op) {
     if (op->is_intrinsic(Call::likely)) {
-      Expr cond = op->args[0];
-      if (ExprUseVars(cond,
-          std::unordered_set<const Variable*>({current_var_.get()}))) {
-        IntSet interval =
-          DeduceBound(current_var_, cond, hint_map_, relax_map_);
-        if (!interval.is_nothing()) {
-          partitions[cond.get()] = Partition{cond, interval};
+      // each conjunct of the condition is a partition on its own,
+      // so the ones on the current var can be eliminated separately.
+      std::vector<Expr> conds;
+      SplitConjuncts(op->args[0], &conds);
+      for (const Expr& cond : conds) {
+        if (ExprUseVars(cond,
+            std::unordered_set<const Variable*>({current_var_.get()}))) {
+          IntSet interval =
+            DeduceBound(current_var_, cond, hint_map_, relax_map_);
+          if (!interval.is_nothing()) {
+            partitions[cond.get()] = Partition{cond, interval};
+          }
         }
       }
     } else {
@@ -183,6 +189,15 @@ class PartitionFinder : public IRVisitor {
   std::unordered_map<const Node*, Partition> partitions;
 
  private:
+  static void SplitConjuncts(const Expr& cond, std::vector<Expr>* conds) {
+    if (const And* op = cond.as<And>()) {
+      SplitConjuncts(op->a, conds);
+      SplitConjuncts(op->b, conds);
+    } else {
+      conds->push_back(cond);
+    }
+  }
+
   VarExpr current_var_;
   std::unordered_set<const Variable*> out_vars_;
   std::unordered_map<const Variable*, IntSet> hint_map_;
@@ -299,10 +314,20 @@ class LoopPartitioner : public IRMutator {
       Expr min, Expr max, Stmt body, bool partition_thread_scope);
   inline Stmt MakeFor(const Node* op, Expr extent, Stmt body);
 
+  /*!
+   * \brief The maximum number of edge loops of an outermost partitioned
+   *  loop nest, each of them is a copy of the body of the partitioned loop,
+   *  this bounds the code growth of the nest.
+   */
+  static constexpr int kMaxEdgeLoops = 32;
   /* Candidate IRs that may be partitioned potentially */
   std::unordered_map<const Variable*, IntSet> hint_map_;
   std::unordered_map<const Variable*, IntSet> relax_map_;
   CandidateSelector selector;
+  /*! \brief The number of edge loops generated in the current nest */
+  int num_edge_loops_{0};
+  /*! \brief The number of partitioned loops enclosing the current one */
+  int partition_depth_{0};
 };
 
 Stmt LoopPartitioner::TryPartition(const Node* node,
@@ -378,12 +403,23 @@ Stmt LoopPartitioner::TryPartition(const Node* node,
 
   Stmt s;
   if (!partition_thread_scope) {
+    int num_edges = pre_stmt.defined() + post_stmt.defined();
+    // each outermost partitioned loop starts a new budget.
+    if (partition_depth_ == 0) num_edge_loops_ = 0;
+    if (num_edge_loops_ + num_edges > kMaxEdgeLoops) {
+      // keep the checks in the loop rather than copying its body again.
+      return Stmt();
+    }
+    num_edge_loops_ += num_edges;
     // [body_begin, post_doubt_begin)
     Stmt simplified_body = ConditionEliminator(partitions).Mutate(body);
     Stmt new_body = Substitute(simplified_body, {{Var{var}, var + body_begin}});
     s = MakeFor(node, post_doubt_begin - body_begin, new_body);
 
-    if (!(pre_stmt.defined() && post_stmt.defined())) s = VisitAndMutate(s);
+    // the main body is free of the checks on var, partition the inner
+    // loops of it on their own conditions.
+    ++partition_depth_;
+    s = VisitAndMutate(s);
     if (pre_stmt.defined()) s = Block::make(pre_stmt, s);
     if (post_stmt.defined()) {
       if (as_const_int(max) && as_const_int(post_doubt_begin)) {
@@ -391,6 +427,7 @@ Stmt LoopPartitioner::TryPartition(const Node* node,
       }
       s = Block::make(s, post_stmt);
     }
+    --partition_depth_;
   } else {
     Expr cond = const_true();
     if (!can_prove(body_begin == min)) cond = cond && (var >= body_begin);
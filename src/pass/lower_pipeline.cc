@@ -0,0 +1,624 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file lower_pipeline.cc
+ * \brief Timing and memoization of the statement lowering passes.
+ */
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include <tvm/ir_visitor.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_operator.h>
+#include <tvm/api_registry.h>
+#include <dmlc/common.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "lower_pipeline.h"
+
+namespace tvm {
+namespace ir {
+
+// Hash the structure of the statement, variables are numbered
+// by the order of their first occurence.
+class StructuralHasher : public IRVisitor {
+ public:
+  size_t Hash(const Stmt& stmt) {
+    this->Visit(stmt);
+    return hash_;
+  }
+
+  void Visit(const NodeRef& node) final {
+    if (!node.defined()) {
+      Mix(0);
+      return;
+    }
+    Mix(node->type_index());
+    IRVisitor::Visit(node);
+  }
+
+  void Visit_(const Variable* op) final {
+    auto it = var_index_.find(op);
+    if (it == var_index_.end()) {
+      size_t index = var_index_.size();
+      var_index_[op] = index;
+      Mix(index);
+    } else {
+      Mix(it->second);
+    }
+    MixType(op->type);
+  }
+
+  void Visit_(const LetStmt* op) final {
+    this->Visit(op->var);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const AttrStmt* op) final {
+    MixString(op->attr_key);
+    if (op->node.as<Variable>()) {
+      this->Visit(op->node);
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const For* op) final {
+    this->Visit(op->loop_var);
+    Mix(static_cast<int>(op->for_type));
+    Mix(static_cast<int>(op->device_api));
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Allocate* op) final {
+    this->Visit(op->buffer_var);
+    MixType(op->type);
+    MixString(op->free_function);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Store* op) final {
+    this->Visit(op->buffer_var);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Free* op) final {
+    this->Visit(op->buffer_var);
+  }
+
+  void Visit_(const Load* op) final {
+    this->Visit(op->buffer_var);
+    MixType(op->type);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Let* op) final {
+    this->Visit(op->var);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Call* op) final {
+    MixString(op->name);
+    MixType(op->type);
+    Mix(static_cast<int>(op->call_type));
+    Mix(op->value_index);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Cast* op) final {
+    MixType(op->type);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Ramp* op) final {
+    Mix(op->lanes);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Broadcast* op) final {
+    Mix(op->lanes);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const IntImm* op) final {
+    Mix(std::hash<int64_t>()(op->value));
+    MixType(op->type);
+  }
+
+  void Visit_(const UIntImm* op) final {
+    Mix(std::hash<uint64_t>()(op->value));
+    MixType(op->type);
+  }
+
+  void Visit_(const FloatImm* op) final {
+    Mix(std::hash<double>()(op->value));
+    MixType(op->type);
+  }
+
+  void Visit_(const StringImm* op) final {
+    MixString(op->value);
+  }
+
+ private:
+  void Mix(size_t value) {
+    hash_ = dmlc::HashCombine(hash_, value);
+  }
+  void MixString(const std::string& value) {
+    Mix(std::hash<std::string>()(value));
+  }
+  void MixType(const Type& t) {
+    Mix(static_cast<size_t>(t.code()));
+    Mix(static_cast<size_t>(t.bits()));
+    Mix(static_cast<size_t>(t.lanes()));
+  }
+
+  size_t hash_{0};
+  std::unordered_map<const Variable*, size_t> var_index_;
+};
+
+size_t StructuralHash(const Stmt& stmt) {
+  return StructuralHasher().Hash(stmt);
+}
+
+// Whether the nest can be shared across functions:
+// it should only refer to other nodes through variables.
+class NestCacheChecker : public IRVisitor {
+ public:
+  bool Check(const Stmt& stmt) {
+    this->Visit(stmt);
+    return cacheable_;
+  }
+  void Visit(const NodeRef& node) final {
+    if (!cacheable_) return;
+    IRVisitor::Visit(node);
+  }
+  void Visit_(const AttrStmt* op) final {
+    if (op->node.defined() && !op->node.as<Variable>()) {
+      cacheable_ = false;
+      return;
+    }
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Call* op) final {
+    if (op->func.defined()) {
+      cacheable_ = false;
+      return;
+    }
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const ProducerConsumer* op) final {
+    cacheable_ = false;
+  }
+  void Visit_(const Provide* op) final {
+    cacheable_ = false;
+  }
+  void Visit_(const Realize* op) final {
+    cacheable_ = false;
+  }
+  void Visit_(const Prefetch* op) final {
+    cacheable_ = false;
+  }
+  void Visit_(const Reduce* op) final {
+    cacheable_ = false;
+  }
+
+ private:
+  bool cacheable_{true};
+};
+
+// Collect the variables referenced or defined in the statement.
+class VarCollector : public IRVisitor {
+ public:
+  void Visit(const NodeRef& node) final {
+    if (node.as<Variable>()) {
+      Record(VarExpr(node.node_), false);
+      return;
+    }
+    IRVisitor::Visit(node);
+  }
+  void Visit_(const LetStmt* op) final {
+    Record(op->var, true);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const AttrStmt* op) final {
+    if (op->node.as<Variable>()) {
+      Record(VarExpr(op->node.node_), false);
+    }
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const For* op) final {
+    Record(op->loop_var, true);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Allocate* op) final {
+    Record(op->buffer_var, true);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Store* op) final {
+    Record(op->buffer_var, false);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Free* op) final {
+    Record(op->buffer_var, false);
+  }
+  void Visit_(const Load* op) final {
+    Record(op->buffer_var, false);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Let* op) final {
+    Record(op->var, true);
+    IRVisitor::Visit_(op);
+  }
+  /*! \brief all the variables */
+  std::unordered_map<const Variable*, VarExpr> vars;
+  /*! \brief fresh copies of the defined variables */
+  std::unordered_map<const Variable*, VarExpr> fresh;
+
+ private:
+  void Record(const VarExpr& v, bool define) {
+    vars[v.get()] = v;
+    if (define && !fresh.count(v.get())) {
+      fresh[v.get()] = Variable::make(v.type(), v->name_hint);
+    }
+  }
+};
+
+// Replace variables in all the places they can appear,
+// including the definitions and buffer references.
+class VarRemapper : public IRMutator {
+ public:
+  explicit VarRemapper(const std::unordered_map<const Variable*, VarExpr>& vmap)
+      : vmap_(vmap) {}
+
+  Expr Mutate_(const Variable* op, const Expr& e) final {
+    auto it = vmap_.find(op);
+    if (it != vmap_.end()) return it->second;
+    return e;
+  }
+  Expr Mutate_(const Load* op, const Expr& e) final {
+    Expr expr = IRMutator::Mutate_(op, e);
+    op = expr.as<Load>();
+    return Load::make(op->type, Remap(op->buffer_var), op->index, op->predicate);
+  }
+  Expr Mutate_(const Let* op, const Expr& e) final {
+    Expr expr = IRMutator::Mutate_(op, e);
+    op = expr.as<Let>();
+    return Let::make(Remap(op->var), op->value, op->body);
+  }
+  Stmt Mutate_(const Store* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<Store>();
+    return Store::make(Remap(op->buffer_var), op->value, op->index, op->predicate);
+  }
+  Stmt Mutate_(const Free* op, const Stmt& s) final {
+    return Free::make(Remap(op->buffer_var));
+  }
+  Stmt Mutate_(const LetStmt* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<LetStmt>();
+    return LetStmt::make(Remap(op->var), op->value, op->body);
+  }
+  Stmt Mutate_(const For* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<For>();
+    return For::make(Remap(op->loop_var), op->min, op->extent,
+                     op->for_type, op->device_api, op->body);
+  }
+  Stmt Mutate_(const Allocate* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<Allocate>();
+    return Allocate::make(Remap(op->buffer_var), op->type, op->extents,
+                          op->condition, op->body, op->new_expr, op->free_function);
+  }
+  Stmt Mutate_(const AttrStmt* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<AttrStmt>();
+    if (const Variable* v = op->node.as<Variable>()) {
+      auto it = vmap_.find(v);
+      if (it != vmap_.end()) {
+        return AttrStmt::make(it->second, op->attr_key, op->value, op->body);
+      }
+    }
+    return stmt;
+  }
+
+ private:
+  VarExpr Remap(const VarExpr& v) {
+    auto it = vmap_.find(v.get());
+    if (it != vmap_.end()) return it->second;
+    return v;
+  }
+
+  const std::unordered_map<const Variable*, VarExpr>& vmap_;
+};
+
+// name of the placeholder call of a nest.
+constexpr const char* kNestPlaceholder = "tvm_lower_pipeline_nest";
+
+// Split the statement into the spine and independent nests.
+// The spine is the sequence of blocks, allocations and scope attributes
+// that encloses the loop nests. Each nest is replaced by a placeholder
+// call, so that passes can still be applied on the spine.
+class NestSplitter : public IRMutator {
+ public:
+  Stmt Mutate(Stmt stmt) final {
+    if (IsSpine(stmt)) return IRMutator::Mutate(stmt);
+    Expr index = make_const(Int(32), static_cast<int64_t>(nests.size()));
+    nests.push_back(stmt);
+    return Evaluate::make(
+        Call::make(Int(32), kNestPlaceholder, {index}, Call::Extern));
+  }
+
+  std::vector<Stmt> nests;
+
+ private:
+  static bool IsSpine(const Stmt& stmt) {
+    if (stmt.as<Block>() || stmt.as<ProducerConsumer>() || stmt.as<Allocate>()) {
+      return true;
+    }
+    if (const AttrStmt* op = stmt.as<AttrStmt>()) {
+      return !op->node.defined() || op->node.as<Variable>();
+    }
+    return false;
+  }
+};
+
+// Put the nests back into the placeholders.
+class NestMerger : public IRMutator {
+ public:
+  explicit NestMerger(const std::vector<Stmt>& nests)
+      : nests_(nests) {}
+
+  Stmt Mutate_(const Evaluate* op, const Stmt& s) final {
+    const Call* call = op->value.as<Call>();
+    if (call && call->name == kNestPlaceholder) {
+      const int64_t* index = as_const_int(call->args[0]);
+      CHECK(index != nullptr);
+      return nests_[*index];
+    }
+    return s;
+  }
+
+ private:
+  const std::vector<Stmt>& nests_;
+};
+
+/*! \brief The statistics of a pass */
+struct PassStat {
+  /*! \brief number of times the pass was called */
+  int64_t num_calls{0};
+  /*! \brief total time in seconds */
+  double total_time{0};
+  /*! \brief number of nests found in cache */
+  int64_t nest_hit{0};
+  /*! \brief number of nests lowered */
+  int64_t nest_miss{0};
+};
+
+/*! \brief Global profile of the lowering passes. */
+class PassProfiler {
+ public:
+  void Record(const std::string& name, double time,
+              int64_t nest_hit, int64_t nest_miss) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PassStat& stat = stats_[name];
+    stat.num_calls += 1;
+    stat.total_time += time;
+    stat.nest_hit += nest_hit;
+    stat.nest_miss += nest_miss;
+  }
+
+  std::unordered_map<std::string, PassStat> stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+  }
+
+  static PassProfiler* Global() {
+    static PassProfiler inst;
+    return &inst;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, PassStat> stats_;
+};
+
+/*! \brief Global cache of lowered nests, shared by all pipelines. */
+class NestCache {
+ public:
+  bool Lookup(const std::string& name, size_t hash,
+              const Stmt& nest, Stmt* result) {
+    Stmt output;
+    std::unordered_map<const Variable*, const Variable*> vmap;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = table_.find(name);
+      if (it == table_.end()) return false;
+      auto range = it->second.equal_range(hash);
+      for (auto rit = range.first; rit != range.second; ++rit) {
+        vmap.clear();
+        if (EqualRename(rit->second.first, nest, &vmap)) {
+          output = rit->second.second;
+          break;
+        }
+      }
+    }
+    if (!output.defined()) return false;
+    VarCollector nest_vars, output_vars;
+    nest_vars.Visit(nest);
+    output_vars.Visit(output);
+    // map the variables of the cached input to the ones in the nest.
+    std::unordered_map<const Variable*, VarExpr> remap;
+    for (const auto& kv : vmap) {
+      auto it = nest_vars.vars.find(kv.second);
+      CHECK(it != nest_vars.vars.end());
+      remap[kv.first] = it->second;
+    }
+    // variables defined in the output get fresh copies,
+    // so that the result can be used multiple times in one function.
+    for (const auto& kv : output_vars.fresh) {
+      remap[kv.first] = kv.second;
+    }
+    *result = VarRemapper(remap).Mutate(output);
+    return true;
+  }
+
+  void Insert(const std::string& name, size_t hash,
+              const Stmt& nest, const Stmt& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size_ >= kMaxEntries) {
+      table_.clear();
+      size_ = 0;
+    }
+    table_[name].emplace(hash, std::make_pair(nest, result));
+    ++size_;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.clear();
+    size_ = 0;
+  }
+
+  static NestCache* Global() {
+    static NestCache inst;
+    return &inst;
+  }
+
+ private:
+  /*! \brief maximum number of entries before the cache is flushed */
+  static constexpr size_t kMaxEntries = 1 << 14;
+  std::mutex mutex_;
+  size_t size_{0};
+  std::unordered_map<
+    std::string, std::unordered_multimap<size_t, std::pair<Stmt, Stmt> > > table_;
+};
+
+Stmt LowerPipeline::Run(const std::string& name,
+                        const Stmt& stmt,
+                        const FPass& fpass,
+                        bool local) {
+  if (incremental_ && local) {
+    return RunIncremental(name, stmt, fpass);
+  }
+  auto tbegin = std::chrono::high_resolution_clock::now();
+  Stmt ret = fpass(stmt);
+  auto tend = std::chrono::high_resolution_clock::now();
+  double time = std::chrono::duration_cast<
+    std::chrono::duration<double> >(tend - tbegin).count();
+  PassProfiler::Global()->Record(name, time, 0, 0);
+  return ret;
+}
+
+void LowerPipeline::Time(const std::string& name,
+                         const std::function<void()>& fphase) {
+  auto tbegin = std::chrono::high_resolution_clock::now();
+  fphase();
+  auto tend = std::chrono::high_resolution_clock::now();
+  double time = std::chrono::duration_cast<
+    std::chrono::duration<double> >(tend - tbegin).count();
+  PassProfiler::Global()->Record(name, time, 0, 0);
+}
+
+Stmt LowerPipeline::RunIncremental(const std::string& name,
+                                   const Stmt& stmt,
+                                   const FPass& fpass) {
+  auto tbegin = std::chrono::high_resolution_clock::now();
+  NestCache* cache = NestCache::Global();
+  NestSplitter splitter;
+  Stmt spine = splitter.Mutate(stmt);
+  std::vector<Stmt> results(splitter.nests.size());
+  int64_t nest_hit = 0, nest_miss = 0;
+  for (size_t i = 0; i < splitter.nests.size(); ++i) {
+    const Stmt& nest = splitter.nests[i];
+    if (!NestCacheChecker().Check(nest)) {
+      results[i] = fpass(nest);
+      ++nest_miss;
+      continue;
+    }
+    size_t hash = StructuralHash(nest);
+    if (cache->Lookup(name, hash, nest, &results[i])) {
+      ++nest_hit;
+    } else {
+      results[i] = fpass(nest);
+      cache->Insert(name, hash, nest, results[i]);
+      ++nest_miss;
+    }
+  }
+  // Nests that become no-op are put back directly,
+  // so the pass can clean up the spine around them.
+  std::vector<Stmt> placeholders(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (is_no_op(results[i])) {
+      placeholders[i] = results[i];
+    } else {
+      placeholders[i] = Evaluate::make(
+          Call::make(Int(32), kNestPlaceholder,
+                     {make_const(Int(32), static_cast<int64_t>(i))}, Call::Extern));
+    }
+  }
+  spine = NestMerger(placeholders).Mutate(spine);
+  spine = fpass(spine);
+  Stmt ret = NestMerger(results).Mutate(spine);
+  if (nest_hit != 0) {
+    // a cached nest can appear several times in the same function.
+    ret = ConvertSSA(ret);
+  }
+  auto tend = std::chrono::high_resolution_clock::now();
+  double time = std::chrono::duration_cast<
+    std::chrono::duration<double> >(tend - tbegin).count();
+  PassProfiler::Global()->Record(name, time, nest_hit, nest_miss);
+  return ret;
+}
+
+TVM_REGISTER_API("_RunLowerPass")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    Stmt stmt = args[0];
+    std::string name = args[1];
+    PackedFunc fpass = args[2];
+    bool local = args[3];
+    bool incremental = args[4];
+    *ret = LowerPipeline(incremental).Run(
+        name, stmt, [fpass](Stmt s) -> Stmt {
+          Stmt ret = fpass(s);
+          return ret;
+        }, local);
+  });
+
+TVM_REGISTER_API("_TimeLowerPhase")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    std::string name = args[0];
+    PackedFunc fphase = args[1];
+    LowerPipeline::Time(name, [&]() {
+        *ret = fphase();
+      });
+  });
+
+TVM_REGISTER_API("_GetLowerPassProfile")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    Map<std::string, Array<Expr> > profile;
+    for (const auto& kv : PassProfiler::Global()->stats()) {
+      profile.Set(kv.first, Array<Expr>({
+            make_const(Int(64), kv.second.num_calls),
+            make_const(Float(64), kv.second.total_time),
+            make_const(Int(64), kv.second.nest_hit),
+            make_const(Int(64), kv.second.nest_miss)}));
+    }
+    *ret = profile;
+  });
+
+TVM_REGISTER_API("_ResetLowerPassProfile")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    PassProfiler::Global()->Reset();
+  });
+
+TVM_REGISTER_API("_ClearLowerPassCache")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    NestCache::Global()->Clear();
+  });
+
+}  // namespace ir
+}  // namespace tvm
@@ -0,0 +1,86 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file lower_pipeline.h
+ * \brief Timing and memoization of the statement lowering passes.
+ *
+ *  Autotuning lowers many schedules that only differ in a few
+ *  loop nests. The pipeline splits the statement into independent
+ *  loop nests and memoizes the result of local passes on each nest,
+ *  keyed by a structural hash that is invariant to variable renaming,
+ *  so unchanged nests are not lowered again.
+ */
+#ifndef TVM_PASS_LOWER_PIPELINE_H_
+#define TVM_PASS_LOWER_PIPELINE_H_
+
+#include <tvm/ir.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace ir {
+
+/*!
+ * \brief Structural hash of the statement.
+ *  Variables are numbered by their first occurrence, so the hash
+ *  is invariant to a one to one renaming of the variables.
+ * \param stmt The statement.
+ * \return The hash value.
+ */
+size_t StructuralHash(const Stmt& stmt);
+
+/*!
+ * \brief Deep compare lhs and rhs up to a one to one renaming of variables.
+ * \param lhs The left operand.
+ * \param rhs The right operand.
+ * \param vmap The variable mapping from lhs to rhs, set when equal.
+ * \return Whether the two statements are equal.
+ */
+bool EqualRename(const Stmt& lhs, const Stmt& rhs,
+                 std::unordered_map<const Variable*, const Variable*>* vmap);
+
+/*!
+ * \brief Lowering pipeline that times each pass and
+ *  optionally memoizes the local passes on each loop nest.
+ */
+class LowerPipeline {
+ public:
+  /*! \brief The signature of a statement pass */
+  using FPass = std::function<Stmt(Stmt)>;
+  /*!
+   * \brief constructor
+   * \param incremental Whether to memoize local passes on loop nests.
+   */
+  explicit LowerPipeline(bool incremental)
+      : incremental_(incremental) {}
+  /*!
+   * \brief Run a pass.
+   * \param name The name of the pass, with all its options.
+   *  Passes with the same name must be the same function.
+   * \param stmt The input statement.
+   * \param fpass The pass function.
+   * \param local Whether the pass only depends on the content of each loop nest,
+   *  in which case it can be applied to each nest separately.
+   * \return The transformed statement.
+   */
+  Stmt Run(const std::string& name,
+           const Stmt& stmt,
+           const FPass& fpass,
+           bool local = false);
+  /*!
+   * \brief Record the time of a phase that is not a statement pass.
+   * \param name The name of the phase.
+   * \param fphase The phase to be timed.
+   */
+  static void Time(const std::string& name, const std::function<void()>& fphase);
+
+ private:
+  // Run the local pass on each loop nest and memoize the result.
+  Stmt RunIncremental(const std::string& name, const Stmt& stmt, const FPass& fpass);
+  /*! \brief Whether incremental lowering is enabled */
+  bool incremental_;
+};
+
+}  // namespace ir
+}  // namespace tvm
+#endif  // TVM_PASS_LOWER_PIPELINE_H_
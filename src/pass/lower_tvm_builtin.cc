@@ -6,7 +6,10 @@
 #include <tvm/ir.h>
 #include <tvm/ir_mutator.h>
 #include <tvm/ir_pass.h>
+#include <algorithm>
+#include <limits>
 #include <unordered_set>
+#include <vector>
 #include "ir_util.h"
 #include "../arithmetic/compute_expr.h"
 
@@ -62,6 +65,13 @@ class BuiltinLower : public IRMutator {
   }
 
   Stmt Mutate_(const Allocate* op, const Stmt& s) {
+    // Place constant sized workspace in the arena of the current scope.
+    if (!op->new_expr.defined() && arena_.size() != 0) {
+      int64_t nbytes = GetVectorBytes(op->type) * op->constant_allocation_size();
+      if (nbytes >= runtime::kMaxStackAlloca) {
+        return MakeArenaAlloc(op, nbytes);
+      }
+    }
     // Lower allocate to device allocate when needed.
     Stmt stmt = IRMutator::Mutate_(op, s);
     op = stmt.as<Allocate>();
@@ -83,59 +93,48 @@ class BuiltinLower : public IRMutator {
     for (size_t i = 0; i < op->extents.size(); ++i) {
       total_bytes = total_bytes * op->extents[i];
     }
-    CHECK(device_type_.defined()) << "Unknown device type in current IR";
-    CHECK(device_id_.defined()) << "Unknown device id in current IR";
-    Stmt throw_last_error = Evaluate::make(Call::make(Int(32),
-                                           intrinsic::tvm_throw_last_error, {},
-                                           Call::Intrinsic));
-
-    Stmt body = Block::make(
-        IfThenElse::make(Call::make(Bool(1),
-                                    intrinsic::tvm_handle_is_null,
-                                    {op->buffer_var}, Call::PureIntrinsic),
-                         throw_last_error),
-        op->body);
-
-    Stmt alloca = LetStmt::make(
-        op->buffer_var,
-        Call::make(op->buffer_var.type(),
-                   "TVMBackendAllocWorkspace",
-                   {cast(Int(32), device_type_),
-                    cast(Int(32), device_id_),
-                    cast(UInt(64), total_bytes),
-                    IntImm::make(Int(32), op->type.code()),
-                    IntImm::make(Int(32), op->type.bits())},
-                   Call::Extern),
-        body);
-
-    Expr free_op = Call::make(Int(32),
-                              "TVMBackendFreeWorkspace",
-                              {cast(Int(32), device_type_),
-                                    cast(Int(32), device_id_),
-                                    op->buffer_var},
-                              Call::Extern);
-    Stmt free_stmt = IfThenElse::make(free_op != make_zero(Int(32)), throw_last_error);
-    body = Block::make(alloca, free_stmt);
-    body = AttrStmt::make(
-        op->buffer_var, attr::storage_alignment,
-        make_const(Int(32), runtime::kTempAllocaAlignment),
-        body);
-    return body;
+    return MakeWorkspaceAlloc(op->buffer_var, total_bytes, op->type, op->body);
   }
 
   Stmt Mutate_(const AttrStmt* op, const Stmt &s) final {
     if (op->attr_key == attr::device_context_id) {
       CHECK(!device_id_.defined());
       device_id_ = op->value;
-      return Mutate(op->body);
+      return MutateDeviceScope(op->body);
     } else if (op->attr_key == attr::device_context_type) {
       CHECK(!device_type_.defined());
       device_type_ = op->value;
-      return Mutate(op->body);
+      return MutateDeviceScope(op->body);
+    } else if (op->attr_key == "pragma_parallel_launch_point" &&
+               arena_.size() != 0 && !in_parallel_) {
+      // The body runs once in each parallel task.
+      in_parallel_ = true;
+      arena_.emplace_back(Var("parallel_arena", Handle()));
+      Stmt body = PopArena(this->Mutate(op->body));
+      in_parallel_ = false;
+      return AttrStmt::make(op->node, op->attr_key, op->value, body);
     } else {
       return IRMutator::Mutate_(op, s);
     }
   }
+  Stmt Mutate_(const For* op, const Stmt& s) final {
+    if (op->for_type != ForType::Parallel || arena_.size() == 0 || in_parallel_) {
+      return IRMutator::Mutate_(op, s);
+    }
+    // Make the parallel loop its own launch point, so the arena
+    // is allocated once for each parallel task instead of each iteration.
+    in_parallel_ = true;
+    arena_.emplace_back(Var("parallel_arena", Handle()));
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    in_parallel_ = false;
+    if (arena_.back().size == 0) {
+      arena_.pop_back();
+      return stmt;
+    }
+    return AttrStmt::make(
+        make_zero(Int(32)), "pragma_parallel_launch_point",
+        make_const(Int(32), 1), PopArena(stmt));
+  }
   Expr Mutate_(const Call* op, const Expr &e) final {
     if (op->is_intrinsic(intrinsic::tvm_call_packed)) {
       return MakeCallPacked(op, e);
@@ -319,10 +318,119 @@ class BuiltinLower : public IRMutator {
     return false;
   }
 
+  // The workspace arena of a scope, which holds the constant sized
+  // workspace of the scope at offsets planned from the nesting of the allocations.
+  struct ArenaScope {
+    explicit ArenaScope(Var arena) : arena(arena) {}
+    // The arena buffer.
+    Var arena;
+    // The end of the allocations that are alive.
+    int64_t top{0};
+    // The size of the arena.
+    int64_t size{0};
+  };
+
+  // Round the offset up to the workspace alignment.
+  static int64_t AlignOffset(int64_t offset) {
+    int64_t align = runtime::kTempAllocaAlignment;
+    return (offset + align - 1) / align * align;
+  }
+
+  Stmt MutateDeviceScope(Stmt body) {
+    if (!device_type_.defined() || !device_id_.defined() || arena_.size() != 0) {
+      return this->Mutate(body);
+    }
+    // The device handle is only offset on CPU.
+    int64_t dev_type;
+    if (!arith::GetConst(device_type_, &dev_type) || dev_type != kDLCPU) {
+      return this->Mutate(body);
+    }
+    arena_.emplace_back(Var("workspace_arena", Handle()));
+    return PopArena(this->Mutate(body));
+  }
+
+  // Place the allocation at the top of the innermost arena. Allocations
+  // that do not nest in each other reuse the same offsets, as their
+  // lifetimes are disjoint.
+  Stmt MakeArenaAlloc(const Allocate* op, int64_t nbytes) {
+    size_t scope = arena_.size() - 1;
+    int64_t offset = arena_[scope].top;
+    arena_[scope].top = AlignOffset(offset + nbytes);
+    arena_[scope].size = std::max(arena_[scope].size, arena_[scope].top);
+    Stmt body = this->Mutate(op->body);
+    arena_[scope].top = offset;
+
+    Expr offset_expr = offset <= std::numeric_limits<int>::max() ?
+        make_const(Int(32), offset) : make_const(Int(64), offset);
+    Expr addr = Call::make(
+        op->buffer_var.type(), intrinsic::tvm_address_of,
+        {Load::make(UInt(8), arena_[scope].arena, offset_expr, const_true())},
+        Call::PureIntrinsic);
+    body = LetStmt::make(op->buffer_var, addr, body);
+    return AttrStmt::make(
+        op->buffer_var, attr::storage_alignment,
+        make_const(Int(32), runtime::kTempAllocaAlignment),
+        body);
+  }
+
+  // Allocate the arena of the innermost scope around the body, if it is used.
+  Stmt PopArena(Stmt body) {
+    ArenaScope scope = arena_.back();
+    arena_.pop_back();
+    if (scope.size == 0) return body;
+    return MakeWorkspaceAlloc(scope.arena, make_const(UInt(64), scope.size),
+                              UInt(8), body);
+  }
+
+  // Allocate the buffer from the workspace of the device, and free it after the body.
+  Stmt MakeWorkspaceAlloc(Var buffer_var, Expr total_bytes, Type type, Stmt body) {
+    CHECK(device_type_.defined()) << "Unknown device type in current IR";
+    CHECK(device_id_.defined()) << "Unknown device id in current IR";
+    Stmt throw_last_error = Evaluate::make(Call::make(Int(32),
+                                           intrinsic::tvm_throw_last_error, {},
+                                           Call::Intrinsic));
+
+    body = Block::make(
+        IfThenElse::make(Call::make(Bool(1),
+                                    intrinsic::tvm_handle_is_null,
+                                    {buffer_var}, Call::PureIntrinsic),
+                         throw_last_error),
+        body);
+
+    Stmt alloca = LetStmt::make(
+        buffer_var,
+        Call::make(buffer_var.type(),
+                   "TVMBackendAllocWorkspace",
+                   {cast(Int(32), device_type_),
+                    cast(Int(32), device_id_),
+                    cast(UInt(64), total_bytes),
+                    IntImm::make(Int(32), type.code()),
+                    IntImm::make(Int(32), type.bits())},
+                   Call::Extern),
+        body);
+
+    Expr free_op = Call::make(Int(32),
+                              "TVMBackendFreeWorkspace",
+                              {cast(Int(32), device_type_),
+                                    cast(Int(32), device_id_),
+                                    buffer_var},
+                              Call::Extern);
+    Stmt free_stmt = IfThenElse::make(free_op != make_zero(Int(32)), throw_last_error);
+    body = Block::make(alloca, free_stmt);
+    return AttrStmt::make(
+        buffer_var, attr::storage_alignment,
+        make_const(Int(32), runtime::kTempAllocaAlignment),
+        body);
+  }
+
   // The prepration sequence to be emitted.
   std::vector<Stmt> prep_seq_;
   Expr device_type_;
   Expr device_id_;
+  // The arenas of the enclosing scopes, the function and the parallel tasks.
+  std::vector<ArenaScope> arena_;
+  // Whether we are inside of a parallel task.
+  bool in_parallel_{false};
   // Var handle for each stack.
   Var stack_shape_;
   Var stack_array_;
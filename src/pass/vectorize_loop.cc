@@ -6,10 +6,13 @@
 #include <tvm/ir.h>
 #include <tvm/ir_pass.h>
 #include <tvm/ir_mutator.h>
+#include <tvm/ir_visitor.h>
+#include <tvm/arithmetic.h>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
 #include "../arithmetic/compute_expr.h"
+#include "../arithmetic/int_set_internal.h"
 
 namespace tvm {
 namespace ir {
@@ -74,10 +77,99 @@ class VecAllocAccess : public IRMutator {
   int var_lanes_;
 };
 
+// Check whether the vectorized code can run on all the lanes
+// when its memory accesses are masked by a predicate of the given lanes.
+// Accesses that do not have the lanes of the predicate, side effects other
+// than stores, and integer divisions which can trap on the masked lanes
+// are rejected.
+class PredicateChecker : public IRVisitor {
+ public:
+  explicit PredicateChecker(int lanes) : lanes_(lanes) {}
+
+  bool Check(const Stmt& stmt) {
+    this->Visit(stmt);
+    return ok_;
+  }
+  bool Check(const Expr& expr) {
+    this->Visit(expr);
+    return ok_;
+  }
+
+  void Visit_(const Load* op) final {
+    if (op->type.lanes() != lanes_) ok_ = false;
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Store* op) final {
+    if (op->value.type().lanes() != lanes_) ok_ = false;
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Div* op) final {
+    CheckDivisor(op->b);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Mod* op) final {
+    CheckDivisor(op->b);
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const Call* op) final {
+    if (!op->is_pure()) ok_ = false;
+    IRVisitor::Visit_(op);
+  }
+  void Visit_(const LetStmt* op) final { ok_ = false; }
+  void Visit_(const AttrStmt* op) final { ok_ = false; }
+  void Visit_(const Allocate* op) final { ok_ = false; }
+  void Visit_(const Free* op) final { ok_ = false; }
+  void Visit_(const AssertStmt* op) final { ok_ = false; }
+  void Visit_(const Evaluate* op) final { ok_ = false; }
+  void Visit_(const Provide* op) final { ok_ = false; }
+  void Visit_(const Realize* op) final { ok_ = false; }
+  void Visit_(const Prefetch* op) final { ok_ = false; }
+  void Visit_(const ProducerConsumer* op) final { ok_ = false; }
+
+ private:
+  void CheckDivisor(const Expr& b) {
+    if (!b.type().is_float() && !(is_const(b) && !is_const_int(b, 0))) {
+      ok_ = false;
+    }
+  }
+  // the lanes of the predicate
+  int lanes_;
+  // whether the check passed
+  bool ok_{true};
+};
+
+// Mask the loads and stores with the predicate.
+// The masked lanes of a load are zero.
+class AccessPredicator : public IRMutator {
+ public:
+  explicit AccessPredicator(Expr predicate) : predicate_(predicate) {}
+
+  Expr Mutate_(const Load* op, const Expr& e) final {
+    Expr expr = IRMutator::Mutate_(op, e);
+    op = expr.as<Load>();
+    return Load::make(op->type, op->buffer_var, op->index,
+                      Combine(op->predicate));
+  }
+  Stmt Mutate_(const Store* op, const Stmt& s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<Store>();
+    return Store::make(op->buffer_var, op->value, op->index,
+                       Combine(op->predicate));
+  }
+
+ private:
+  Expr Combine(const Expr& pred) {
+    if (is_one(pred)) return predicate_;
+    return And::make(pred, predicate_);
+  }
+  // the predicate of the accesses
+  Expr predicate_;
+};
+
 class Vectorizer : public IRMutator {
  public:
-  Vectorizer(Var var, int var_lanes)
-      : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_predicate)
+      : var_(var), var_lanes_(var_lanes), enable_predicate_(enable_predicate) {
     ramp_ = Ramp::make(0, 1, var_lanes);
   }
   // user mutate from parent.
@@ -217,6 +309,10 @@ class Vectorizer : public IRMutator {
   Expr MutateIfThenElseExpr_(const Call *op, const Expr& e) {
     Expr cond = this->Mutate(op->args[0]);
     if (cond.type().is_vector())  {
+      if (enable_predicate_) {
+        Expr ret = PredicateIfThenElseExpr(op, cond);
+        if (ret.defined()) return ret;
+      }
       need_scalarize_ = true;
       return e;
     }
@@ -322,6 +418,10 @@ class Vectorizer : public IRMutator {
     CHECK(!op->extent.type().is_vector());
     Expr extent = Mutate(op->extent);
     if (extent.type().is_vector()) {
+      if (enable_predicate_) {
+        Stmt ret = PredicateFor(op, extent);
+        if (ret.defined()) return ret;
+      }
       LOG(WARNING) << "Detect vectorized extent type, scalarizing...";
       return Scalarize(s);
     }
@@ -340,6 +440,10 @@ class Vectorizer : public IRMutator {
     CHECK(!op->condition.type().is_vector());
     Expr condition = this->Mutate(op->condition);
     if (condition.type().is_vector()) {
+      if (enable_predicate_) {
+        Stmt ret = PredicateIfThenElse(op, condition);
+        if (ret.defined()) return ret;
+      }
       LOG(WARNING) << "Detect vector condition in Vectorized Loop, scalarizing...";
       return Scalarize(s);
     }
@@ -405,12 +509,92 @@ class Vectorizer : public IRMutator {
   Var var_;
   // the lanes.
   int var_lanes_;
+  // whether to mask the accesses instead of scalarizing.
+  bool enable_predicate_;
   // ramp representing the var.
   Expr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
   // The lets
   std::unordered_map<const Variable*, Expr> lets_;
+  // Select between the branches, the loads of each branch are masked
+  // by the lanes that take the branch.
+  // Returns an undefined expr if the branches cannot be masked.
+  Expr PredicateIfThenElseExpr(const Call* op, const Expr& cond) {
+    int lanes = cond.type().lanes();
+    Expr t = this->Mutate(op->args[1]);
+    Expr f = this->Mutate(op->args[2]);
+    if ((t.type().lanes() != 1 && t.type().lanes() != lanes) ||
+        (f.type().lanes() != 1 && f.type().lanes() != lanes)) {
+      return Expr();
+    }
+    t = BroadcastTo(t, lanes);
+    f = BroadcastTo(f, lanes);
+    if (!PredicateChecker(lanes).Check(t) ||
+        !PredicateChecker(lanes).Check(f)) {
+      return Expr();
+    }
+    Var mask;
+    Expr pred = BindMask(cond, &mask);
+    t = AccessPredicator(pred).Mutate(t);
+    f = AccessPredicator(Not::make(pred)).Mutate(f);
+    Expr ret = Select::make(pred, t, f);
+    if (mask.defined()) ret = Let::make(mask, cond, ret);
+    return ret;
+  }
+  // Run both branches with the accesses masked by the condition.
+  // Returns an undefined stmt if the branches cannot be masked.
+  Stmt PredicateIfThenElse(const IfThenElse* op, const Expr& condition) {
+    int lanes = condition.type().lanes();
+    Stmt then_case = this->Mutate(op->then_case);
+    if (!PredicateChecker(lanes).Check(then_case)) return Stmt();
+    Stmt else_case;
+    if (op->else_case.defined()) {
+      else_case = this->Mutate(op->else_case);
+      if (!PredicateChecker(lanes).Check(else_case)) return Stmt();
+    }
+    Var mask;
+    Expr pred = BindMask(condition, &mask);
+    Stmt ret = AccessPredicator(pred).Mutate(then_case);
+    if (else_case.defined()) {
+      else_case = AccessPredicator(Not::make(pred)).Mutate(else_case);
+      ret = Block::make(ret, else_case);
+    }
+    if (mask.defined()) ret = LetStmt::make(mask, condition, ret);
+    return ret;
+  }
+  // Get the predicate of the accesses masked by a condition. A condition
+  // that reads memory is bound to the mask variable, so that it is
+  // evaluated once before the stores of the branches.
+  Expr BindMask(const Expr& cond, Var* mask) {
+    bool has_load = false;
+    PostOrderVisit(cond, [&has_load](const NodeRef& n) {
+        if (n.as<Load>()) has_load = true;
+      });
+    if (!has_load) return cond;
+    *mask = Var("mask", cond.type());
+    return *mask;
+  }
+  // Run the loop up to the largest extent of the lanes, and mask the
+  // accesses of the lanes whose loop has ended.
+  // Returns an undefined stmt if the extent has no upper bound or the
+  // body cannot be masked.
+  Stmt PredicateFor(const For* op, const Expr& extent) {
+    std::unordered_map<const Variable*, arith::IntSet> dom_map;
+    dom_map[var_.get()] = arith::IntSet::interval(
+        make_zero(var_.type()), make_const(var_.type(), var_lanes_ - 1));
+    arith::IntSet ext_set = arith::EvalSet(op->extent, dom_map);
+    const arith::IntervalSet* ext_itrv = ext_set.as<arith::IntervalSet>();
+    if (ext_itrv == nullptr || !ext_itrv->i.has_upper_bound()) return Stmt();
+
+    int lanes = extent.type().lanes();
+    Stmt body = this->Mutate(op->body);
+    if (!PredicateChecker(lanes).Check(body)) return Stmt();
+    Expr mask = LT::make(Broadcast::make(op->loop_var, lanes), extent);
+    body = AccessPredicator(mask).Mutate(body);
+    return For::make(op->loop_var, op->min, ext_itrv->i.max,
+                     op->for_type, op->device_api, body);
+  }
   // mutate array, with given lane requirement
   // when finished, p_lane updates the lane requirement.
   Array<Expr> MutateArray(Array<Expr> arr, int* p_lanes) {
@@ -477,6 +661,19 @@ class Vectorizer : public IRMutator {
 
 class LoopVectorizer : public IRMutator {
  public:
+  // The device code generators do not support predicated accesses,
+  // so the loops inside of a kernel are still scalarized.
+  Stmt Mutate_(const AttrStmt* op, const Stmt& s) final {
+    if (op->attr_key == attr::thread_extent) {
+      bool in_kernel = in_kernel_;
+      in_kernel_ = true;
+      Stmt stmt = IRMutator::Mutate_(op, s);
+      in_kernel_ = in_kernel;
+      return stmt;
+    }
+    return IRMutator::Mutate_(op, s);
+  }
+
   Stmt Mutate_(const For* op, const Stmt& s) final {
     if (op->for_type == ForType::Vectorized) {
       CHECK(is_zero(op->min));
@@ -486,11 +683,15 @@ class LoopVectorizer : public IRMutator {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
       Var var(op->loop_var.node_);
-      return Vectorizer(var, lanes).Mutate(op->body);
+      return Vectorizer(var, lanes, !in_kernel_).Mutate(op->body);
     } else {
       return IRMutator::Mutate_(op, s);
     }
   }
+
+ private:
+  // whether the loop is inside of a device kernel
+  bool in_kernel_{false};
 };
 
 Stmt VectorizeLoop(Stmt stmt) {
@@ -0,0 +1,526 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file relay/backend/graph_runtime_codegen.cc
+ * \brief Generate the graph json and the params of the graph runtime
+ *  from a fused Relay function.
+ */
+#include <dmlc/json.h>
+#include <tvm/packed_func_ext.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/module.h>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "compile_engine.h"
+
+namespace tvm {
+namespace relay {
+
+using IntegerArray = Array<Integer>;
+
+Map<Expr, Array<IntegerArray> > GraphPlanMemory(const Function& func);
+
+/*! \brief A reference to an output of a graph node. */
+struct GraphNodeRef {
+  uint32_t node_id;
+  uint32_t index;
+};
+
+/*! \brief A node of the graph runtime. */
+struct GraphNode {
+  /*! \brief The name of the node. */
+  std::string name;
+  /*! \brief The function of an op node, empty for an input node. */
+  std::string func_name;
+  /*! \brief The inputs of an op node. */
+  std::vector<GraphNodeRef> inputs;
+  /*! \brief The storage id of each output. */
+  std::vector<int64_t> storage_ids;
+  /*! \brief The device type of each output, empty if not annotated. */
+  std::vector<int64_t> device_types;
+  /*! \brief The shape of each output. */
+  std::vector<std::vector<int64_t> > shapes;
+  /*! \brief The dtype of each output. */
+  std::vector<std::string> dtypes;
+};
+
+/*! \brief The attributes of the graph entries. */
+struct GraphAttrs {
+  const std::vector<std::vector<int64_t> >& shapes;
+  const std::vector<int64_t>& storage_ids;
+  const std::vector<int64_t>& device_types;
+  const std::vector<std::string>& dtypes;
+};
+
+}  // namespace relay
+}  // namespace tvm
+
+namespace dmlc {
+namespace json {
+template<>
+struct Handler<::tvm::relay::GraphNodeRef> {
+  inline static void Write(JSONWriter* writer, const ::tvm::relay::GraphNodeRef& ref) {
+    std::vector<uint32_t> value{ref.node_id, ref.index, 0};
+    writer->Write(value);
+  }
+};
+
+template<>
+struct Handler<::tvm::relay::GraphNode> {
+  inline static void Write(JSONWriter* writer, const ::tvm::relay::GraphNode& node) {
+    writer->BeginObject();
+    if (node.func_name.empty()) {
+      writer->WriteObjectKeyValue("op", std::string("null"));
+      writer->WriteObjectKeyValue("name", node.name);
+    } else {
+      std::map<std::string, std::string> attrs;
+      attrs["func_name"] = node.func_name;
+      attrs["flatten_data"] = "0";
+      attrs["num_inputs"] = std::to_string(node.inputs.size());
+      attrs["num_outputs"] = std::to_string(node.shapes.size());
+      writer->WriteObjectKeyValue("op", std::string("tvm_op"));
+      writer->WriteObjectKeyValue("name", node.name);
+      writer->WriteObjectKeyValue("attrs", attrs);
+    }
+    writer->WriteObjectKeyValue("inputs", node.inputs);
+    writer->EndObject();
+  }
+};
+
+template<>
+struct Handler<::tvm::relay::GraphAttrs> {
+  inline static void Write(JSONWriter* writer, const ::tvm::relay::GraphAttrs& attrs) {
+    writer->BeginObject();
+    writer->WriteObjectKeyValue("shape", std::make_pair(std::string("list_shape"), attrs.shapes));
+    writer->WriteObjectKeyValue(
+        "storage_id", std::make_pair(std::string("list_int"), attrs.storage_ids));
+    if (!attrs.device_types.empty()) {
+      writer->WriteObjectKeyValue(
+          "device_index", std::make_pair(std::string("list_int"), attrs.device_types));
+    }
+    writer->WriteObjectKeyValue("dltype", std::make_pair(std::string("list_str"), attrs.dtypes));
+    writer->EndObject();
+  }
+};
+}  // namespace json
+}  // namespace dmlc
+
+namespace tvm {
+namespace relay {
+
+// Hash the content of a constant.
+size_t NDArrayHash(const runtime::NDArray& data) {
+  const DLTensor* t = data.operator->();
+  size_t hash = std::hash<int>()(t->dtype.code);
+  hash = dmlc::HashCombine(hash, t->dtype.bits * t->dtype.lanes);
+  for (int i = 0; i < t->ndim; ++i) {
+    hash = dmlc::HashCombine(hash, t->shape[i]);
+  }
+  const char* bytes = static_cast<const char*>(t->data) + t->byte_offset;
+  size_t nbytes = runtime::GetDataSize(*t);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    hash = dmlc::HashCombine(hash, word);
+  }
+  for (; i < nbytes; ++i) {
+    hash = dmlc::HashCombine(hash, bytes[i]);
+  }
+  return hash;
+}
+
+// Check whether two constants have the same content.
+bool NDArrayEqual(const runtime::NDArray& lhs, const runtime::NDArray& rhs) {
+  const DLTensor* a = lhs.operator->();
+  const DLTensor* b = rhs.operator->();
+  if (a->ndim != b->ndim || a->dtype.code != b->dtype.code ||
+      a->dtype.bits != b->dtype.bits || a->dtype.lanes != b->dtype.lanes) {
+    return false;
+  }
+  for (int i = 0; i < a->ndim; ++i) {
+    if (a->shape[i] != b->shape[i]) return false;
+  }
+  return std::memcmp(static_cast<const char*>(a->data) + a->byte_offset,
+                     static_cast<const char*>(b->data) + b->byte_offset,
+                     runtime::GetDataSize(*a)) == 0;
+}
+
+/*!
+ * \brief The compiler from a fused Relay function to the graph runtime.
+ *
+ *  The parameters of the function and the constants are the inputs of the
+ *  graph, and each call to a primitive function is lowered by the compile
+ *  engine into an op node. Constants of the same content on the same device
+ *  share a single param.
+ */
+class GraphRuntimeCodegen
+    : public ExprFunctor<std::vector<GraphNodeRef>(const Expr&)> {
+ public:
+  GraphRuntimeCodegen(Module mod, Map<Integer, Target> targets)
+      : mod_(mod), targets_(targets), engine_(CompileEngine::Global()) {}
+
+  void Codegen(const Function& func) {
+    storage_device_map_ = GraphPlanMemory(func);
+    for (Var param : func->params) {
+      GraphNode node;
+      node.name = param->name_hint();
+      var_map_[param.get()] = AddNode(std::move(node), param);
+    }
+    heads_ = this->VisitExpr(func->body);
+  }
+
+  std::vector<GraphNodeRef> VisitExpr(const Expr& expr) final {
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) return it->second;
+    std::vector<GraphNodeRef> ret = ExprFunctor::VisitExpr(expr);
+    memo_[expr.get()] = ret;
+    return ret;
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const VarNode* op) final {
+    auto it = var_map_.find(op);
+    CHECK(it != var_map_.end()) << "Free variable " << op->name_hint();
+    return it->second;
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const ConstantNode* op) final {
+    Expr expr = GetRef<Expr>(op);
+    CHECK_EQ(op->data->ctx.device_type, kDLCPU);
+    int64_t device_type = GetDeviceTypes(expr)[0];
+    size_t hash = NDArrayHash(op->data);
+    for (uint32_t nid : const_nodes_[hash]) {
+      int64_t other_device_type = GetDeviceTypes(const_exprs_[nid])[0];
+      if (other_device_type == device_type &&
+          NDArrayEqual(params_[nodes_[nid].name], op->data)) {
+        return {GraphNodeRef{nid, 0}};
+      }
+    }
+    GraphNode node;
+    node.name = "p" + std::to_string(params_.size());
+    params_[node.name] = op->data;
+    param_names_.push_back(node.name);
+    std::vector<GraphNodeRef> ret = AddNode(std::move(node), expr);
+    const_nodes_[hash].push_back(ret[0].node_id);
+    const_exprs_[ret[0].node_id] = expr;
+    return ret;
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const TupleNode* op) final {
+    std::vector<GraphNodeRef> ret;
+    for (Expr field : op->fields) {
+      std::vector<GraphNodeRef> refs = this->VisitExpr(field);
+      CHECK_EQ(refs.size(), 1U) << "Nested tuples are not supported";
+      ret.push_back(refs[0]);
+    }
+    return ret;
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const TupleGetItemNode* op) final {
+    std::vector<GraphNodeRef> refs = this->VisitExpr(op->tuple);
+    CHECK_LT(static_cast<size_t>(op->index), refs.size());
+    return {refs[op->index]};
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const LetNode* op) final {
+    CHECK(!var_map_.count(op->var.get()));
+    var_map_[op->var.get()] = this->VisitExpr(op->value);
+    return this->VisitExpr(op->body);
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const CallNode* op) final {
+    Function func;
+    if (op->op.as<OpNode>()) {
+      LOG(FATAL) << "Operators should be transformed away; try applying "
+                 << "the fuse_ops transformation to the expression.";
+    } else if (const auto* gvar = op->op.as<GlobalVarNode>()) {
+      CHECK(mod_.defined()) << "A module is required to call " << gvar->name_hint;
+      func = mod_->Lookup(GetRef<GlobalVar>(gvar));
+    } else if (op->op.as<FunctionNode>()) {
+      func = Downcast<Function>(op->op);
+    } else {
+      LOG(FATAL) << "TVM runtime does not support calls to " << op->op->type_key();
+    }
+    CHECK(func->IsPrimitive())
+        << "TVM only support calls to primitive functions "
+        << "(i.e functions composed of fusable operator invocations)";
+
+    Target target = GetTarget(GetDeviceTypes(GetRef<Expr>(op))[0]);
+    CachedFunc cached_func = engine_->Lower(CCacheKeyNode::make(func, target));
+    std::string target_str = target->str();
+    if (!lowered_funcs_.count(target_str)) {
+      target_order_.push_back(target_str);
+    }
+    auto& lowered = lowered_funcs_[target_str];
+    for (LoweredFunc f : cached_func->funcs) {
+      if (lowered.second.insert(f.get()).second) {
+        lowered.first.push_back(f);
+      }
+    }
+
+    GraphNode node;
+    // tuple arguments are flattened.
+    for (Expr arg : op->args) {
+      for (const GraphNodeRef& ref : this->VisitExpr(arg)) {
+        node.inputs.push_back(ref);
+      }
+    }
+    node.func_name = cached_func->func_name;
+    node.name = GetUniqueName(cached_func->func_name);
+    return AddNode(std::move(node), GetRef<Expr>(op));
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const OpNode* op) final {
+    LOG(FATAL) << "can not compile op in non-eta expanded form";
+    return {};
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const GlobalVarNode* op) final {
+    LOG(FATAL) << "global var " << op->name_hint << " not supported";
+    return {};
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const IfNode* op) final {
+    LOG(FATAL) << "if not supported";
+    return {};
+  }
+
+  std::vector<GraphNodeRef> VisitExpr_(const FunctionNode* op) final {
+    LOG(FATAL) << "function not supported";
+    return {};
+  }
+
+  /*! \return The graph json. */
+  std::string GetJSON() const;
+
+  /*! \return The names of the params in creation order. */
+  const std::vector<std::string>& param_names() const {
+    return param_names_;
+  }
+
+  /*! \return The params. */
+  const std::unordered_map<std::string, runtime::NDArray>& params() const {
+    return params_;
+  }
+
+  /*! \return The lowered functions of each target. */
+  Map<std::string, Array<LoweredFunc> > GetLoweredFuncs() const {
+    Map<std::string, Array<LoweredFunc> > ret;
+    for (const std::string& target : target_order_) {
+      ret.Set(target, lowered_funcs_.at(target).first);
+    }
+    return ret;
+  }
+
+ private:
+  std::vector<int64_t> GetDeviceTypes(const Expr& expr) {
+    auto it = storage_device_map_.find(expr);
+    CHECK(it != storage_device_map_.end());
+    std::vector<int64_t> ret;
+    for (Integer dev : (*it).second[1]) {
+      ret.push_back(dev->value);
+    }
+    return ret;
+  }
+
+  Target GetTarget(int64_t device_type) {
+    for (const auto& kv : targets_) {
+      if (kv.first->value == device_type) return kv.second;
+    }
+    // homogeneous execution.
+    CHECK_EQ(targets_.size(), 1U)
+        << "No target is provided for device " << device_type;
+    return (*targets_.begin()).second;
+  }
+
+  std::vector<GraphNodeRef> AddNode(GraphNode node, const Expr& expr) {
+    auto it = storage_device_map_.find(expr);
+    CHECK(it != storage_device_map_.end());
+    Array<IntegerArray> storage_device_info = (*it).second;
+    CHECK_EQ(storage_device_info.size(), 2U);
+    for (Integer sid : storage_device_info[0]) {
+      node.storage_ids.push_back(sid->value);
+    }
+    size_t num_unknown_devices = 0;
+    for (Integer dev : storage_device_info[1]) {
+      node.device_types.push_back(dev->value);
+      if (dev->value == 0) ++num_unknown_devices;
+    }
+    CHECK(num_unknown_devices == 0 || num_unknown_devices == node.device_types.size())
+        << "The graph contains not annotated nodes for heterogeneous execution. "
+        << "All nodes must be annotated.";
+    // Add the device index only when the graph is annotated.
+    if (num_unknown_devices != 0) node.device_types.clear();
+
+    uint32_t nid = static_cast<uint32_t>(nodes_.size());
+    std::vector<GraphNodeRef> ret;
+    Type checked_type = expr->checked_type();
+    if (const auto* tuple_type = checked_type.as<TupleTypeNode>()) {
+      CHECK(!node.func_name.empty()) << "input of tuple type not supported";
+      for (size_t i = 0; i < tuple_type->fields.size(); ++i) {
+        const auto* ttype = tuple_type->fields[i].as<TensorTypeNode>();
+        CHECK(ttype) << "type " << tuple_type->fields[i] << " not supported";
+        AddOutput(ttype, &node);
+        ret.push_back(GraphNodeRef{nid, static_cast<uint32_t>(i)});
+      }
+    } else {
+      const auto* ttype = checked_type.as<TensorTypeNode>();
+      CHECK(ttype) << "type " << checked_type << " not supported";
+      AddOutput(ttype, &node);
+      ret.push_back(GraphNodeRef{nid, 0});
+    }
+    nodes_.push_back(std::move(node));
+    return ret;
+  }
+
+  void AddOutput(const TensorTypeNode* ttype, GraphNode* node) {
+    std::vector<int64_t> shape;
+    for (IndexExpr dim : ttype->shape) {
+      const int64_t* value = as_const_int(dim);
+      CHECK(value != nullptr) << "Do not support symbolic shape " << ttype->shape;
+      shape.push_back(*value);
+    }
+    node->shapes.push_back(shape);
+    node->dtypes.push_back(runtime::TVMType2String(Type2TVMType(ttype->dtype)));
+  }
+
+  std::string GetUniqueName(std::string name) {
+    while (true) {
+      auto it = name_map_.find(name);
+      if (it == name_map_.end()) {
+        name_map_[name] = 1;
+        return name;
+      }
+      name += std::to_string(it->second++);
+    }
+  }
+
+  /*! \brief The module of the global functions. */
+  Module mod_;
+  /*! \brief The target of each device type. */
+  Map<Integer, Target> targets_;
+  /*! \brief The compile engine lowering the primitive functions. */
+  CompileEngine engine_;
+  /*! \brief The storage ids and device types of each expression. */
+  Map<Expr, Array<IntegerArray> > storage_device_map_;
+  /*! \brief The graph nodes. */
+  std::vector<GraphNode> nodes_;
+  /*! \brief The outputs of the graph. */
+  std::vector<GraphNodeRef> heads_;
+  /*! \brief The visited expressions. */
+  std::unordered_map<const Node*, std::vector<GraphNodeRef> > memo_;
+  /*! \brief The nodes bound to the variables. */
+  std::unordered_map<const VarNode*, std::vector<GraphNodeRef> > var_map_;
+  /*! \brief The constant nodes of each content hash. */
+  std::unordered_map<size_t, std::vector<uint32_t> > const_nodes_;
+  /*! \brief The constant expression of each constant node. */
+  std::unordered_map<uint32_t, Expr> const_exprs_;
+  /*! \brief The params. */
+  std::unordered_map<std::string, runtime::NDArray> params_;
+  /*! \brief The names of the params in creation order. */
+  std::vector<std::string> param_names_;
+  /*! \brief The lowered functions of each target, and the set of them. */
+  std::unordered_map<std::string,
+                     std::pair<Array<LoweredFunc>, std::unordered_set<const Node*> > >
+      lowered_funcs_;
+  /*! \brief The targets in the order they are used. */
+  std::vector<std::string> target_order_;
+  /*! \brief The number of times each op node name is used. */
+  std::unordered_map<std::string, int> name_map_;
+};
+
+std::string GraphRuntimeCodegen::GetJSON() const {
+  std::vector<uint32_t> arg_nodes;
+  std::vector<uint32_t> node_row_ptr{0};
+  std::vector<std::vector<int64_t> > shapes;
+  std::vector<int64_t> storage_ids, device_types;
+  std::vector<std::string> dtypes;
+  for (uint32_t nid = 0; nid < nodes_.size(); ++nid) {
+    const GraphNode& node = nodes_[nid];
+    if (node.func_name.empty()) arg_nodes.push_back(nid);
+    shapes.insert(shapes.end(), node.shapes.begin(), node.shapes.end());
+    dtypes.insert(dtypes.end(), node.dtypes.begin(), node.dtypes.end());
+    storage_ids.insert(storage_ids.end(), node.storage_ids.begin(), node.storage_ids.end());
+    device_types.insert(device_types.end(),
+                        node.device_types.begin(), node.device_types.end());
+    node_row_ptr.push_back(node_row_ptr.back() + node.shapes.size());
+  }
+
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.BeginObject();
+  writer.WriteObjectKeyValue("nodes", nodes_);
+  writer.WriteObjectKeyValue("arg_nodes", arg_nodes);
+  writer.WriteObjectKeyValue("heads", heads_);
+  writer.WriteObjectKeyValue("node_row_ptr", node_row_ptr);
+  writer.WriteObjectKeyValue("attrs", GraphAttrs{shapes, storage_ids, device_types, dtypes});
+  writer.EndObject();
+  return os.str();
+}
+
+/*!
+ * \brief The module exposing the graph runtime codegen to the frontend.
+ */
+class GraphRuntimeCodegenModule : public runtime::ModuleNode {
+ public:
+  PackedFunc GetFunction(const std::string& name,
+                         const std::shared_ptr<ModuleNode>& sptr_to_self) final {
+    if (name == "codegen") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          Function func = args[0];
+          Module mod = args[1];
+          Map<Integer, Target> targets = args[2];
+          codegen_ = std::make_shared<GraphRuntimeCodegen>(mod, targets);
+          codegen_->Codegen(func);
+        });
+    } else if (name == "get_graph_json") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = codegen_->GetJSON();
+        });
+    } else if (name == "list_params_name") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          Array<Expr> ret;
+          for (const std::string& key : codegen_->param_names()) {
+            ret.push_back(ir::StringImm::make(key));
+          }
+          *rv = ret;
+        });
+    } else if (name == "get_param_by_name") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          std::string key = args[0];
+          auto it = codegen_->params().find(key);
+          CHECK(it != codegen_->params().end()) << "no such param " << key;
+          *rv = it->second;
+        });
+    } else if (name == "get_lowered_funcs") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = codegen_->GetLoweredFuncs();
+        });
+    } else {
+      return PackedFunc();
+    }
+  }
+
+  const char* type_key() const final {
+    return "RelayGraphRuntimeCodegenModule";
+  }
+
+ private:
+  std::shared_ptr<GraphRuntimeCodegen> codegen_;
+};
+
+TVM_REGISTER_GLOBAL("relay.backend._GraphRuntimeCodegen")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    *rv = runtime::Module(std::make_shared<GraphRuntimeCodegenModule>());
+  });
+
+}  // namespace relay
+}  // namespace tvm
@@ -4,6 +4,7 @@
  * \brief The expression AST nodes of Relay.
  */
 #include <tvm/relay/expr.h>
+#include <tvm/node_pool.h>
 
 namespace tvm {
 namespace relay {
@@ -12,7 +13,7 @@ using tvm::IRPrinter;
 using namespace tvm::runtime;
 
 Constant ConstantNode::make(runtime::NDArray data) {
-  NodePtr<ConstantNode> n = make_node<ConstantNode>();
+  NodePtr<ConstantNode> n = make_pooled_node<ConstantNode>();
   n->data = std::move(data);
   return Constant(n);
 }
@@ -46,7 +47,7 @@ TensorType ConstantNode::tensor_type() const {
 }
 
 Tuple TupleNode::make(tvm::Array<relay::Expr> fields) {
-  NodePtr<TupleNode> n = make_node<TupleNode>();
+  NodePtr<TupleNode> n = make_pooled_node<TupleNode>();
   n->fields = std::move(fields);
   return Tuple(n);
 }
@@ -65,7 +66,7 @@ TVM_STATIC_IR_FUNCTOR_REGISTER(IRPrinter, vtable)
 
 
 Var VarNode::make(Id vid, Type type_annotation) {
-  NodePtr<VarNode> n = make_node<VarNode>();
+  NodePtr<VarNode> n = make_pooled_node<VarNode>();
   n->vid = std::move(vid);
   n->type_annotation = std::move(type_annotation);
   return Var(n);
@@ -191,7 +192,7 @@ TVM_STATIC_IR_FUNCTOR_REGISTER(IRPrinter, vtable)
 
 Call CallNode::make(Expr op, Array<Expr> args, Attrs attrs,
                     Array<Type> type_args) {
-  NodePtr<CallNode> n = make_node<CallNode>();
+  NodePtr<CallNode> n = make_pooled_node<CallNode>();
   n->op = std::move(op);
   n->args = std::move(args);
   n->attrs = std::move(attrs);
@@ -213,7 +214,7 @@ TVM_STATIC_IR_FUNCTOR_REGISTER(IRPrinter, vtable)
 });
 
 Let LetNode::make(Var var, Expr value, Expr body) {
-  NodePtr<LetNode> n = make_node<LetNode>();
+  NodePtr<LetNode> n = make_pooled_node<LetNode>();
   n->var = std::move(var);
   n->value = std::move(value);
   n->body = std::move(body);
@@ -234,7 +235,7 @@ TVM_STATIC_IR_FUNCTOR_REGISTER(IRPrinter, vtable)
 });
 
 If IfNode::make(Expr cond, Expr true_branch, Expr false_branch) {
-  NodePtr<IfNode> n = make_node<IfNode>();
+  NodePtr<IfNode> n = make_pooled_node<IfNode>();
   n->cond = std::move(cond);
   n->true_branch = std::move(true_branch);
   n->false_branch = std::move(false_branch);
@@ -254,7 +255,7 @@ TVM_STATIC_IR_FUNCTOR_REGISTER(IRPrinter, vtable)
 });
 
 TupleGetItem TupleGetItemNode::make(Expr tuple, int index) {
-  NodePtr<TupleGetItemNode> n = make_node<TupleGetItemNode>();
+  NodePtr<TupleGetItemNode> n = make_pooled_node<TupleGetItemNode>();
   n->tuple = std::move(tuple);
   n->index = index;
   return TupleGetItem(n);
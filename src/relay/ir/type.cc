@@ -4,6 +4,7 @@
  * \brief The type system AST nodes of Relay.
  */
 #include <tvm/relay/type.h>
+#include <tvm/node_pool.h>
 
 namespace tvm {
 namespace relay {
@@ -12,7 +13,7 @@ using tvm::IRPrinter;
 using namespace tvm::runtime;
 
 TensorType TensorTypeNode::make(Array<IndexExpr> shape, DataType dtype) {
-  NodePtr<TensorTypeNode> n = make_node<TensorTypeNode>();
+  NodePtr<TensorTypeNode> n = make_pooled_node<TensorTypeNode>();
   n->shape = std::move(shape);
   n->dtype = std::move(dtype);
   return TensorType(n);
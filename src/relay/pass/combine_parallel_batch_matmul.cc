@@ -0,0 +1,85 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file combine_parallel_batch_matmul.cc
+ * \brief Combine parallel batch_matmul ops into a single batch_matmul.
+ *
+ * This pass replaces batch_matmul ops that share the same first input with a
+ * single batch_matmul whose second input is the concatenation of the original
+ * second inputs along the N axis. Elemwise and broadcast ops following
+ * batch_matmul are also combined if possible.
+ *
+ *           x                                x
+ *        /     \                             |
+ *  bmm(x, y0)  bmm(x, y1)    ->   bmm(x, concat(y0, y1, axis=1))
+ *                                        /         \
+ *                                    slice 0     slice 1
+ *
+ * This turns the per-head matmuls of attention layers sharing the same
+ * queries into one larger batched GEMM.
+ */
+
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/op_attr_types.h>
+#include "./pattern_util.h"
+#include "./combine_parallel_op.h"
+
+
+namespace tvm {
+namespace relay {
+
+class ParallelBatchMatmulCombiner : public ParallelOpConcatCombiner {
+ public:
+  explicit ParallelBatchMatmulCombiner(uint64_t min_num_branches)
+      : ParallelOpConcatCombiner("nn.batch_matmul", min_num_branches) {}
+
+ protected:
+  // The N axis must be known to slice the combined output.
+  bool IsSupportedOp(const CallNode* n) final {
+    const auto* ty = n->args[1]->type_as<TensorTypeNode>();
+    return ty->shape.size() == 3 && as_const_int(ty->shape[1]) != nullptr;
+  }
+
+  // Two batch_matmul can be combined if their second inputs only differ in N.
+  bool CanOpsBeCombined(const CallNode* a, const CallNode* b) final {
+    AttrsEqual eq;
+    const auto* ty_a = a->args[1]->type_as<TensorTypeNode>();
+    const auto* ty_b = b->args[1]->type_as<TensorTypeNode>();
+    return eq(ty_a->dtype, ty_b->dtype) &&
+           eq(ty_a->shape[0], ty_b->shape[0]) &&
+           eq(ty_a->shape[2], ty_b->shape[2]) &&
+           eq(a->type_as<TensorTypeNode>()->dtype, b->type_as<TensorTypeNode>()->dtype);
+  }
+
+  Call MakeCombinedOp(const Group& branches) final {
+    static const Op& batch_matmul = Op::Get("nn.batch_matmul");
+    Expr data = branches[0][0]->args[0];
+    Array<Expr> ys;
+    for (const auto& branch : branches) {
+      ys.push_back(branch[0]->args[1]);
+    }
+    channel_pos_ = 2;
+    return CallNode::make(batch_matmul,
+                          {data, MakeConcatenate(TupleNode::make(ys), 1)},
+                          Attrs(), {});
+  }
+
+  int64_t GetNumChannels(const CallNode* n) final {
+    return *as_const_int(n->args[1]->type_as<TensorTypeNode>()->shape[1]);
+  }
+};
+
+Expr CombineParallelBatchMatmul(const Expr& expr, uint64_t min_num_branches) {
+  return ParallelBatchMatmulCombiner(min_num_branches).Combine(expr);
+}
+
+TVM_REGISTER_API("relay._ir_pass.CombineParallelBatchMatmul")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  int64_t min_num_branches = args[1];
+  *ret = CombineParallelBatchMatmul(args[0], min_num_branches);
+});
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,82 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file combine_parallel_dense.cc
+ * \brief Combine parallel dense ops into a single dense.
+ *
+ * This pass replaces dense ops that share the same input node with a single
+ * dense whose weight is the concatenation of the original weights along the
+ * units. Elemwise and broadcast ops following dense are also combined if possible.
+ *
+ * This turns several small GEMMs, such as the query, key and value projections
+ * of attention layers, into one larger GEMM.
+ */
+
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/op_attr_types.h>
+#include "./pattern_util.h"
+#include "./combine_parallel_op.h"
+
+
+namespace tvm {
+namespace relay {
+
+class ParallelDenseCombiner : public ParallelOpConcatCombiner {
+ public:
+  explicit ParallelDenseCombiner(uint64_t min_num_branches)
+      : ParallelOpConcatCombiner("nn.dense", min_num_branches) {}
+
+ protected:
+  // The number of units must be known to slice the combined output.
+  bool IsSupportedOp(const CallNode* n) final {
+    const auto* tweight = n->args[1]->type_as<TensorTypeNode>();
+    return tweight->shape.size() == 2 && as_const_int(tweight->shape[0]) != nullptr;
+  }
+
+  // Two dense can be combined if their weights only differ in the number of units.
+  bool CanOpsBeCombined(const CallNode* a, const CallNode* b) final {
+    AttrsEqual eq;
+    const auto* tweight_a = a->args[1]->type_as<TensorTypeNode>();
+    const auto* tweight_b = b->args[1]->type_as<TensorTypeNode>();
+    return eq(tweight_a->dtype, tweight_b->dtype) &&
+           eq(tweight_a->shape[1], tweight_b->shape[1]) &&
+           eq(a->type_as<TensorTypeNode>()->dtype, b->type_as<TensorTypeNode>()->dtype);
+  }
+
+  Call MakeCombinedOp(const Group& branches) final {
+    static const Op& dense = Op::Get("nn.dense");
+    Expr data = branches[0][0]->args[0];
+    int64_t num_units = 0;
+    Array<Expr> weights;
+    for (const auto& branch : branches) {
+      weights.push_back(branch[0]->args[1]);
+      num_units += GetNumChannels(branch[0]);
+    }
+    auto new_attrs = make_node<DenseAttrs>();
+    new_attrs->units = MakeConstScalar(Int(32), num_units);
+    channel_pos_ = branches[0][0]->type_as<TensorTypeNode>()->shape.size() - 1;
+    return CallNode::make(dense,
+                          {data, MakeConcatenate(TupleNode::make(weights), 0)},
+                          Attrs{new_attrs}, {});
+  }
+
+  int64_t GetNumChannels(const CallNode* n) final {
+    return *as_const_int(n->args[1]->type_as<TensorTypeNode>()->shape[0]);
+  }
+};
+
+Expr CombineParallelDense(const Expr& expr, uint64_t min_num_branches) {
+  return ParallelDenseCombiner(min_num_branches).Combine(expr);
+}
+
+TVM_REGISTER_API("relay._ir_pass.CombineParallelDense")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  int64_t min_num_branches = args[1];
+  *ret = CombineParallelDense(args[0], min_num_branches);
+});
+
+}  // namespace relay
+}  // namespace tvm
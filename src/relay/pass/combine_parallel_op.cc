@@ -0,0 +1,236 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file combine_parallel_op.cc
+ * \brief Abstract class to combine parallel ops and their successive element-wise ops.
+ */
+
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/op_attr_types.h>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "./expr_subst.h"
+#include "./pattern_util.h"
+#include "./combine_parallel_op.h"
+
+
+namespace tvm {
+namespace relay {
+
+BranchGroupFinder::BranchGroupFinder(const Op& op,
+                                     FIsSupportedOp fis_supported_op,
+                                     FAreCompatibleOps fare_compatible_ops)
+  : op_(op),
+    fis_supported_op_(fis_supported_op),
+    fare_compatible_ops_(fare_compatible_ops) {
+}
+
+std::vector<Group> BranchGroupFinder::Find(const Expr& expr) {
+  this->VisitExpr(expr);
+
+  std::vector<Group> groups;
+  for (const auto& root : op_roots_) {
+    const auto& children = children_map_.at(root);
+    size_t ngroups = groups.size();
+    for (const CallNode* child : children) {
+      if (!child->op.same_as(op_)) continue;
+
+      auto&& branch = CreateBranch(child);
+      // add the branch to a group, or create a new group
+      auto it = std::find_if(groups.begin() + ngroups, groups.end(), [&](const Group& group) {
+        CHECK(!group.empty() && !group[0].empty());
+        return fare_compatible_ops_(child, group[0][0]);
+      });
+      if (it != groups.end()) {
+        it->push_back(branch);
+      } else {
+        groups.emplace_back();
+        // each group has at least one branch
+        groups.back().push_back(branch);
+      }
+    }
+  }
+  return groups;
+}
+
+// Create a branch starting from op.
+Branch BranchGroupFinder::CreateBranch(const CallNode* op) {
+  static auto fpattern = Op::GetAttr<TOpPattern>("TOpPattern");
+  // each branch has at least one element, the first element is always op
+  Branch branch{op};
+  auto it = children_map_.find(GetRef<Expr>(branch.back()));
+  while (it != children_map_.end() && it->second.size() == 1) {
+    const CallNode* call = it->second[0];
+    auto pattern = fpattern[Downcast<Op>(call->op)];
+    if (pattern <= kBroadcast) {
+      branch.push_back(call);
+      it = children_map_.find(GetRef<Expr>(branch.back()));
+    } else {
+      break;
+    }
+  }
+  return branch;
+}
+
+void BranchGroupFinder::VisitExpr_(const CallNode* n) {
+  ExprVisitor::VisitExpr_(n);
+  if (n->op.same_as(op_) && fis_supported_op_(n)) {
+    op_roots_.insert(n->args[0]);
+    children_map_[n->args[0]].push_back(n);
+  } else {
+    for (size_t i = 0; i < n->args.size(); i++) {
+      children_map_[n->args[i]].push_back(n);
+    }
+  }
+}
+
+ParallelOpCombiner::ParallelOpCombiner(const std::string& op_name, uint64_t min_num_branches)
+  : cached_op_(Op::Get(op_name)),
+    min_num_branches_(min_num_branches) {
+}
+
+Expr ParallelOpCombiner::Combine(const Expr& expr) {
+  auto groups = BranchGroupFinder(cached_op_,
+                                  [&](const CallNode* n) {
+                                    return IsSupportedOp(n);
+                                  },
+                                  [&](const CallNode* a, const CallNode* b) {
+                                    return CanOpsBeCombined(a, b);
+                                  }).Find(expr);
+  for (const Group& group : groups) {
+    if (group.size() < min_num_branches_) continue;
+    CombineBranches(group);
+  }
+  return ExprSubst(expr, std::move(subst_map_));
+}
+
+void ParallelOpCombiner::CombineBranches(const Group& branches) {
+  Call combined = MakeCombinedOp(branches);
+  auto it = std::min_element(branches.begin(), branches.end(),
+                             [](const Branch& branch_a,
+                                const Branch& branch_b) {
+                               return branch_a.size() < branch_b.size();
+                             });
+  size_t depth = it->size();
+  size_t i;
+  // starting from 1 to skip the op
+  for (i = 1; i < depth; i++) {
+    size_t parent_index;
+    for (parent_index = 0; parent_index < branches[0][i]->args.size(); parent_index++) {
+      if (branches[0][i]->args[parent_index].get() == branches[0][i - 1]) break;
+    }
+    CHECK_NE(parent_index, branches[0][i]->args.size());
+    if (!CheckLevel(branches, i, parent_index)) break;
+    combined = MakeCombinedCallFromFollowingOps(combined, branches, i, parent_index);
+  }
+  UpdateGroupOutput(combined, branches, i - 1, &subst_map_);
+}
+
+bool ParallelOpCombiner::CheckLevel(const Group& branches, size_t depth, size_t parent_index) {
+  const CallNode* call = branches[0][depth];
+  if (!IsSupportedFollowingOp(call)) return false;
+  AttrsEqual attrs_equal;
+  // check if all branches in current depth can be combined
+  for (auto it = branches.begin() + 1; it != branches.end(); it++) {
+    const Branch& branch = *it;
+    if (!branch[depth]->op.same_as(call->op) ||
+        !attrs_equal(branch[depth]->attrs, call->attrs) ||
+        branch[depth]->args.size() != call->args.size()) {
+      return false;
+    }
+
+    if (branch[depth]->args[parent_index].get() != branch[depth - 1])
+      return false;
+
+    // Check args
+    for (size_t i = 0; i < call->args.size(); i++) {
+      if (i == parent_index) continue;
+
+      if (!IsArgCompatible(call, branch[depth], i)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ParallelOpConcatCombiner::IsArgCompatible(const CallNode* a,
+                                               const CallNode* b,
+                                               size_t index) {
+  AttrsEqual eq;
+  auto ta = a->args[index]->type_as<TensorTypeNode>();
+  auto tb = b->args[index]->type_as<TensorTypeNode>();
+  auto toutput_a = a->type_as<TensorTypeNode>();
+  auto toutput_b = b->type_as<TensorTypeNode>();
+
+  if (!eq(ta->dtype, tb->dtype) || ta->shape.size() != tb->shape.size())
+    return false;
+
+  // Position of the 'C' dimension in the argument
+  size_t arg_channel_pos = channel_pos_ - toutput_a->shape.size() + ta->shape.size();
+
+  // Channel super-dimension shoule be present and not broadcasted
+  if ((arg_channel_pos > channel_pos_) ||  // size_t overflow
+      !eq(ta->shape[arg_channel_pos], toutput_a->shape[channel_pos_]) ||
+      !eq(tb->shape[arg_channel_pos], toutput_b->shape[channel_pos_]))
+    return false;
+
+  for (size_t i = 0; i < ta->shape.size(); i++) {
+    if (i == arg_channel_pos) continue;
+    if (!eq(ta->shape[i], tb->shape[i]))
+      return false;
+  }
+  return true;
+}
+
+Call ParallelOpConcatCombiner::MakeCombinedCallFromFollowingOps(const Expr& data,
+                                                                const Group& branches,
+                                                                size_t depth,
+                                                                size_t parent_index) {
+  Array<Expr> new_args;
+  const CallNode* call = branches[0][depth];
+  size_t ndim = call->type_as<TensorTypeNode>()->shape.size();
+
+  for (size_t i = 0; i < call->args.size(); i++) {
+    if (i == parent_index) {
+      new_args.push_back(data);
+      continue;
+    }
+    size_t arg_ndim = call->args[i]->type_as<TensorTypeNode>()->shape.size();
+    size_t arg_channel_pos = channel_pos_ - ndim + arg_ndim;
+    Array<Expr> tuple;
+    for (const auto& branch : branches) {
+      tuple.push_back(branch[depth]->args[i]);
+    }
+    auto concat = MakeConcatenate(TupleNode::make(tuple), arg_channel_pos);
+    new_args.push_back(std::move(concat));
+  }
+  return CallNode::make(call->op, new_args, call->attrs, {});
+}
+
+void ParallelOpConcatCombiner::UpdateGroupOutput(const Expr& data,
+                                                 const Group& branches,
+                                                 size_t depth,
+                                                 ExprSubstMap* subst_map) {
+  int64_t index = 0;
+  for (const auto& branch : branches) {
+    int64_t channels = GetNumChannels(branch[0]);
+    Array<Integer> begin;
+    Array<Integer> end;
+    for (size_t i = 0; i < channel_pos_; i++) {
+      begin.push_back(0);
+      end.push_back(NullValue<Integer>());
+    }
+    begin.push_back(index);
+    index += channels;
+    end.push_back(index);
+    auto slice = MakeStridedSlice(data, std::move(begin), std::move(end), Array<Integer>{});
+    (*subst_map)[GetRef<Expr>(branch[depth])] = slice;
+  }
+}
+
+}  // namespace relay
+}  // namespace tvm
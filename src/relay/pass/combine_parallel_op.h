@@ -0,0 +1,198 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file combine_parallel_op.h
+ * \brief Abstract class to combine parallel ops and their successive element-wise ops.
+ *
+ * Parallel branches start with the same op on a shared input, and can be followed by
+ * zero or more element-wise or broadcast ops. The branches are grouped by the
+ * compatibility of their first op, and the groups with enough branches are replaced
+ * by a single combined op, whose output is sliced back into the branches.
+ */
+#ifndef TVM_RELAY_PASS_COMBINE_PARALLEL_OP_H_
+#define TVM_RELAY_PASS_COMBINE_PARALLEL_OP_H_
+
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+using Branch = std::vector<const CallNode*>;
+using Group = std::vector<Branch>;
+using FIsSupportedOp = std::function<bool (const CallNode* n)>;
+using FAreCompatibleOps = std::function<bool (const CallNode* a, const CallNode* b)>;
+using ExprSubstMap = std::unordered_map<Expr, Expr, NodeHash, NodeEqual>;
+
+/*
+  Find parallel branches starting with the op as shown below and then group branches by
+  the compatibility of the op. The op can be followed by zero or more elemwise or broadcast
+  ops. Intermediate nodes have exactly one successor. It is possible that branches meet at
+  a point, which should be handled in ParallelOpCombiner.
+
+         data
+        /    \
+      op      op
+      |        |
+  elem-wise elem-wise
+      |        |
+*/
+class BranchGroupFinder : private ExprVisitor {
+ public:
+  /*!
+   * \brief Constructor
+   * \param op The op that indicates the start of each group
+   * \param fis_supported_op Function that returns true if the op is supported
+   * \param fare_compatible_ops Function that returns true if the two ops can be combined
+   */
+  BranchGroupFinder(const Op& op,
+                    FIsSupportedOp fis_supported_op,
+                    FAreCompatibleOps fare_compatible_ops);
+
+  /*!
+   * \brief Find the groups of parallel branches.
+   * \param expr The expression.
+   * \return The groups, the branches of a group start with compatible ops.
+   */
+  std::vector<Group> Find(const Expr& expr);
+
+ private:
+  /*! \brief The op that starts the branches */
+  const Op& op_;
+  /*! \brief Whether the op is supported */
+  FIsSupportedOp fis_supported_op_;
+  /*! \brief Whether two ops can be combined */
+  FAreCompatibleOps fare_compatible_ops_;
+  /*! \brief The inputs shared by the supported ops */
+  std::unordered_set<Expr, NodeHash, NodeEqual> op_roots_;
+  /*! \brief The consumers of each expression */
+  std::unordered_map<Expr, std::vector<const CallNode*>, NodeHash, NodeEqual> children_map_;
+
+  // Create a branch starting from op.
+  Branch CreateBranch(const CallNode* op);
+
+  void VisitExpr_(const CallNode* n) final;
+};
+
+/*!
+ * \brief Base class of the parallel op combiners.
+ *  Subclasses define how the first ops of the branches and the
+ *  element-wise ops that follow are combined.
+ */
+class ParallelOpCombiner {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param op_name The name of the op that starts the branches.
+   * \param min_num_branches The minimum number of branches to combine.
+   */
+  explicit ParallelOpCombiner(const std::string& op_name, uint64_t min_num_branches);
+
+  virtual ~ParallelOpCombiner() {}
+
+  /*!
+   * \brief Combine the parallel branches of the expression.
+   * \param expr The expression.
+   * \return The transformed expression.
+   */
+  Expr Combine(const Expr& expr);
+
+ protected:
+  /*! \brief Whether the op can start a branch */
+  virtual bool IsSupportedOp(const CallNode* n) = 0;
+
+  /*! \brief Whether the first ops of two branches can be combined */
+  virtual bool CanOpsBeCombined(const CallNode* a, const CallNode* b) = 0;
+
+  /*! \brief Make the combined op from the first ops of the branches */
+  virtual Call MakeCombinedOp(const Group& branches) = 0;
+
+  /*!
+   * \brief Whether the index-th arguments of two element-wise ops at the same depth
+   *  can be combined.
+   */
+  virtual bool IsArgCompatible(const CallNode* a, const CallNode* b, size_t index) = 0;
+
+  /*! \brief Whether the element-wise op following the first ops can be combined */
+  virtual bool IsSupportedFollowingOp(const CallNode* n) { return true; }
+
+  /*!
+   * \brief Make the combined element-wise op at the given depth.
+   * \param data The combined output of the previous depth.
+   * \param branches The branches.
+   * \param depth The depth of the op.
+   * \param parent_index The index of the argument produced by the previous depth.
+   * \return The combined call.
+   */
+  virtual Call MakeCombinedCallFromFollowingOps(const Expr& data,
+                                                const Group& branches,
+                                                size_t depth,
+                                                size_t parent_index) = 0;
+
+  /*!
+   * \brief Slice the combined output into the output of each branch.
+   * \param data The combined output.
+   * \param branches The branches.
+   * \param depth The depth of the last combined op.
+   * \param subst_map The substitution of the outputs of the branches.
+   */
+  virtual void UpdateGroupOutput(const Expr& data,
+                                 const Group& branches,
+                                 size_t depth,
+                                 ExprSubstMap* subst_map) = 0;
+
+ private:
+  /*! \brief The op that starts the branches */
+  const Op& cached_op_;
+  /*! \brief The minimum number of branches of a group */
+  uint64_t min_num_branches_;
+  /*! \brief The substitution of the outputs of the combined branches */
+  ExprSubstMap subst_map_;
+
+  // Combine branches in a group. The first ops in the same group are safe to
+  // combine. Subsequent ops may or may not be combined. We start from the first
+  // op and try to combine ops from all branches in the same depth.
+  void CombineBranches(const Group& branches);
+
+  // Check if ops in depth-th level can be combined.
+  bool CheckLevel(const Group& branches, size_t depth, size_t parent_index);
+};
+
+/*!
+ * \brief Combiner that concatenates the outputs of the branches along
+ *  the channel axis, e.g. the output channels of conv2d or the units of dense.
+ */
+class ParallelOpConcatCombiner : public ParallelOpCombiner {
+ public:
+  ParallelOpConcatCombiner(const std::string& op_name, uint64_t min_num_branches)
+      : ParallelOpCombiner(op_name, min_num_branches) {}
+
+ protected:
+  /*! \brief The number of channels produced by the first op of a branch */
+  virtual int64_t GetNumChannels(const CallNode* n) = 0;
+
+  bool IsArgCompatible(const CallNode* a, const CallNode* b, size_t index) final;
+
+  Call MakeCombinedCallFromFollowingOps(const Expr& data,
+                                        const Group& branches,
+                                        size_t depth,
+                                        size_t parent_index) final;
+
+  void UpdateGroupOutput(const Expr& data,
+                         const Group& branches,
+                         size_t depth,
+                         ExprSubstMap* subst_map) final;
+
+  /*! \brief The channel axis of the output, set by MakeCombinedOp */
+  size_t channel_pos_{0};
+};
+
+}  // namespace relay
+}  // namespace tvm
+#endif  // TVM_RELAY_PASS_COMBINE_PARALLEL_OP_H_
@@ -0,0 +1,165 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file combine_parallel_op_batch.cc
+ * \brief Combine parallel element-wise ops into a single batched op.
+ *
+ * This pass replaces element-wise or broadcast ops without attributes that
+ * share the same first input with a single op. The other inputs of the branches are stacked along
+ * a new leading axis, the shared input is broadcast over it, and each branch
+ * takes its slice of the output. Elemwise and broadcast ops without attributes
+ * following the op are also combined if possible.
+ *
+ *         data                        data
+ *        /    \                        |
+ *   add(b0)  add(b1)      ->   add(stack(b0, b1))
+ *      |        |                   /        \
+ *   mul(s0)  mul(s1)          mul(stack(s0, s1))
+ *                               /        \
+ *                          slice 0    slice 1
+ */
+
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/op_attr_types.h>
+#include <string>
+#include "./pattern_util.h"
+#include "./combine_parallel_op.h"
+
+
+namespace tvm {
+namespace relay {
+
+Expr MakeExpandDims(Expr data, int axis, int num_newaxis);
+
+Expr MakeSqueeze(Expr data, Array<Integer> axis);
+
+class ParallelOpBatchCombiner : public ParallelOpCombiner {
+ public:
+  ParallelOpBatchCombiner(const std::string& op_name, uint64_t min_num_branches)
+      : ParallelOpCombiner(op_name, min_num_branches) {}
+
+ protected:
+  // The attributes, such as the axis of bias_add or expand_dims, refer to the
+  // dimensions of the unbatched inputs, so only the ops without them are combined.
+  bool IsSupportedOp(const CallNode* n) final {
+    static auto fpattern = Op::GetAttr<TOpPattern>("TOpPattern");
+    return n->args.size() > 1 && !n->attrs.defined() &&
+        fpattern[Downcast<Op>(n->op)] <= kBroadcast;
+  }
+
+  bool IsSupportedFollowingOp(const CallNode* n) final {
+    return !n->attrs.defined();
+  }
+
+  // The ops are combined when their other inputs have the same types.
+  bool CanOpsBeCombined(const CallNode* a, const CallNode* b) final {
+    AttrsEqual eq;
+    if (!eq(a->attrs, b->attrs) || a->args.size() != b->args.size()) return false;
+    for (size_t i = 1; i < a->args.size(); i++) {
+      if (!IsArgCompatible(a, b, i)) return false;
+    }
+    return true;
+  }
+
+  Call MakeCombinedOp(const Group& branches) final {
+    return MakeCombinedCall(branches[0][0]->args[0], branches, 0, 0);
+  }
+
+  bool IsArgCompatible(const CallNode* a, const CallNode* b, size_t index) final {
+    AttrsEqual eq;
+    auto ta = a->args[index]->type_as<TensorTypeNode>();
+    auto tb = b->args[index]->type_as<TensorTypeNode>();
+    if (!eq(ta->dtype, tb->dtype) || ta->shape.size() != tb->shape.size()) return false;
+    for (size_t i = 0; i < ta->shape.size(); i++) {
+      if (!eq(ta->shape[i], tb->shape[i])) return false;
+    }
+    return eq(a->type_as<TensorTypeNode>()->shape, b->type_as<TensorTypeNode>()->shape);
+  }
+
+  Call MakeCombinedCallFromFollowingOps(const Expr& data,
+                                        const Group& branches,
+                                        size_t depth,
+                                        size_t parent_index) final {
+    return MakeCombinedCall(data, branches, depth, parent_index);
+  }
+
+  // Take the slice of each branch and drop the batch axis.
+  void UpdateGroupOutput(const Expr& data,
+                         const Group& branches,
+                         size_t depth,
+                         ExprSubstMap* subst_map) final {
+    int64_t index = 0;
+    for (const auto& branch : branches) {
+      Array<Integer> begin{Integer(index)};
+      Array<Integer> end{Integer(index + 1)};
+      auto slice = MakeStridedSlice(data, std::move(begin), std::move(end), Array<Integer>{});
+      (*subst_map)[GetRef<Expr>(branch[depth])] = MakeSqueeze(slice, Array<Integer>{Integer(0)});
+      ++index;
+    }
+  }
+
+ private:
+  // Make the op on the batched inputs. The input at parent_index is the shared
+  // root at depth 0 and the batched output of the previous depth afterwards.
+  // The other inputs are stacked on a new leading axis after being expanded
+  // to the rank of the output, unless all branches use the same input after
+  // depth 0, which is then broadcast.
+  Call MakeCombinedCall(const Expr& data,
+                        const Group& branches,
+                        size_t depth,
+                        size_t parent_index) {
+    const CallNode* call = branches[0][depth];
+    int ndim = static_cast<int>(call->type_as<TensorTypeNode>()->shape.size());
+    Array<Expr> new_args;
+    for (size_t i = 0; i < call->args.size(); i++) {
+      if (i == parent_index) {
+        int data_ndim = depth == 0 ? ndim :
+            static_cast<int>(branches[0][depth - 1]->type_as<TensorTypeNode>()->shape.size());
+        if (data_ndim < ndim) {
+          // keep the batch axis in front
+          new_args.push_back(MakeExpandDims(data, 1, ndim - data_ndim));
+        } else {
+          new_args.push_back(data);
+        }
+        continue;
+      }
+      bool shared = depth != 0;
+      for (const auto& branch : branches) {
+        shared &= branch[depth]->args[i].same_as(call->args[i]);
+      }
+      if (shared) {
+        new_args.push_back(call->args[i]);
+        continue;
+      }
+      int arg_ndim = static_cast<int>(call->args[i]->type_as<TensorTypeNode>()->shape.size());
+      Array<Expr> tuple;
+      for (const auto& branch : branches) {
+        Expr arg = branch[depth]->args[i];
+        if (arg_ndim < ndim) {
+          arg = MakeExpandDims(arg, 0, ndim - arg_ndim);
+        }
+        tuple.push_back(MakeExpandDims(arg, 0, 1));
+      }
+      new_args.push_back(MakeConcatenate(TupleNode::make(tuple), 0));
+    }
+    return CallNode::make(call->op, new_args, call->attrs, {});
+  }
+};
+
+Expr CombineParallelOpBatch(const Expr& expr,
+                            const std::string& op_name,
+                            uint64_t min_num_branches) {
+  return ParallelOpBatchCombiner(op_name, min_num_branches).Combine(expr);
+}
+
+TVM_REGISTER_API("relay._ir_pass.CombineParallelOpBatch")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+  std::string op_name = args[1];
+  int64_t min_num_branches = args[2];
+  *ret = CombineParallelOpBatch(args[0], op_name, min_num_branches);
+});
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,102 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ *
+ * \file eliminate_common_subexpr.cc
+ * \brief Combine common subexpressions.
+ *
+ * This is an optimization pass that eliminates common subexpressions. During the pass, it tries
+ * to replace an expression with a previously appeared expression with the same input and
+ * attributes.
+ *
+ * The calls are visited in post-DFS order, so the arguments of two equivalent calls
+ * are already the same node once they are visited. A call is then looked up by its op,
+ * the identity of its arguments and the hash of its attributes. Constant arguments are
+ * compared by their structural hash, so equal constants created separately still match.
+ */
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+class CommonSubexprEliminator : public ExprMutator {
+ public:
+  Expr VisitExpr_(const CallNode* call) final {
+    static auto op_stateful = Op::GetAttr<TOpIsStateful>("TOpIsStateful");
+    Expr new_expr = ExprMutator::VisitExpr_(call);
+    const CallNode* new_call = new_expr.as<CallNode>();
+    CHECK(new_call);
+    const OpNode* op = new_call->op.as<OpNode>();
+    if (new_call->args.size() == 0 || op == nullptr ||
+        op_stateful.get(GetRef<Op>(op), false)) {
+      return new_expr;
+    }
+
+    std::vector<Call>& bucket = expr_map_[Hash(new_call)];
+    for (const Call& candidate : bucket) {
+      if (IsEquivalent(new_call, candidate.operator->())) {
+        return candidate;
+      }
+    }
+    bucket.push_back(GetRef<Call>(new_call));
+    return new_expr;
+  }
+
+ private:
+  // Hash of the argument: identity, or structure for constants.
+  size_t ArgHash(const Expr& arg) {
+    if (arg.as<ConstantNode>()) {
+      return hash_(arg);
+    }
+    return std::hash<const Node*>()(arg.get());
+  }
+
+  size_t Hash(const CallNode* call) {
+    size_t hash = std::hash<const Node*>()(call->op.get());
+    for (const Expr& arg : call->args) {
+      hash = dmlc::HashCombine(hash, ArgHash(arg));
+    }
+    return dmlc::HashCombine(hash, attrs_hash_(call->attrs));
+  }
+
+  bool IsEquivalent(const CallNode* lhs, const CallNode* rhs) {
+    if (!lhs->op.same_as(rhs->op) ||
+        lhs->args.size() != rhs->args.size() ||
+        lhs->type_args.size() != rhs->type_args.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs->args.size(); ++i) {
+      const Expr& a = lhs->args[i];
+      const Expr& b = rhs->args[i];
+      if (a.same_as(b)) continue;
+      if (!(a.as<ConstantNode>() && b.as<ConstantNode>() && AlphaEqual(a, b))) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < lhs->type_args.size(); ++i) {
+      if (!AlphaEqual(lhs->type_args[i], rhs->type_args[i])) return false;
+    }
+    return attrs_equal_(lhs->attrs, rhs->attrs);
+  }
+
+  /*! \brief The calls seen so far, bucketed by hash. */
+  std::unordered_map<size_t, std::vector<Call> > expr_map_;
+  StructuralHash hash_;
+  AttrsHash attrs_hash_;
+  AttrsEqual attrs_equal_;
+};
+
+Expr EliminateCommonSubexpr(const Expr& expr) {
+  return CommonSubexprEliminator().Mutate(expr);
+}
+
+TVM_REGISTER_API("relay._ir_pass.eliminate_common_subexpr")
+.set_body([](TVMArgs args, TVMRetValue* ret) {
+    *ret = EliminateCommonSubexpr(args[0]);
+  });
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,521 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ *
+ * \file quantize.cc
+ *
+ * \brief transform a graph to a low-bit graph
+ *   for compression and acceleration.
+ *
+ *  The flow has three steps:
+ *  - annotate: insert simulated_quantize before the inputs and
+ *    weights of conv2d/dense and the elementwise ops between them.
+ *  - calibrate (python): bind the scale and clip range of each
+ *    simulated_quantize as constants.
+ *  - realize: replace simulated_quantize by integer arithmetic,
+ *    so conv2d/dense take int8 operands and accumulate in int32,
+ *    and requantization (shift, clip, cast) fuses into the producer.
+ */
+#include <tvm/relay/pass.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/attrs/transform.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "pattern_util.h"
+#include "quantize.h"
+
+namespace tvm {
+namespace relay {
+namespace quantize {
+
+/*! \brief Attribute for annotation rewrite */
+using FQAnnotateRewrite = FForwardRewrite;
+
+/*! \brief Attribute for realize rewrite */
+using FQRealizeRewrite = FForwardRewrite;
+
+TVM_REGISTER_NODE_TYPE(SimulatedQuantizeAttrs);
+TVM_REGISTER_NODE_TYPE(QConfigNode);
+
+bool SimulatedQuantizeRel(const Array<Type>& types,
+                          int num_inputs,
+                          const Attrs& attrs,
+                          const TypeReporter& reporter) {
+  CHECK_EQ(types.size(), 5);
+  const auto param = attrs.as<SimulatedQuantizeAttrs>();
+  CHECK(param != nullptr);
+
+  const auto* data = types[0].as<TensorTypeNode>();
+  if (data == nullptr) return false;
+  CHECK_NE(data->shape.size(), 0) << "Input shape cannot be empty";
+
+  reporter->Assign(types[1], TensorTypeNode::make({}, Float(32)));  // dom_scale
+  reporter->Assign(types[2], TensorTypeNode::make({}, Float(32)));  // clip_min
+  reporter->Assign(types[3], TensorTypeNode::make({}, Float(32)));  // clip_max
+  reporter->Assign(types[4], types[0]);                             // output
+  return true;
+}
+
+Expr MakeSimulatedQuantize(Expr data,
+                           Expr dom_scale,
+                           Expr clip_min,
+                           Expr clip_max,
+                           int kind,
+                           bool sign,
+                           std::string rounding) {
+  auto attrs = make_node<SimulatedQuantizeAttrs>();
+  attrs->kind = kind;
+  attrs->sign = sign;
+  attrs->rounding = rounding;
+  static const Op& op = Op::Get("relay.op.annotation.simulated_quantize");
+  return CallNode::make(op, {data, dom_scale, clip_min, clip_max}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_API("relay._quantize.simulated_quantize")
+.set_body_typed<Expr(Expr, Expr, Expr, Expr, int, bool, std::string)>(
+    MakeSimulatedQuantize);
+
+RELAY_REGISTER_OP("relay.op.annotation.simulated_quantize")
+.describe(R"code(Simulate the quantize and dequantize of the data.
+The output is the input rounded to the integer grid of dom_scale
+and clipped to [clip_min, clip_max] on that grid.
+)code" TVM_ADD_FILELINE)
+.set_num_inputs(4)
+.add_argument("data", "Tensor", "The input data.")
+.add_argument("dom_scale", "Tensor", "The domain scale of input data. It should be a scalar")
+.add_argument("clip_min", "Tensor", "lower bound. It should be a scalar")
+.add_argument("clip_max", "Tensor", "upper bound. It should be a scalar")
+.set_attrs_type_key("relay.attrs.SimulatedQuantizeAttrs")
+.set_support_level(10)
+.add_type_rel("SimulatedQuantize", SimulatedQuantizeRel);
+
+
+// =============
+// annotate pass
+
+QAnnotateExpr QAnnotateExprNode::make(Expr expr, int kind) {
+  auto rnode = make_node<QAnnotateExprNode>();
+  rnode->expr = expr;
+  rnode->kind = kind;
+  return QAnnotateExpr(rnode);
+}
+
+Expr QAnnotateExprNode::Realize() const {
+  return expr;
+}
+
+TVM_REGISTER_API("relay._quantize.make_annotate_expr")
+.set_body_typed<QAnnotateExpr(Expr, int)>(QAnnotateExprNode::make);
+
+/*!
+ * \brief Get the expression and the kind of an argument of the annotation pass.
+ * \param arg The new argument.
+ * \param kind The kind, set to 0 if the argument is not annotated.
+ * \return The original expression.
+ */
+inline Expr GetAnnotated(const Expr& arg, int* kind) {
+  if (const auto* n = arg.as<QAnnotateExprNode>()) {
+    *kind = n->kind;
+    return n->expr;
+  }
+  *kind = 0;
+  return arg;
+}
+
+/*!
+ * \brief Insert simulated_quantize of the given kind after data.
+ *  The scale and the clip range are free variables bound by the calibration.
+ */
+Expr AttachSimulatedQuantize(const Expr& data, int kind) {
+  static const Op& op = Op::Get("relay.op.annotation.simulated_quantize");
+  if (const auto* call = data.as<CallNode>()) {
+    if (call->op.same_as(op) &&
+        call->attrs.as<SimulatedQuantizeAttrs>()->kind == kind) {
+      return data;
+    }
+  }
+  Var dom_scale = VarNode::make("dom_scale", Type());
+  Var clip_min = VarNode::make("clip_min", Type());
+  Var clip_max = VarNode::make("clip_max", Type());
+  return MakeSimulatedQuantize(data, dom_scale, clip_min, clip_max, kind, true, "round");
+}
+
+// The skipped conv2d get an undefined context.
+Expr Conv2dDenseAnnotateRewrite(const Call& ref_call,
+                                const Array<Expr>& new_args,
+                                const NodeRef& ctx) {
+  if (!ctx.defined()) return Expr(nullptr);
+  int lhs_kind, rhs_kind;
+  Expr lhs = GetAnnotated(new_args[0], &lhs_kind);
+  Expr rhs = GetAnnotated(new_args[1], &rhs_kind);
+  if (lhs_kind != kQInput) {
+    lhs = AttachSimulatedQuantize(lhs, kQInput);
+  }
+  rhs = AttachSimulatedQuantize(rhs, kQWeight);
+  Expr ret = CallNode::make(ref_call->op, {lhs, rhs}, ref_call->attrs, ref_call->type_args);
+  return QAnnotateExprNode::make(ret, kQActivation);
+}
+
+RELAY_REGISTER_OP("nn.conv2d")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", Conv2dDenseAnnotateRewrite);
+
+RELAY_REGISTER_OP("nn.dense")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", Conv2dDenseAnnotateRewrite);
+
+Expr MultiplyAnnotateRewrite(const Call& ref_call,
+                             const Array<Expr>& new_args,
+                             const NodeRef& ctx) {
+  int lhs_kind, rhs_kind;
+  Expr lhs = GetAnnotated(new_args[0], &lhs_kind);
+  Expr rhs = GetAnnotated(new_args[1], &rhs_kind);
+  if (lhs_kind == 0 && rhs_kind == 0) return Expr(nullptr);
+  if (lhs_kind != kQInput) {
+    lhs = AttachSimulatedQuantize(lhs, kQInput);
+  }
+  if (rhs_kind == 0 && rhs.as<ConstantNode>()) {
+    rhs = AttachSimulatedQuantize(rhs, kQWeight);
+  } else if (rhs_kind != kQInput) {
+    rhs = AttachSimulatedQuantize(rhs, kQInput);
+  }
+  Expr ret = CallNode::make(ref_call->op, {lhs, rhs}, ref_call->attrs, ref_call->type_args);
+  return QAnnotateExprNode::make(ret, kQActivation);
+}
+
+RELAY_REGISTER_OP("multiply")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", MultiplyAnnotateRewrite);
+
+// The annotated operands stay in the accumulation type,
+// the realization unifies their scales.
+Expr AddAnnotateRewrite(const Call& ref_call,
+                        const Array<Expr>& new_args,
+                        const NodeRef& ctx) {
+  int lhs_kind, rhs_kind;
+  Expr lhs = GetAnnotated(new_args[0], &lhs_kind);
+  Expr rhs = GetAnnotated(new_args[1], &rhs_kind);
+  if (lhs_kind == 0 && rhs_kind == 0) return Expr(nullptr);
+  if (lhs_kind == 0) {
+    lhs = AttachSimulatedQuantize(lhs, lhs.as<ConstantNode>() ? kQWeight : kQInput);
+  }
+  if (rhs_kind == 0) {
+    rhs = AttachSimulatedQuantize(rhs, rhs.as<ConstantNode>() ? kQWeight : kQInput);
+  }
+  Expr ret = CallNode::make(ref_call->op, {lhs, rhs}, ref_call->attrs, ref_call->type_args);
+  return QAnnotateExprNode::make(ret, kQActivation);
+}
+
+RELAY_REGISTER_OP("add")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", AddAnnotateRewrite);
+
+// Operators that commute with the quantization keep the annotation.
+Expr IdentityAnnotateRewrite(const Call& ref_call,
+                             const Array<Expr>& new_args,
+                             const NodeRef& ctx) {
+  CHECK_EQ(new_args.size(), 1);
+  int kind;
+  Expr data = GetAnnotated(new_args[0], &kind);
+  if (kind == 0) return Expr(nullptr);
+  Expr ret = CallNode::make(ref_call->op, {data}, ref_call->attrs, ref_call->type_args);
+  return QAnnotateExprNode::make(ret, kind);
+}
+
+RELAY_REGISTER_OP("nn.relu")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", IdentityAnnotateRewrite);
+
+RELAY_REGISTER_OP("nn.max_pool2d")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", IdentityAnnotateRewrite);
+
+RELAY_REGISTER_OP("nn.avg_pool2d")
+.set_attr<FQAnnotateRewrite>("FQAnnotateRewrite", IdentityAnnotateRewrite);
+
+Expr QuantizeAnnotate(const Expr& expr, const Attrs& cfg) {
+  const auto* param = cfg.as<QConfigNode>();
+  CHECK(param != nullptr);
+  static const Op& conv2d = Op::Get("nn.conv2d");
+  // the calls are visited in post-DFS order,
+  // so the first convolutions are visited first.
+  int conv2d_counter = 0;
+  auto fcontext = [&](const Call& call) -> NodeRef {
+    if (call->op.same_as(conv2d) && ++conv2d_counter <= param->skip_k_conv) {
+      return NodeRef(nullptr);
+    }
+    return cfg;
+  };
+  return ForwardRewrite(expr, "FQAnnotateRewrite", fcontext);
+}
+
+TVM_REGISTER_API("relay._quantize.annotate")
+.set_body_typed<Expr(Expr, Attrs)>(QuantizeAnnotate);
+
+
+// =============
+// realize pass
+
+QRealizeIntExpr QRealizeIntExprNode::make(Expr data, Expr dom_scale, DataType dtype) {
+  NodePtr<QRealizeIntExprNode> n = make_node<QRealizeIntExprNode>();
+  n->data = std::move(data);
+  n->dom_scale = std::move(dom_scale);
+  n->dtype = std::move(dtype);
+  return QRealizeIntExpr(n);
+}
+
+Expr QRealizeIntExprNode::Realize() const {
+  Expr data = this->data;
+  if (dtype != Float(32)) {
+    data = Cast(data, Float(32));
+  }
+  return Multiply(data, dom_scale);
+}
+
+/*!
+ * \brief Rescale integer data from scale s1 to scale s2 <= s1.
+ *  A power of two ratio becomes a shift, an integer ratio a multiplication,
+ *  other ratios are applied in float and rounded back to dtype.
+ */
+inline Expr MulAndDiv(Expr data, float s1, float s2, DataType dtype) {
+  float factor = s1 / s2;
+  float shift_factor = std::log2(factor);
+  CHECK_GE(shift_factor, 0);
+  if (shift_factor == 0) {
+    return data;
+  } else if (static_cast<int>(shift_factor) == shift_factor) {
+    return LeftShift(data, MakeConstantScalar(dtype, static_cast<int>(shift_factor)));
+  } else if (static_cast<int>(factor) == factor) {
+    return Multiply(data, MakeConstantScalar(dtype, static_cast<int>(factor)));
+  } else {
+    data = Multiply(Cast(data, Float(32)), MakeConstantScalar(Float(32), factor));
+    return Cast(Round(data), dtype);
+  }
+}
+
+Expr SimulatedQuantizeRealize(const Call& ref_call,
+                              const Array<Expr>& new_args,
+                              const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 4);
+  const auto* param = ref_call->attrs.as<SimulatedQuantizeAttrs>();
+  CHECK_EQ(param->rounding, "round");
+
+  Expr dom_scale = new_args[1];
+  float dom_scale_imm = GetScalarFromConstant<float>(dom_scale);
+  float clip_min_imm = GetScalarFromConstant<float>(new_args[2]);
+  float clip_max_imm = GetScalarFromConstant<float>(new_args[3]);
+
+  if (const auto* n = new_args[0].as<QRealizeIntExprNode>()) {
+    // requantize from the accumulation domain
+    Expr data = n->data;
+    float idom_scale_imm = GetScalarFromConstant<float>(n->dom_scale);
+    float odom_scale_imm = dom_scale_imm;
+    if (idom_scale_imm == odom_scale_imm) {
+      // same domain scale, only clip
+      data = Clip(data, clip_min_imm, clip_max_imm);
+      return QRealizeIntExprNode::make(data, dom_scale, n->dtype);
+    }
+    float shift_nbit = std::log2(odom_scale_imm / idom_scale_imm);
+    if (n->dtype.is_int() && static_cast<int>(shift_nbit) == shift_nbit) {
+      if (shift_nbit > 0) {
+        if (cfg->round_for_shift) {
+          float round_bias = std::pow(2.0, shift_nbit - 1);
+          data = Add(data, MakeConstantScalar(n->dtype, static_cast<int>(round_bias)));
+        }
+        data = RightShift(data, MakeConstantScalar(n->dtype, static_cast<int>(shift_nbit)));
+      } else {
+        data = LeftShift(data, MakeConstantScalar(n->dtype, static_cast<int>(-shift_nbit)));
+      }
+      data = Clip(data, clip_min_imm, clip_max_imm);
+      return QRealizeIntExprNode::make(data, dom_scale, n->dtype);
+    }
+    // float computation
+    if (n->dtype != Float(32)) {
+      data = Cast(data, Float(32));
+    }
+    Expr scaled_data = Multiply(
+        data, MakeConstantScalar(Float(32), idom_scale_imm / odom_scale_imm));
+    Expr round_data = Clip(Round(scaled_data), clip_min_imm, clip_max_imm);
+    return QRealizeIntExprNode::make(round_data, dom_scale, Float(32));
+  }
+
+  // quantize from real
+  CHECK(!new_args[0]->derived_from<TempExprNode>());
+  Expr data = new_args[0];
+  Expr scaled_data = Multiply(data, MakeConstantScalar(Float(32), 1 / dom_scale_imm));
+  Expr round_data = Clip(Round(scaled_data), clip_min_imm, clip_max_imm);
+  return QRealizeIntExprNode::make(round_data, dom_scale, Float(32));
+}
+
+RELAY_REGISTER_OP("relay.op.annotation.simulated_quantize")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", SimulatedQuantizeRealize);
+
+/*! \brief The scale of the product of two realized operands. */
+inline Expr MulDomScale(const QRealizeIntExprNode* lhs, const QRealizeIntExprNode* rhs) {
+  float scale = GetScalarFromConstant<float>(lhs->dom_scale) *
+      GetScalarFromConstant<float>(rhs->dom_scale);
+  return MakeConstantScalar(Float(32), scale);
+}
+
+Expr Conv2dRealize(const Call& ref_call,
+                   const Array<Expr>& new_args,
+                   const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 2);
+  const auto* lhs = new_args[0].as<QRealizeIntExprNode>();
+  const auto* rhs = new_args[1].as<QRealizeIntExprNode>();
+  if (lhs == nullptr || rhs == nullptr) return Expr(nullptr);
+
+  Expr ldata = lhs->data;
+  if (lhs->dtype != cfg->dtype_input) {
+    ldata = Cast(ldata, cfg->dtype_input);
+  }
+  Expr rdata = Cast(rhs->data, cfg->dtype_weight);
+
+  const auto ref_attrs = ref_call->attrs.as<Conv2DAttrs>();
+  auto attrs = make_node<Conv2DAttrs>();
+  *attrs = *ref_attrs;
+  attrs->out_dtype = cfg->dtype_activation;
+
+  Expr ret = CallNode::make(ref_call->op,
+    {ldata, rdata}, Attrs(attrs), ref_call->type_args);
+  return QRealizeIntExprNode::make(ret, MulDomScale(lhs, rhs), cfg->dtype_activation);
+}
+
+RELAY_REGISTER_OP("nn.conv2d")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", Conv2dRealize);
+
+// dense has no out_dtype, the operands are widened to the
+// accumulation type; the weight cast is folded into the constant.
+Expr DenseRealize(const Call& ref_call,
+                  const Array<Expr>& new_args,
+                  const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 2);
+  const auto* lhs = new_args[0].as<QRealizeIntExprNode>();
+  const auto* rhs = new_args[1].as<QRealizeIntExprNode>();
+  if (lhs == nullptr || rhs == nullptr) return Expr(nullptr);
+
+  Expr ldata = Cast(lhs->data, cfg->dtype_activation);
+  Expr rdata = Cast(rhs->data, cfg->dtype_activation);
+  Expr ret = CallNode::make(ref_call->op,
+    {ldata, rdata}, ref_call->attrs, ref_call->type_args);
+  return QRealizeIntExprNode::make(ret, MulDomScale(lhs, rhs), cfg->dtype_activation);
+}
+
+RELAY_REGISTER_OP("nn.dense")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", DenseRealize);
+
+Expr MulRealize(const Call& ref_call,
+                const Array<Expr>& new_args,
+                const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 2);
+  const auto* lhs = new_args[0].as<QRealizeIntExprNode>();
+  const auto* rhs = new_args[1].as<QRealizeIntExprNode>();
+  if (lhs == nullptr || rhs == nullptr) return Expr(nullptr);
+
+  Expr ldata = lhs->data;
+  Expr rdata = rhs->data;
+  DataType dtype = cfg->dtype_activation;
+  if (lhs->dtype != dtype) {
+    ldata = Cast(ldata, dtype);
+  }
+  if (rhs->dtype != dtype) {
+    rdata = Cast(rdata, dtype);
+  }
+  Expr ret = CallNode::make(ref_call->op,
+    {ldata, rdata}, ref_call->attrs, ref_call->type_args);
+  return QRealizeIntExprNode::make(ret, MulDomScale(lhs, rhs), dtype);
+}
+
+RELAY_REGISTER_OP("multiply")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", MulRealize);
+
+// Bring both operands to the accumulation type and the finer scale.
+Expr AddRealize(const Call& ref_call,
+                const Array<Expr>& new_args,
+                const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 2);
+  const auto* lhs = new_args[0].as<QRealizeIntExprNode>();
+  const auto* rhs = new_args[1].as<QRealizeIntExprNode>();
+  if (lhs == nullptr || rhs == nullptr) return Expr(nullptr);
+
+  DataType dtype = cfg->dtype_activation;
+  float lscale = GetScalarFromConstant<float>(lhs->dom_scale);
+  float rscale = GetScalarFromConstant<float>(rhs->dom_scale);
+  float scale = std::min(lscale, rscale);
+  Array<Expr> ret_args;
+  for (const auto* arg : {lhs, rhs}) {
+    Expr data = arg->data;
+    if (arg->dtype != dtype) {
+      data = Cast(data, dtype);
+    }
+    ret_args.push_back(
+        MulAndDiv(data, GetScalarFromConstant<float>(arg->dom_scale), scale, dtype));
+  }
+  Expr ret = CallNode::make(ref_call->op, ret_args, ref_call->attrs, ref_call->type_args);
+  return QRealizeIntExprNode::make(ret, MakeConstantScalar(Float(32), scale), dtype);
+}
+
+RELAY_REGISTER_OP("add")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", AddRealize);
+
+Expr IdentityRealize(const Call& ref_call,
+                     const Array<Expr>& new_args,
+                     const NodeRef& ctx) {
+  CHECK_EQ(new_args.size(), 1);
+  if (const auto* n = new_args[0].as<QRealizeIntExprNode>()) {
+    Expr ret = CallNode::make(ref_call->op,
+      {n->data}, ref_call->attrs, ref_call->type_args);
+    return QRealizeIntExprNode::make(ret, n->dom_scale, n->dtype);
+  }
+  CHECK(!new_args[0]->derived_from<TempExprNode>());
+  return Expr(nullptr);
+}
+
+RELAY_REGISTER_OP("nn.relu")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", IdentityRealize);
+
+RELAY_REGISTER_OP("nn.max_pool2d")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", IdentityRealize);
+
+// The sum of the window is computed in the accumulation type.
+Expr AvgPoolRealize(const Call& ref_call,
+                    const Array<Expr>& new_args,
+                    const NodeRef& ctx) {
+  const auto* cfg = ctx.as<QConfigNode>();
+  CHECK(cfg != nullptr);
+  CHECK_EQ(new_args.size(), 1);
+  if (const auto* n = new_args[0].as<QRealizeIntExprNode>()) {
+    Expr data = n->data;
+    if (n->dtype != cfg->dtype_activation) {
+      data = Cast(data, cfg->dtype_activation);
+    }
+    Expr ret = CallNode::make(ref_call->op,
+      {data}, ref_call->attrs, ref_call->type_args);
+    return QRealizeIntExprNode::make(ret, n->dom_scale, cfg->dtype_activation);
+  }
+  CHECK(!new_args[0]->derived_from<TempExprNode>());
+  return Expr(nullptr);
+}
+
+RELAY_REGISTER_OP("nn.avg_pool2d")
+.set_attr<FQRealizeRewrite>("FQRealizeRewrite", AvgPoolRealize);
+
+Expr QuantizeRealize(const Expr& expr, const Attrs& cfg) {
+  CHECK(cfg.as<QConfigNode>() != nullptr);
+  auto fcontext = [&](const Call& call) -> NodeRef {
+    return cfg;
+  };
+  return ForwardRewrite(expr, "FQRealizeRewrite", fcontext);
+}
+
+TVM_REGISTER_API("relay._quantize.realize")
+.set_body_typed<Expr(Expr, Attrs)>(QuantizeRealize);
+
+}  // namespace quantize
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,163 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file tvm/relay/pass/quantize.h
+ * \brief Header of definitions for quantization
+ */
+#ifndef TVM_RELAY_PASS_QUANTIZE_H_
+#define TVM_RELAY_PASS_QUANTIZE_H_
+
+#include <tvm/relay/op.h>
+#include <tvm/relay/expr.h>
+#include <string>
+#include "pattern_util.h"
+
+namespace tvm {
+namespace relay {
+namespace quantize {
+
+/*! \brief Kind of annotate field */
+enum QAnnotateKind : int {
+  kQInput = 1,
+  kQWeight = 2,
+  kQActivation = 3,
+};
+
+/*!
+ * \brief Attribute for simulated quantize operator.
+ *
+ *  The operator rounds the input to the integer grid given by
+ *  dom_scale and clips it to [clip_min, clip_max], so the float
+ *  graph carries the error of the quantized graph.
+ */
+struct SimulatedQuantizeAttrs : public tvm::AttrsNode<SimulatedQuantizeAttrs> {
+  int kind;
+  bool sign;
+  std::string rounding;
+
+  TVM_DECLARE_ATTRS(SimulatedQuantizeAttrs, "relay.attrs.SimulatedQuantizeAttrs") {
+    TVM_ATTR_FIELD(kind)
+        .describe("kind of field, hint for nbit/dtype configuration.");
+    TVM_ATTR_FIELD(sign).set_default(true)
+        .describe("whether to use signed data type.");
+    TVM_ATTR_FIELD(rounding).set_default("round")
+        .describe("rounding mode. Can be 'floor', 'ceil', 'round'");
+  }
+};
+
+/*!
+ * \brief The configuration of the quantization passes.
+ *  It is created by relay.quantize.qconfig in the frontend
+ *  and passed to the annotate and realize passes.
+ */
+struct QConfigNode : public tvm::AttrsNode<QConfigNode> {
+  int nbit_input;
+  int nbit_weight;
+  int nbit_activation;
+  DataType dtype_input;
+  DataType dtype_weight;
+  DataType dtype_activation;
+  double global_scale;
+  int skip_k_conv;
+  bool round_for_shift;
+
+  TVM_DECLARE_ATTRS(QConfigNode, "relay.quantize.QConfig") {
+    TVM_ATTR_FIELD(nbit_input).set_default(8)
+        .describe("Number of bits of the quantized inputs of conv2d and dense.");
+    TVM_ATTR_FIELD(nbit_weight).set_default(8)
+        .describe("Number of bits of the quantized weights.");
+    TVM_ATTR_FIELD(nbit_activation).set_default(32)
+        .describe("Number of bits of the accumulated activations.");
+    TVM_ATTR_FIELD(dtype_input).set_default(Int(8))
+        .describe("Data type of the quantized inputs.");
+    TVM_ATTR_FIELD(dtype_weight).set_default(Int(8))
+        .describe("Data type of the quantized weights.");
+    TVM_ATTR_FIELD(dtype_activation).set_default(Int(32))
+        .describe("Data type of the accumulated activations.");
+    TVM_ATTR_FIELD(global_scale).set_default(8.0)
+        .describe("The range of the activations when no dataset is used for calibration.");
+    TVM_ATTR_FIELD(skip_k_conv).set_default(1)
+        .describe("Number of leading conv2d kept in float.");
+    TVM_ATTR_FIELD(round_for_shift).set_default(true)
+        .describe("Whether to add a rounding bias before the right shift.");
+  }
+};
+
+/*!
+ * \brief Temporary expression of the annotation pass.
+ *  Records the kind of the value produced by the expression.
+ */
+class QAnnotateExpr;
+class QAnnotateExprNode : public TempExprNode {
+ public:
+  /*! \brief The original expression */
+  Expr expr;
+  /*! \brief The kind of annotate field, a QAnnotateKind */
+  int kind;
+
+  void VisitAttrs(tvm::AttrVisitor* v) final {
+    v->Visit("expr", &expr);
+    v->Visit("kind", &kind);
+  }
+
+  TVM_DLL static QAnnotateExpr make(Expr expr, int kind);
+
+  Expr Realize() const final;
+
+  static constexpr const char* _type_key = "relay.quantize.QAnnotateExpr";
+  TVM_DECLARE_NODE_TYPE_INFO(QAnnotateExprNode, TempExprNode);
+};
+
+RELAY_DEFINE_NODE_REF(QAnnotateExpr, QAnnotateExprNode, TempExpr);
+
+/*!
+ * \brief Temporary expression of the realize pass.
+ *  The real value is data * dom_scale, where data holds
+ *  integers stored in dtype.
+ */
+class QRealizeIntExpr;
+class QRealizeIntExprNode : public TempExprNode {
+ public:
+  /*! \brief The integer data */
+  Expr data;
+  /*! \brief The scalar scale of the data */
+  Expr dom_scale;
+  /*! \brief The data type of data */
+  DataType dtype;
+
+  void VisitAttrs(tvm::AttrVisitor* v) final {
+    v->Visit("data", &data);
+    v->Visit("dom_scale", &dom_scale);
+    v->Visit("dtype", &dtype);
+  }
+
+  TVM_DLL static QRealizeIntExpr make(Expr data, Expr dom_scale, DataType dtype);
+
+  Expr Realize() const final;
+
+  static constexpr const char* _type_key = "relay.quantize.QRealizeIntExpr";
+  TVM_DECLARE_NODE_TYPE_INFO(QRealizeIntExprNode, TempExprNode);
+};
+
+RELAY_DEFINE_NODE_REF(QRealizeIntExpr, QRealizeIntExprNode, TempExpr);
+
+/*!
+ * \brief Annotate the conv2d, dense and elementwise operators
+ *  of the expression with simulated_quantize.
+ * \param expr The expression.
+ * \param cfg The quantization configuration.
+ * \return The annotated expression.
+ */
+Expr QuantizeAnnotate(const Expr& expr, const Attrs& cfg);
+
+/*!
+ * \brief Realize the calibrated simulated_quantize into integer operators.
+ * \param expr The expression, dom_scale and clips must be constants.
+ * \param cfg The quantization configuration.
+ * \return The realized expression.
+ */
+Expr QuantizeRealize(const Expr& expr, const Attrs& cfg);
+
+}  // namespace quantize
+}  // namespace relay
+}  // namespace tvm
+#endif  // TVM_RELAY_PASS_QUANTIZE_H_
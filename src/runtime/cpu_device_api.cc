@@ -6,6 +6,8 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/threading_backend.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include "workspace_pool.h"
@@ -36,9 +38,19 @@ class CPUDeviceAPI final : public DeviceAPI {
     ptr = memalign(alignment, nbytes);
     if (ptr == nullptr) throw std::bad_alloc();
 #else
+    // place the storage and workspace on the node of the thread pool,
+    // in pages of their own so that other heap objects are not moved.
+    size_t page_size = threading::NUMAPageSize();
+    if (page_size != 0) {
+      alignment = std::max(alignment, page_size);
+      nbytes = (nbytes + page_size - 1) / page_size * page_size;
+    }
     // posix_memalign is available in android ndk since __ANDROID_API__ >= 16
     int ret = posix_memalign(&ptr, alignment, nbytes);
     if (ret != 0) throw std::bad_alloc();
+    if (page_size != 0) {
+      threading::BindMemoryToNUMANode(ptr, nbytes);
+    }
 #endif
     return ptr;
   }
@@ -28,9 +28,8 @@ class GraphRuntimeDebug : public GraphRuntime {
     CHECK(index < op_execs().size());
     TVMContext ctx = data_entry()[GetEntryId(index, 0)].operator->()->ctx;
     auto tbegin = std::chrono::high_resolution_clock::now();
-    if (op_execs()[index]) {
-      op_execs()[index]();
-    }
+    RunOp(static_cast<uint32_t>(index));
+    SyncCopyStreams();
     TVMSynchronize(ctx.device_type, ctx.device_id, nullptr);
     auto tend = std::chrono::high_resolution_clock::now();
     double time = std::chrono::duration_cast<std::chrono::duration<double> >(
@@ -85,9 +84,10 @@ void DebugGetNodeOutput(int index, DLTensor* data_out) {
   uint32_t eid = index;
 
   for (size_t i = 0; i < op_execs().size(); ++i) {
-    if (op_execs()[i]) op_execs()[i]();
+    RunOp(static_cast<uint32_t>(i));
     if (static_cast<int>(i) == index) break;
   }
+  SyncCopyStreams();
 
   data_entry()[eid].CopyTo(data_out);
 }
@@ -18,14 +18,44 @@
 namespace tvm {
 namespace runtime {
 
+GraphRuntime::~GraphRuntime() {
+  for (const CopyStream& cs : copy_streams_) {
+    if (cs.stream != nullptr) {
+      TVMStreamFree(cs.ctx.device_type, cs.ctx.device_id, cs.stream);
+    }
+  }
+}
 /*!
  * \brief Run all the operations one by one.
  */
 void GraphRuntime::Run() {
   // setup the array and requirements.
-  for (size_t i = 0; i < op_execs_.size(); ++i) {
-    if (op_execs_[i]) op_execs_[i]();
+  for (uint32_t i = 0; i < op_execs_.size(); ++i) {
+    this->RunOp(i);
   }
+  this->SyncCopyStreams();
+}
+/*!
+ * \brief Run the index-th operation after the copies it depends on.
+ * \param index The node index.
+ */
+void GraphRuntime::RunOp(uint32_t index) {
+  if (!op_execs_[index]) return;
+  if (!storage_copy_write_.empty()) this->WaitForCopies(index);
+  op_execs_[index]();
+}
+/*!
+ * \brief Wait for all the asynchronous copies to finish.
+ */
+void GraphRuntime::SyncCopyStreams() {
+  if (storage_copy_write_.empty()) return;
+  for (const CopyStream& cs : copy_streams_) {
+    if (cs.stream != nullptr) {
+      TVM_CCALL(TVMSynchronize(cs.ctx.device_type, cs.ctx.device_id, cs.stream));
+    }
+  }
+  std::fill(storage_copy_read_.begin(), storage_copy_read_.end(), -1);
+  std::fill(storage_copy_write_.begin(), storage_copy_write_.end(), -1);
 }
 /*!
  * \brief Initialize the graph executor with graph and context.
@@ -231,6 +261,10 @@ void GraphRuntime::SetupStorage() {
 
 void GraphRuntime::SetupOpExecs() {
   op_execs_.resize(this->GetNumOfNodes());
+  node_copy_stream_.assign(this->GetNumOfNodes(), -1);
+  node_read_storage_.resize(this->GetNumOfNodes());
+  node_write_storage_.resize(this->GetNumOfNodes());
+  bool has_async_copy = false;
   // setup the array and requirements.
   for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
     const auto& inode = nodes_[nid];
@@ -238,15 +272,106 @@ void GraphRuntime::SetupOpExecs() {
     std::vector<DLTensor> args;
     for (const auto& e : inode.inputs) {
       args.push_back(*(data_entry_[this->entry_id(e)].operator->()));
+      node_read_storage_[nid].push_back(attrs_.storage_id[this->entry_id(e)]);
     }
     for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
       uint32_t eid = this->entry_id(nid, index);
       args.push_back(*(data_entry_[eid].operator->()));
+      node_write_storage_[nid].push_back(attrs_.storage_id[eid]);
     }
     CHECK(inode.op_type == "tvm_op") << "Can only take tvm_op as op";
 
+    if (inode.param.func_name == "__copy") {
+      // The copy is performed by the device api of the non-cpu context.
+      const DLTensor& from = args[0];
+      const DLTensor& to = args[1];
+      int stream_index = GetCopyStream(
+          from.ctx.device_type != kDLCPU ? from.ctx : to.ctx);
+      if (stream_index >= 0) {
+        node_copy_stream_[nid] = stream_index;
+        op_execs_[nid] = CreateAsyncCopy(nid, stream_index);
+        has_async_copy = true;
+        continue;
+      }
+    }
     op_execs_[nid] = CreateTVMOp(inode.param, args, inode.inputs.size());
   }
+  if (has_async_copy) {
+    storage_copy_read_.assign(storage_pool_.size(), -1);
+    storage_copy_write_.assign(storage_pool_.size(), -1);
+  }
+}
+
+int GraphRuntime::GetCopyStream(TVMContext ctx) {
+  if (ctx.device_type == kDLCPU) return -1;
+  for (size_t i = 0; i < copy_streams_.size(); ++i) {
+    const CopyStream& cs = copy_streams_[i];
+    if (cs.ctx.device_type == ctx.device_type && cs.ctx.device_id == ctx.device_id) {
+      return cs.stream != nullptr ? static_cast<int>(i) : -1;
+    }
+  }
+  TVMStreamHandle stream = nullptr;
+  // Copy synchronously on the devices that don't support streams.
+  if (TVMStreamCreate(ctx.device_type, ctx.device_id, &stream) != 0) {
+    stream = nullptr;
+  }
+  copy_streams_.push_back(CopyStream{ctx, stream});
+  return stream != nullptr ? static_cast<int>(copy_streams_.size()) - 1 : -1;
+}
+
+std::function<void()> GraphRuntime::CreateAsyncCopy(uint32_t nid, int stream_index) {
+  uint32_t from_eid = this->entry_id(nodes_[nid].inputs[0]);
+  uint32_t to_eid = this->entry_id(nid, 0);
+  DLTensor from = *(data_entry_[from_eid].operator->());
+  DLTensor to = *(data_entry_[to_eid].operator->());
+  int from_sid = attrs_.storage_id[from_eid];
+  int to_sid = attrs_.storage_id[to_eid];
+  auto fexec = [this, from, to, from_sid, to_sid, stream_index]() mutable {
+    const CopyStream& cs = copy_streams_[stream_index];
+    // Order the copy after the device kernels that access its buffers.
+    TVM_CCALL(TVMStreamStreamSynchronize(
+        cs.ctx.device_type, cs.ctx.device_id, nullptr, cs.stream));
+    TVM_CCALL(TVMArrayCopyFromTo(&from, &to, cs.stream));
+    storage_copy_read_[from_sid] = stream_index;
+    storage_copy_write_[to_sid] = stream_index;
+  };
+  return fexec;
+}
+
+void GraphRuntime::WaitForCopy(uint32_t nid, uint32_t sid, int stream_index) {
+  int own_stream = node_copy_stream_[nid];
+  // The copies on the same stream are executed in order.
+  if (stream_index < 0 || stream_index == own_stream) return;
+  const CopyStream& cs = copy_streams_[stream_index];
+  TVMContext ctx = data_entry_[this->entry_id(nid, 0)]->ctx;
+  if (own_stream < 0 &&
+      ctx.device_type == cs.ctx.device_type && ctx.device_id == cs.ctx.device_id) {
+    // The kernels of the device wait for the copy without blocking the host.
+    TVM_CCALL(TVMStreamStreamSynchronize(
+        ctx.device_type, ctx.device_id, cs.stream, nullptr));
+    if (storage_copy_read_[sid] == stream_index) storage_copy_read_[sid] = -1;
+    if (storage_copy_write_[sid] == stream_index) storage_copy_write_[sid] = -1;
+  } else {
+    TVM_CCALL(TVMSynchronize(cs.ctx.device_type, cs.ctx.device_id, cs.stream));
+    for (int& s : storage_copy_read_) {
+      if (s == stream_index) s = -1;
+    }
+    for (int& s : storage_copy_write_) {
+      if (s == stream_index) s = -1;
+    }
+  }
+}
+
+void GraphRuntime::WaitForCopies(uint32_t nid) {
+  // Reading the source of a copy in flight is safe, reading its destination
+  // or overwriting either of its buffers is not.
+  for (uint32_t sid : node_read_storage_[nid]) {
+    this->WaitForCopy(nid, sid, storage_copy_write_[sid]);
+  }
+  for (uint32_t sid : node_write_storage_[nid]) {
+    this->WaitForCopy(nid, sid, storage_copy_write_[sid]);
+    this->WaitForCopy(nid, sid, storage_copy_read_[sid]);
+  }
 }
 
 std::function<void()> GraphRuntime::CreateTVMOp(
@@ -349,7 +474,14 @@ PackedFunc GraphRuntime::GetFunction(
       });
   } else if (name == "load_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
-        this->LoadParams(args[0].operator std::string());
+        if (args[0].type_code() == kBytes) {
+          // read the bytes in place, the caller may pass a mapped file.
+          TVMByteArray* arr = args[0].ptr<TVMByteArray>();
+          dmlc::MemoryFixedSizeStream strm(const_cast<char*>(arr->data), arr->size);
+          this->LoadParams(&strm);
+        } else {
+          this->LoadParams(args[0].operator std::string());
+        }
       });
   } else {
     return PackedFunc();
@@ -62,7 +62,25 @@ class GraphRuntime : public ModuleNode {
   const char* type_key() const final {
     return "GraphRuntime";
   }
+  /*! \brief Free the streams of the asynchronous copies. */
+  ~GraphRuntime();
+  /*!
+   * \brief Run all the operations one by one.
+   *
+   *  The cross device copies are issued asynchronously on a stream of their
+   *  device when it supports streams, so that the following operations that
+   *  don't depend on them overlap with the transfer. An operation waits for
+   *  the copies in flight that write the storage it reads, or that read or
+   *  write the storage it writes.
+   */
   void Run();
+  /*!
+   * \brief Run the index-th operation after the copies it depends on.
+   * \param index The node index.
+   */
+  void RunOp(uint32_t index);
+  /*! \brief Wait for all the asynchronous copies to finish. */
+  void SyncCopyStreams();
 
   /*!
    * \brief Initialize the graph executor with graph and context.
@@ -164,6 +182,11 @@ class GraphRuntime : public ModuleNode {
 
 
  private:
+  // A stream of asynchronous copies on a device.
+  struct CopyStream {
+    TVMContext ctx;
+    TVMStreamHandle stream;
+  };
   // Memory pool entry.
   struct PoolEntry {
     size_t size;
@@ -350,6 +373,31 @@ class GraphRuntime : public ModuleNode {
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Get the copy stream of a device, creating it on first use.
+   * \param ctx The device context.
+   * \return The index of the stream, -1 if the device doesn't support streams.
+   */
+  int GetCopyStream(TVMContext ctx);
+  /*!
+   * \brief Create an asynchronous cross device copy.
+   * \param nid The node index of the copy.
+   * \param stream_index The index of the copy stream.
+   * \return The created executor.
+   */
+  std::function<void()> CreateAsyncCopy(uint32_t nid, int stream_index);
+  /*!
+   * \brief Wait for the copies in flight the node depends on.
+   * \param nid The node index.
+   */
+  void WaitForCopies(uint32_t nid);
+  /*!
+   * \brief Wait for a copy in flight accessing a storage of a node.
+   * \param nid The node index.
+   * \param sid The storage id.
+   * \param stream_index The copy stream accessing the storage, -1 if none.
+   */
+  void WaitForCopy(uint32_t nid, uint32_t sid, int stream_index);
   /*!
    * \brief Create an execution function given input.
    * \param attrs The node attributes.
@@ -392,6 +440,18 @@ class GraphRuntime : public ModuleNode {
   std::vector<NDArray> data_entry_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()> > op_execs_;
+  /*! \brief The copy streams of the devices, the stream is null if unsupported. */
+  std::vector<CopyStream> copy_streams_;
+  /*! \brief The copy stream of each node, -1 if it is not an asynchronous copy. */
+  std::vector<int> node_copy_stream_;
+  /*! \brief The storage ids read by each node. */
+  std::vector<std::vector<uint32_t> > node_read_storage_;
+  /*! \brief The storage ids written by each node. */
+  std::vector<std::vector<uint32_t> > node_write_storage_;
+  /*! \brief The copy stream reading each storage, -1 if no copy is in flight. */
+  std::vector<int> storage_copy_read_;
+  /*! \brief The copy stream writing each storage, -1 if no copy is in flight. */
+  std::vector<int> storage_copy_write_;
 };
 
 std::vector<TVMContext> GetAllContext(const TVMArgs& args);
@@ -6,22 +6,61 @@
 #include <dmlc/logging.h>
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/registry.h>
-#include <unordered_map>
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <array>
+#include <functional>
+#include <vector>
 #include "runtime_base.h"
 
 namespace tvm {
 namespace runtime {
 
 struct Registry::Manager {
-  // map storing the functions.
-  // We delibrately used raw pointer
+  // Open addressing hash table of the registered functions.
+  // Lookups probe the current table without taking the lock, so
+  // concurrent callers of Get do not contend with each other.
+  // Writers are serialized by the mutex: they publish new entries
+  // with release stores and grow the table by publishing a larger copy.
+  struct Table {
+    size_t mask;
+    std::unique_ptr<std::atomic<Registry*>[]> slots;
+
+    explicit Table(size_t size)
+        : mask(size - 1), slots(new std::atomic<Registry*>[size]) {
+      for (size_t i = 0; i < size; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    // find the entry of name, nullptr if it does not exist.
+    Registry* Find(const std::string& name) const {
+      for (size_t i = std::hash<std::string>()(name) & mask; ; i = (i + 1) & mask) {
+        Registry* r = slots[i].load(std::memory_order_acquire);
+        if (r == nullptr || r->name_ == name) return r;
+      }
+    }
+    // insert a new entry, the caller must hold the mutex.
+    void Insert(Registry* r) {
+      size_t i = std::hash<std::string>()(r->name_) & mask;
+      while (slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & mask;
+      }
+      slots[i].store(r, std::memory_order_release);
+    }
+  };
+  // The current table.
+  // We delibrately used raw pointer for the entries
   // This is because PackedFunc can contain callbacks into the host languge(python)
   // and the resource can become invalid because of indeterminstic order of destruction.
   // The resources will only be recycled during program exit.
-  std::unordered_map<std::string, Registry*> fmap;
+  std::atomic<Table*> table;
+  // All the tables ever published, as readers can still probe the old ones.
+  // The table doubles when it grows, so they take at most twice the space
+  // of the current one.
+  std::vector<std::unique_ptr<Table> > tables;
+  // number of entries, including the removed ones.
+  size_t num_entries{0};
   // vtable for extension type
   std::array<ExtTypeVTable, kExtEnd> ext_vtable;
   // mutex
@@ -31,11 +70,31 @@ struct Registry::Manager {
     for (auto& x : ext_vtable) {
       x.destroy = nullptr;
     }
+    tables.emplace_back(new Table(1024));
+    table.store(tables.back().get(), std::memory_order_release);
+  }
+
+  // insert a new entry, the caller must hold the mutex.
+  void Insert(Registry* r) {
+    Table* t = table.load(std::memory_order_relaxed);
+    // keep the load factor below 1/2 so that probes stay short.
+    if ((num_entries + 1) * 2 > t->mask + 1) {
+      Table* bigger = new Table((t->mask + 1) * 2);
+      for (size_t i = 0; i <= t->mask; ++i) {
+        Registry* e = t->slots[i].load(std::memory_order_relaxed);
+        if (e != nullptr) bigger->Insert(e);
+      }
+      tables.emplace_back(bigger);
+      table.store(bigger, std::memory_order_release);
+      t = bigger;
+    }
+    t->Insert(r);
+    ++num_entries;
   }
 
   static Manager* Global() {
     // We deliberately leak the Manager instance, to avoid leak sanitizers
-    // complaining about the entries in Manager::fmap being leaked at program
+    // complaining about the entries in Manager::table being leaked at program
     // exit.
     static Manager* inst = new Manager();
     return inst;
@@ -50,43 +109,48 @@ Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
 Registry& Registry::Register(const std::string& name, bool override) {  // NOLINT(*)
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) {
-    Registry* r = new Registry();
+  Registry* r = m->table.load(std::memory_order_relaxed)->Find(name);
+  if (r == nullptr) {
+    r = new Registry();
     r->name_ = name;
-    m->fmap[name] = r;
-    return *r;
+    m->Insert(r);
   } else {
-    CHECK(override)
+    // removed entries are reused, so that the returned pointers stay valid,
+    // the body is overwritten by set_body without synchronization.
+    CHECK(override || r->removed_.load(std::memory_order_relaxed))
       << "Global PackedFunc " << name << " is already registered";
-    return *it->second;
+    r->removed_.store(false, std::memory_order_release);
   }
+  return *r;
 }
 
 bool Registry::Remove(const std::string& name) {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return false;
-  m->fmap.erase(it);
+  Registry* r = m->table.load(std::memory_order_relaxed)->Find(name);
+  if (r == nullptr || r->removed_.load(std::memory_order_relaxed)) return false;
+  r->removed_.store(true, std::memory_order_release);
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
   Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
-  return &(it->second->func_);
+  Registry* r = m->table.load(std::memory_order_acquire)->Find(name);
+  if (r == nullptr || r->removed_.load(std::memory_order_acquire)) return nullptr;
+  return &(r->func_);
 }
 
 std::vector<std::string> Registry::ListNames() {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
+  Manager::Table* t = m->table.load(std::memory_order_relaxed);
   std::vector<std::string> keys;
-  keys.reserve(m->fmap.size());
-  for (const auto &kv : m->fmap) {
-    keys.push_back(kv.first);
+  keys.reserve(m->num_entries);
+  for (size_t i = 0; i <= t->mask; ++i) {
+    Registry* r = t->slots[i].load(std::memory_order_relaxed);
+    if (r != nullptr && !r->removed_.load(std::memory_order_relaxed)) {
+      keys.push_back(r->name_);
+    }
   }
   return keys;
 }
@@ -6,6 +6,7 @@
 #include <tvm/runtime/registry.h>
 #include <memory>
 #include <cstring>
+#include <string>
 #include "rpc_session.h"
 
 namespace tvm {
@@ -25,6 +26,10 @@ class RPCWrappedFunc {
   void operator()(TVMArgs args, TVMRetValue *rv) const {
     sess_->CallFunc(handle_, args, rv, &fwrap_);
   }
+  // send the call without waiting, return the request id.
+  uint64_t AsyncCall(TVMArgs args) const {
+    return sess_->AsyncCallFunc(handle_, args, fwrap_);
+  }
   ~RPCWrappedFunc() {
     try {
       sess_->CallRemote(RPCCode::kFreeFunc, handle_);
@@ -132,6 +137,17 @@ class RPCModuleNode final : public ModuleNode {
     return WrapRemote(handle);
   }
 
+  // Get a function that sends the call without waiting for the
+  // return, and returns the request id to wait on.
+  PackedFunc GetAsyncFunction(const std::string& name) {
+    RPCFuncHandle handle = GetFuncHandle(name);
+    if (handle == nullptr) return PackedFunc();
+    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
+    return PackedFunc([wf](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int64_t>(wf->AsyncCall(args));
+      });
+  }
+
   void* module_handle() const {
     return module_handle_;
   }
@@ -246,6 +262,24 @@ TVM_REGISTER_GLOBAL("rpc._ModuleHandle")
     *rv = static_cast<RPCModuleNode*>(m.operator->())->module_handle();
   });
 
+TVM_REGISTER_GLOBAL("rpc._GetAsyncFunction")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    Module m = args[0];
+    std::string tkey = m->type_key();
+    CHECK_EQ(tkey, "rpc");
+    *rv = static_cast<RPCModuleNode*>(m.operator->())->GetAsyncFunction(args[1]);
+  });
+
+TVM_REGISTER_GLOBAL("rpc._WaitAsync")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    Module m = args[0];
+    std::string tkey = m->type_key();
+    CHECK_EQ(tkey, "rpc");
+    int64_t request_id = args[1];
+    static_cast<RPCModuleNode*>(m.operator->())->sess()->WaitAsync(
+        static_cast<uint64_t>(request_id), rv);
+  });
+
 TVM_REGISTER_GLOBAL("rpc._SessTableIndex")
 .set_body([](TVMArgs args, TVMRetValue* rv) {
     Module m = args[0];
@@ -20,6 +20,8 @@
 
 namespace tvm {
 namespace runtime {
+// Maximum number of asynchronous calls in flight in a session.
+constexpr size_t kMaxAsyncPending = 32;
 // Temp buffer for data array
 struct RPCByteArrayBuffer {
   TVMByteArray arr;
@@ -823,11 +825,7 @@ RPCCode RPCSession::HandleUntilReturnEvent(
   while (code != RPCCode::kReturn &&
          code != RPCCode::kShutdown &&
          code != RPCCode::kCopyAck) {
-    while (writer_.bytes_available() != 0) {
-      writer_.ReadWithCallback([this](const void *data, size_t size) {
-          return channel_->Send(data, size);
-        }, writer_.bytes_available());
-    }
+    FlushWriter();
     size_t bytes_needed = handler_->BytesNeeded();
     if (bytes_needed != 0) {
       size_t n = reader_.WriteWithCallback([this](void* data, size_t size) {
@@ -846,6 +844,36 @@ RPCCode RPCSession::HandleUntilReturnEvent(
   return code;
 }
 
+void RPCSession::FlushWriter() {
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback([this](const void *data, size_t size) {
+        return channel_->Send(data, size);
+      }, writer_.bytes_available());
+  }
+}
+
+void RPCSession::RecvAsyncReturn() {
+  CHECK(!async_pending_.empty());
+  uint64_t request_id = async_pending_.front().first;
+  PackedFunc fwrap = std::move(async_pending_.front().second);
+  async_pending_.pop_front();
+  AsyncResult& result = async_results_[request_id];
+  try {
+    RPCCode code = HandleUntilReturnEvent(&result.rv, true, &fwrap);
+    CHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+  } catch (const dmlc::Error& e) {
+    // the handler is back to receive the next code when the remote
+    // raises, keep the error for the waiter of this call.
+    result.error = e.what();
+  }
+}
+
+void RPCSession::DrainAsync() {
+  while (!async_pending_.empty()) {
+    RecvAsyncReturn();
+  }
+}
+
 void RPCSession::Init() {
   // Event handler
   handler_ = std::make_shared<EventHandler>(
@@ -935,6 +963,7 @@ void RPCSession::CallFunc(void* h,
                           TVMRetValue* rv,
                           const PackedFunc* fwrap) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  DrainAsync();
   RPCCode code = RPCCode::kCallFunc;
   handler_->Write(code);
   uint64_t handle = reinterpret_cast<uint64_t>(h);
@@ -944,6 +973,42 @@ void RPCSession::CallFunc(void* h,
   CHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
 }
 
+uint64_t RPCSession::AsyncCallFunc(void* h,
+                                   TVMArgs args,
+                                   PackedFunc fwrap) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  // Bound the number of calls in flight, so that the unread returns
+  // cannot fill up the channel while we are blocked on sending.
+  if (async_pending_.size() >= kMaxAsyncPending) {
+    RecvAsyncReturn();
+  }
+  RPCCode code = RPCCode::kCallFunc;
+  handler_->Write(code);
+  uint64_t handle = reinterpret_cast<uint64_t>(h);
+  handler_->Write(handle);
+  handler_->SendPackedSeq(args.values, args.type_codes, args.num_args);
+  FlushWriter();
+  uint64_t request_id = next_request_id_++;
+  async_pending_.emplace_back(request_id, std::move(fwrap));
+  return request_id;
+}
+
+void RPCSession::WaitAsync(uint64_t request_id, TVMRetValue* rv) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  while (async_results_.count(request_id) == 0) {
+    CHECK(!async_pending_.empty() && async_pending_.front().first <= request_id)
+        << "Unknown or already waited asynchronous RPC call " << request_id;
+    RecvAsyncReturn();
+  }
+  auto it = async_results_.find(request_id);
+  AsyncResult result = std::move(it->second);
+  async_results_.erase(it);
+  if (result.error.length() != 0) {
+    throw dmlc::Error(result.error);
+  }
+  *rv = std::move(result.rv);
+}
+
 void RPCSession::CopyToRemote(void* from,
                               size_t from_offset,
                               void* to,
@@ -952,6 +1017,7 @@ void RPCSession::CopyToRemote(void* from,
                               TVMContext ctx_to,
                               TVMType type_hint) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  DrainAsync();
   ctx_to = handler_->StripSessMask(ctx_to);
   RPCCode code = RPCCode::kCopyToRemote;
   handler_->Write(code);
@@ -976,6 +1042,7 @@ void RPCSession::CopyFromRemote(void* from,
                                 TVMContext ctx_from,
                                 TVMType type_hint) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  DrainAsync();
   ctx_from = handler_->StripSessMask(ctx_from);
   RPCCode code = RPCCode::kCopyFromRemote;
   handler_->Write(code);
@@ -8,8 +8,11 @@
 
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/device_api.h>
+#include <deque>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include "../../common/ring_buffer.h"
 
 namespace tvm {
@@ -111,6 +114,30 @@ class RPCSession {
                 TVMArgs args,
                 TVMRetValue* rv,
                 const PackedFunc* fwrap);
+  /*!
+   * \brief Send a call to remote function without waiting for the return.
+   *
+   *  The remote handles the requests of a session in order, so several
+   *  calls, e.g. uploads and measurements, can be in flight at the same
+   *  time to overlap them with the network latency. The returns are
+   *  matched to the requests by their order, the protocol is unchanged.
+   *  Synchronous calls receive all the pending returns first.
+   *
+   * \param handle The function handle
+   * \param args The arguments
+   * \param fwrap Wrapper function to turn Function/Module handle into real return.
+   * \return The id of the request, which must be passed to WaitAsync.
+   */
+  uint64_t AsyncCallFunc(RPCFuncHandle handle,
+                         TVMArgs args,
+                         PackedFunc fwrap);
+  /*!
+   * \brief Wait for the return of an asynchronous call.
+   *  The exception raised by the remote function is rethrown here.
+   * \param request_id The id returned by AsyncCallFunc.
+   * \param rv The return value.
+   */
+  void WaitAsync(uint64_t request_id, TVMRetValue* rv);
   /*!
    * \brief Copy bytes into remote array content.
    * \param from The source host data.
@@ -210,6 +237,12 @@ class RPCSession {
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(
       TVMRetValue* rv, bool client_mode, const PackedFunc* fwrap);
+  // Send the content of the writer to the channel.
+  void FlushWriter();
+  // Receive the return of the oldest pending asynchronous call.
+  void RecvAsyncReturn();
+  // Receive the returns of all the pending asynchronous calls.
+  void DrainAsync();
   // Initalization
   void Init();
   // Shutdown
@@ -230,6 +263,18 @@ class RPCSession {
   std::string name_;
   // The remote key
   std::string remote_key_;
+  // Result of an asynchronous call.
+  struct AsyncResult {
+    TVMRetValue rv;
+    // The exception message, empty if the call succeeded.
+    std::string error;
+  };
+  // The ids and return wrappers of the calls waiting for return, in order.
+  std::deque<std::pair<uint64_t, PackedFunc> > async_pending_;
+  // The returns received but not yet waited for.
+  std::unordered_map<uint64_t, AsyncResult> async_results_;
+  // The id of the next asynchronous call.
+  uint64_t next_request_id_{0};
 };
 
 /*!
@@ -274,6 +319,7 @@ struct RemoteSpace {
 template<typename... Args>
 inline TVMRetValue RPCSession::CallRemote(RPCCode code, Args&& ...args) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  DrainAsync();
   writer_.Write(&code, sizeof(code));
   return call_remote_(std::forward<Args>(args)...);
 }
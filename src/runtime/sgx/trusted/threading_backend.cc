@@ -66,6 +66,14 @@ void Yield() {}
 
 int MaxConcurrency() { return TVM_SGX_MAX_CONCURRENCY; }
 
+int NUMANode() { return -1; }
+
+std::vector<unsigned> NUMANodeCPUs(int node) { return {}; }
+
+size_t NUMAPageSize() { return 0; }
+
+void BindMemoryToNUMANode(void* ptr, size_t nbytes) {}
+
 TVM_REGISTER_ENCLAVE_FUNC("__tvm_run_worker__")
 .set_body([](TVMArgs args, TVMRetValue* rv) {
     void* tg = args[0];
@@ -7,15 +7,47 @@
 #include <tvm/runtime/util.h>
 #include <tvm/runtime/c_backend_api.h>
 #include <algorithm>
+#include <memory>
 #include "stackvm.h"
 
 namespace tvm {
 namespace runtime {
 
-typedef dmlc::ThreadLocalStore<StackVM::State> StackVMStateStore;
+/*!
+ * \brief Thread local pool of execution states.
+ *  A state is kept for each nesting level so that a packed call
+ *  back into the stack vm does not clobber the caller's stack.
+ *  The states are reused across calls to avoid reallocation.
+ */
+struct StackVMFramePool {
+  /*! \brief the preallocated states, indexed by nesting level */
+  std::vector<std::unique_ptr<StackVM::State> > frames;
+  /*! \brief current nesting level */
+  size_t depth{0};
+  /*! \return the state of the next invocation */
+  StackVM::State* Top() {
+    if (frames.size() <= depth) {
+      frames.emplace_back(new StackVM::State());
+    }
+    return frames[depth].get();
+  }
+  /*! \return acquire the state of the next invocation */
+  StackVM::State* Acquire() {
+    StackVM::State* s = Top();
+    ++depth;
+    return s;
+  }
+  /*! \brief release the state of the innermost invocation */
+  void Release() {
+    CHECK_NE(depth, 0U);
+    --depth;
+  }
+};
+
+typedef dmlc::ThreadLocalStore<StackVMFramePool> StackVMFramePoolStore;
 
 StackVM::State* StackVM::ThreadLocalState() {
-  return StackVMStateStore::Get();
+  return StackVMFramePoolStore::Get()->Top();
 }
 
 #define STACK_VM_BINOP(OP, FIELD)                                 \
@@ -141,6 +173,28 @@ int64_t StackVM::PrintCode(std::ostream& os, int64_t pc) const {
     STACK_VM_PRINT_CODE0(TVM_DEVICE_ALLOCA);
     STACK_VM_PRINT_CODE0(TVM_DEVICE_FREE);
     STACK_VM_PRINT_CODE0(TVM_THROW_LAST_ERROR);
+    case LOAD_HEAP_STRUCT_GET: {
+      os << "[" << pc << "]\tLOAD_HEAP_STRUCT_GET "
+         << code[pc + 1].v_int << " " << heap_id_name[code[pc + 1].v_int]
+         << " " << code[pc + 2].v_int
+         << " " << code[pc + 3].v_int << '\n';
+      for (int i = 0; i < 3; ++i) {
+        os << "[" << pc + 1 + i << "]" << std::endl;
+      }
+      return pc + 4;
+    }
+    case CALL_PACKED_HEAP: {
+      os << "[" << pc << "]\tCALL_PACKED_HEAP "
+         << " values=" << heap_id_name[code[pc + 1].v_int]
+         << " tcodes=" << heap_id_name[code[pc + 2].v_int]
+         << " fid=" << code[pc + 3].v_int
+         << " begin=" << code[pc + 4].v_int
+         << " end=" << code[pc + 5].v_int << '\n';
+      for (int i = 0; i < 5; ++i) {
+        os << "[" << pc + 1 + i << "]" << std::endl;
+      }
+      return pc + 6;
+    }
     // packed function.
     case CALL_PACKED_LOWERED: {
       int call_fid = code[pc + 1].v_int;
@@ -175,7 +229,8 @@ std::ostream& operator<<(std::ostream& os, const StackVM& vm) {  // NOLINT(*)
 
 void StackVM::Run(const runtime::TVMArgs& args,
                   runtime::ModuleNode* mod_ctx) const {
-  StackVM::State* s = StackVM::ThreadLocalState();
+  StackVMFramePool* pool = StackVMFramePoolStore::Get();
+  StackVM::State* s = pool->Acquire();
   if (s->heap.size() < heap_size) {
     s->heap.resize(heap_size);
   }
@@ -185,13 +240,20 @@ void StackVM::Run(const runtime::TVMArgs& args,
   s->heap[0].v_handle = (void*)args.values;  // NOLINT(*)
   s->heap[1].v_handle = (void*)args.type_codes;  // NOLINT(*)
   s->heap[2].v_int64 = args.num_args;
-  this->Run(s);
+  try {
+    this->Run(s);
+  } catch (...) {
+    pool->Release();
+    throw;
+  }
+  pool->Release();
 }
 
 void StackVM::InitCache() {
   extern_func_cache_.clear();
   extern_func_cache_.resize(
       extern_func_name.size(), PackedFunc(nullptr));
+  max_sp_ = ComputeMaxStackPointer();
 }
 
 void StackVM::Save(dmlc::Stream* strm) const {
@@ -225,136 +287,390 @@ bool StackVM::Load(dmlc::Stream* strm)  {
   return true;
 }
 
+/*!
+ * \brief Get the length and the stack pointer change of instruction at pc.
+ * \return false if the op code is unknown.
+ */
+inline bool GetStackEffect(const StackVM::Code* code, int64_t pc,
+                           int64_t* length, int64_t* delta) {
+  switch (code[pc].op_code) {
+    case StackVM::ADD_I64: case StackVM::SUB_I64: case StackVM::MUL_I64:
+    case StackVM::DIV_I64: case StackVM::MOD_I64: case StackVM::EQ_I64:
+    case StackVM::LT_I64: case StackVM::LE_I64: case StackVM::ADD_F64:
+    case StackVM::SUB_F64: case StackVM::MUL_F64: case StackVM::DIV_F64:
+    case StackVM::EQ_F64: case StackVM::LT_F64: case StackVM::LE_F64:
+    case StackVM::EQ_HANDLE: case StackVM::ADDR_ADD: case StackVM::POP:
+      *length = 1; *delta = -1; return true;
+    case StackVM::ARRAY_LOAD_UINT32: case StackVM::ARRAY_LOAD_INT32:
+    case StackVM::ARRAY_LOAD_INT64: case StackVM::ARRAY_LOAD_FP64:
+    case StackVM::ARRAY_LOAD_HANDLE: case StackVM::ARRAY_LOAD_TVMVALUE:
+    case StackVM::RJUMP_IF_TRUE: case StackVM::RJUMP_IF_FALSE:
+    case StackVM::RJUMP: case StackVM::ASSERT_SP:
+      *length = 2; *delta = 0; return true;
+    case StackVM::ARRAY_STORE_UINT32: case StackVM::ARRAY_STORE_INT32:
+    case StackVM::ARRAY_STORE_INT64: case StackVM::ARRAY_STORE_FP64:
+    case StackVM::ARRAY_STORE_HANDLE: case StackVM::ARRAY_STORE_TVMVALUE:
+      *length = 2; *delta = -2; return true;
+    case StackVM::NOT: case StackVM::TVM_THROW_LAST_ERROR:
+      *length = 1; *delta = 0; return true;
+    case StackVM::PUSH_I64: case StackVM::PUSH_VALUE: case StackVM::LOAD_HEAP:
+      *length = 2; *delta = 1; return true;
+    case StackVM::STORE_HEAP: case StackVM::ASSERT:
+      *length = 2; *delta = -1; return true;
+    case StackVM::SELECT:
+      *length = 1; *delta = -2; return true;
+    case StackVM::CALL_PACKED_LOWERED:
+      *length = 4; *delta = -1; return true;
+    case StackVM::TVM_STACK_ALLOCA_BY_8BYTE:
+      *length = 2; *delta = code[pc + 1].v_int + 1; return true;
+    case StackVM::TVM_DEVICE_ALLOCA:
+      *length = 1; *delta = -4; return true;
+    case StackVM::TVM_DEVICE_FREE:
+      *length = 1; *delta = -2; return true;
+    case StackVM::TVM_STRUCT_GET:
+      *length = 3; *delta = 0; return true;
+    case StackVM::TVM_STRUCT_SET:
+      *length = 3; *delta = -2; return true;
+    case StackVM::LOAD_HEAP_STRUCT_GET:
+      *length = 4; *delta = 1; return true;
+    case StackVM::CALL_PACKED_HEAP:
+      *length = 6; *delta = 1; return true;
+  }
+  return false;
+}
+
+int64_t StackVM::ComputeMaxStackPointer() const {
+  const int64_t code_size = static_cast<int64_t>(code.size());
+  const int64_t stack_cap = static_cast<int64_t>(stack_size) - 4;
+  // The sp and alloca_sp on entry of each pc. Every path must reach a pc
+  // with the same state, as the code generator emits, otherwise the
+  // program is left to the runtime checks.
+  std::vector<int64_t> entry_sp(code_size, -1);
+  std::vector<int64_t> entry_alloca_sp(code_size, -1);
+  std::vector<int64_t> worklist;
+  int64_t max_sp = 0;
+  // The same invariants as the checks of the interpreter loop.
+  auto visit = [&](int64_t pc, int64_t sp, int64_t alloca_sp) {
+    if (sp < alloca_sp || sp >= stack_cap) return false;
+    max_sp = std::max(max_sp, sp);
+    if (pc == code_size) return true;
+    if (pc < 0 || pc > code_size) return false;
+    if (entry_sp[pc] >= 0) {
+      return entry_sp[pc] == sp && entry_alloca_sp[pc] == alloca_sp;
+    }
+    entry_sp[pc] = sp;
+    entry_alloca_sp[pc] = alloca_sp;
+    worklist.push_back(pc);
+    return true;
+  };
+  if (!visit(0, 0, 0)) return -1;
+  while (!worklist.empty()) {
+    int64_t pc = worklist.back();
+    worklist.pop_back();
+    int64_t sp = entry_sp[pc];
+    int64_t alloca_sp = entry_alloca_sp[pc];
+    int64_t length, delta;
+    // unknown op codes are only caught by the checked loop.
+    if (!GetStackEffect(code.data(), pc, &length, &delta)) return -1;
+    if (pc + length > code_size) return -1;
+    switch (code[pc].op_code) {
+      case RJUMP: {
+        if (!visit(pc + code[pc + 1].v_int, sp, alloca_sp)) return -1;
+        break;
+      }
+      case RJUMP_IF_TRUE:
+      case RJUMP_IF_FALSE: {
+        if (!visit(pc + code[pc + 1].v_int, sp, alloca_sp)) return -1;
+        if (!visit(pc + length, sp, alloca_sp)) return -1;
+        break;
+      }
+      case TVM_STACK_ALLOCA_BY_8BYTE: {
+        if (!visit(pc + length, sp + delta, sp + delta - 1)) return -1;
+        break;
+      }
+      case TVM_THROW_LAST_ERROR: break;
+      default: {
+        if (!visit(pc + length, sp + delta, alloca_sp)) return -1;
+      }
+    }
+  }
+  return max_sp;
+}
+
+/*! \brief Load field kind of index-th element of the struct in handle into dst. */
+inline void StackVMStructGet(void* handle, int index, int kind, TVMValue* dst) {
+  using namespace ir;
+  TVMArray* arr = static_cast<TVMArray*>(handle);
+  switch (kind) {
+    case intrinsic::kArrData: {
+      dst->v_handle = arr[index].data; break;
+    }
+    case intrinsic::kArrShape: {
+      dst->v_handle = arr[index].shape; break;
+    }
+    case intrinsic::kArrStrides: {
+      dst->v_handle = arr[index].strides; break;
+    }
+    case intrinsic::kArrNDim: {
+      dst->v_int64 = arr[index].ndim; break;
+    }
+    case intrinsic::kArrTypeCode: {
+      dst->v_int64 = static_cast<int64_t>(
+          arr[index].dtype.code); break;
+    }
+    case intrinsic::kArrTypeBits: {
+      dst->v_int64 = static_cast<int64_t>(
+          arr[index].dtype.bits); break;
+    }
+    case intrinsic::kArrTypeLanes: {
+      dst->v_int64 = static_cast<int64_t>(
+          arr[index].dtype.lanes); break;
+    }
+    case intrinsic::kArrByteOffset: {
+      dst->v_int64 = static_cast<int64_t>(
+          arr[index].byte_offset); break;
+    }
+    case intrinsic::kArrDeviceId: {
+      dst->v_int64 = arr[index].ctx.device_id; break;
+    }
+    case intrinsic::kArrDeviceType: {
+      dst->v_int64 = static_cast<int64_t>(
+          arr[index].ctx.device_type); break;
+    }
+    case intrinsic::kArrAddr: {
+      dst->v_handle = arr + index; break;
+    }
+    case intrinsic::kTVMValueContent: {
+      *dst = static_cast<TVMValue*>(handle)[index]; break;
+    }
+    default: LOG(FATAL) << "unhandled get " << kind;
+  }
+}
+
 void StackVM::Run(State* s) const {
+  if (max_sp_ >= 0) {
+    this->RunLoop<false>(s);
+  } else {
+    this->RunLoop<true>(s);
+  }
+}
+
+// Use computed goto to dispatch instructions when the compiler supports it,
+// so each instruction gets its own indirect branch.
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_STACK_VM_COMPUTED_GOTO 1
+#else
+#define TVM_STACK_VM_COMPUTED_GOTO 0
+#endif
+
+#define STACK_VM_CHECK_SP()                                             \
+  if (kCheckStack) {                                                    \
+    CHECK_GE(sp, alloca_sp) << "touch allocated space";                 \
+    CHECK_LT(sp, stack_cap) << "Stack overflow";                        \
+  }
+
+#if TVM_STACK_VM_COMPUTED_GOTO
+#define STACK_VM_CASE(CODE) L_ ## CODE
+#define STACK_VM_DISPATCH()                                             \
+  {                                                                     \
+    if (pc >= code_size) goto vm_exit;                                  \
+    if (kCheckStack) {                                                  \
+      CHECK_LE(code[pc].op_code, CALL_PACKED_HEAP)                      \
+          << "unknown op code " << code[pc].op_code;                    \
+    }                                                                   \
+    goto *kDispatchTable[code[pc].op_code];                             \
+  }
+#define STACK_VM_NEXT() { STACK_VM_CHECK_SP(); STACK_VM_DISPATCH(); }
+#else
+#define STACK_VM_CASE(CODE) case CODE
+#define STACK_VM_NEXT() { STACK_VM_CHECK_SP(); continue; }
+#endif
+
+template<bool kCheckStack>
+void StackVM::RunLoop(State* s) const {
   int64_t sp = s->sp;
   int64_t pc = s->pc;
   int64_t alloca_sp = s->sp;
-  std::vector<TVMValue>& stack = s->stack;
-  std::vector<TVMValue>& heap = s->heap;
-  if (stack.size() < stack_size) {
-    stack.resize(stack_size);
+  int64_t stack_need = kCheckStack ?
+      static_cast<int64_t>(stack_size) : max_sp_ + 1;
+  if (static_cast<int64_t>(s->stack.size()) < stack_need) {
+    s->stack.resize(stack_need);
   }
-  int64_t stack_cap = static_cast<int64_t>(stack_size - 4);
-  if (heap.size() < heap_size) {
-    heap.resize(heap_size);
+  if (s->heap.size() < heap_size) {
+    s->heap.resize(heap_size);
   }
-  const int64_t code_size = static_cast<int64_t>(code.size());
+  // keep the hot state in locals so they can stay in registers.
+  TVMValue* stack = s->stack.data();
+  TVMValue* heap = s->heap.data();
+  const Code* code = this->code.data();
+  const int64_t stack_cap = static_cast<int64_t>(stack_size) - 4;
+  const int64_t code_size = static_cast<int64_t>(this->code.size());
+#if TVM_STACK_VM_COMPUTED_GOTO
+  // must follow the order of OpCode.
+  static const void* kDispatchTable[] = {
+    &&L_ADD_I64, &&L_SUB_I64, &&L_MUL_I64, &&L_DIV_I64, &&L_MOD_I64,
+    &&L_EQ_I64, &&L_LT_I64, &&L_LE_I64,
+    &&L_ADD_F64, &&L_SUB_F64, &&L_MUL_F64, &&L_DIV_F64,
+    &&L_EQ_F64, &&L_LT_F64, &&L_LE_F64,
+    &&L_EQ_HANDLE,
+    &&L_ARRAY_LOAD_UINT32, &&L_ARRAY_LOAD_INT32, &&L_ARRAY_LOAD_INT64,
+    &&L_ARRAY_LOAD_FP64, &&L_ARRAY_LOAD_HANDLE, &&L_ARRAY_LOAD_TVMVALUE,
+    &&L_ARRAY_STORE_UINT32, &&L_ARRAY_STORE_INT32, &&L_ARRAY_STORE_INT64,
+    &&L_ARRAY_STORE_FP64, &&L_ARRAY_STORE_HANDLE, &&L_ARRAY_STORE_TVMVALUE,
+    &&L_NOT, &&L_ADDR_ADD, &&L_PUSH_I64, &&L_PUSH_VALUE,
+    &&L_LOAD_HEAP, &&L_STORE_HEAP, &&L_POP, &&L_SELECT, &&L_ASSERT,
+    &&L_RJUMP_IF_TRUE, &&L_RJUMP_IF_FALSE, &&L_RJUMP, &&L_ASSERT_SP,
+    &&L_CALL_PACKED_LOWERED, &&L_TVM_STACK_ALLOCA_BY_8BYTE,
+    &&L_TVM_DEVICE_ALLOCA, &&L_TVM_DEVICE_FREE, &&L_TVM_THROW_LAST_ERROR,
+    &&L_TVM_STRUCT_GET, &&L_TVM_STRUCT_SET,
+    &&L_LOAD_HEAP_STRUCT_GET, &&L_CALL_PACKED_HEAP
+  };
+  static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) ==
+                static_cast<size_t>(CALL_PACKED_HEAP) + 1,
+                "dispatch table must cover all op codes");
+  STACK_VM_DISPATCH();
+#else
   while (pc < code_size) {
     switch (code[pc].op_code) {
-      case ADD_I64: STACK_VM_BINOP(+, v_int64); break;
-      case SUB_I64: STACK_VM_BINOP(-, v_int64); break;
-      case MUL_I64: STACK_VM_BINOP(*, v_int64); break;
-      case DIV_I64: STACK_VM_BINOP(/, v_int64); break;
-      case MOD_I64: STACK_VM_BINOP(%, v_int64); break;
-      case EQ_I64: STACK_VM_CMPOP(==, v_int64); break;
-      case LT_I64: STACK_VM_CMPOP(<, v_int64); break;
-      case LE_I64: STACK_VM_CMPOP(<=, v_int64); break;
-      case ADD_F64: STACK_VM_BINOP(+, v_float64); break;
-      case SUB_F64: STACK_VM_BINOP(-, v_float64); break;
-      case MUL_F64: STACK_VM_BINOP(*, v_float64); break;
-      case DIV_F64: STACK_VM_BINOP(/, v_float64); break;
-      case EQ_F64: STACK_VM_CMPOP(==, v_float64); break;
-      case LT_F64: STACK_VM_CMPOP(<, v_float64); break;
-      case LE_F64: STACK_VM_CMPOP(<=, v_float64); break;
-      case EQ_HANDLE: STACK_VM_CMPOP(==, v_handle); break;
+#endif
+      STACK_VM_CASE(ADD_I64): STACK_VM_BINOP(+, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(SUB_I64): STACK_VM_BINOP(-, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(MUL_I64): STACK_VM_BINOP(*, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(DIV_I64): STACK_VM_BINOP(/, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(MOD_I64): STACK_VM_BINOP(%, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(EQ_I64): STACK_VM_CMPOP(==, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(LT_I64): STACK_VM_CMPOP(<, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(LE_I64): STACK_VM_CMPOP(<=, v_int64); STACK_VM_NEXT();
+      STACK_VM_CASE(ADD_F64): STACK_VM_BINOP(+, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(SUB_F64): STACK_VM_BINOP(-, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(MUL_F64): STACK_VM_BINOP(*, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(DIV_F64): STACK_VM_BINOP(/, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(EQ_F64): STACK_VM_CMPOP(==, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(LT_F64): STACK_VM_CMPOP(<, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(LE_F64): STACK_VM_CMPOP(<=, v_float64); STACK_VM_NEXT();
+      STACK_VM_CASE(EQ_HANDLE): STACK_VM_CMPOP(==, v_handle); STACK_VM_NEXT();
       // addressing
-      case ARRAY_LOAD_UINT32: STACK_VM_LOAD(.v_int64, int64_t, uint32_t); break;
-      case ARRAY_LOAD_INT32: STACK_VM_LOAD(.v_int64, int64_t, int32_t); break;
-      case ARRAY_LOAD_INT64: STACK_VM_LOAD(.v_int64, int64_t, int64_t); break;
-      case ARRAY_LOAD_FP64: STACK_VM_LOAD(.v_float64, double, double); break;
-      case ARRAY_LOAD_HANDLE: STACK_VM_LOAD(.v_handle, void*, void*); break;
-      case ARRAY_LOAD_TVMVALUE: STACK_VM_LOAD(, TVMValue, TVMValue); break;
+      STACK_VM_CASE(ARRAY_LOAD_UINT32): {
+        STACK_VM_LOAD(.v_int64, int64_t, uint32_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_LOAD_INT32): {
+        STACK_VM_LOAD(.v_int64, int64_t, int32_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_LOAD_INT64): {
+        STACK_VM_LOAD(.v_int64, int64_t, int64_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_LOAD_FP64): {
+        STACK_VM_LOAD(.v_float64, double, double); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_LOAD_HANDLE): {
+        STACK_VM_LOAD(.v_handle, void*, void*); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_LOAD_TVMVALUE): {
+        STACK_VM_LOAD(, TVMValue, TVMValue); STACK_VM_NEXT();
+      }
       // store
-      case ARRAY_STORE_UINT32: STACK_VM_STORE(.v_int64, uint32_t); break;
-      case ARRAY_STORE_INT32: STACK_VM_STORE(.v_int64, int32_t); break;
-      case ARRAY_STORE_INT64: STACK_VM_STORE(.v_int64, int64_t); break;
-      case ARRAY_STORE_FP64: STACK_VM_STORE(.v_float64, double); break;
-      case ARRAY_STORE_HANDLE: STACK_VM_STORE(.v_handle, void*); break;
-      case ARRAY_STORE_TVMVALUE: STACK_VM_STORE(, TVMValue); break;
+      STACK_VM_CASE(ARRAY_STORE_UINT32): {
+        STACK_VM_STORE(.v_int64, uint32_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_STORE_INT32): {
+        STACK_VM_STORE(.v_int64, int32_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_STORE_INT64): {
+        STACK_VM_STORE(.v_int64, int64_t); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_STORE_FP64): {
+        STACK_VM_STORE(.v_float64, double); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_STORE_HANDLE): {
+        STACK_VM_STORE(.v_handle, void*); STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(ARRAY_STORE_TVMVALUE): {
+        STACK_VM_STORE(, TVMValue); STACK_VM_NEXT();
+      }
       // add
-      case ADDR_ADD: {
+      STACK_VM_CASE(ADDR_ADD): {
         stack[sp - 1].v_handle = (char*)(stack[sp - 1].v_handle) + stack[sp].v_int64;  // NOLINT(*)
         sp = sp - 1;
         pc = pc + 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case NOT: {
+      STACK_VM_CASE(NOT): {
         stack[sp].v_int64 = !stack[sp].v_int64;
         pc += 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case PUSH_I64: {
+      STACK_VM_CASE(PUSH_I64): {
         stack[sp + 1].v_int64 = code[pc + 1].v_int;
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case PUSH_VALUE: {
+      STACK_VM_CASE(PUSH_VALUE): {
         int relpos = code[pc + 1].v_int;
         CHECK_LE(relpos, 0);
         stack[sp + 1] = stack[sp + relpos];
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case POP: {
+      STACK_VM_CASE(POP): {
         sp -= 1;
         pc += 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case SELECT: {
+      STACK_VM_CASE(SELECT): {
         stack[sp - 2] = (stack[sp].v_int64 ? stack[sp - 2] : stack[sp - 1]);
         sp -= 2;
         pc += 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case LOAD_HEAP: {
+      STACK_VM_CASE(LOAD_HEAP): {
         stack[sp + 1] = heap[code[pc + 1].v_int];
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case STORE_HEAP: {
+      STACK_VM_CASE(STORE_HEAP): {
         heap[code[pc + 1].v_int] = stack[sp];
         sp -= 1;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case ASSERT: {
+      STACK_VM_CASE(ASSERT): {
         CHECK(stack[sp].v_int64) << str_data[code[pc + 1].v_int];
         sp -= 1;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case RJUMP_IF_TRUE: {
+      STACK_VM_CASE(RJUMP_IF_TRUE): {
         if (stack[sp].v_int64) {
           pc += code[pc + 1].v_int;
         } else {
           pc += 2;
         }
-        break;
+        STACK_VM_NEXT();
       }
-      case RJUMP_IF_FALSE: {
+      STACK_VM_CASE(RJUMP_IF_FALSE): {
         if (!stack[sp].v_int64) {
           pc += code[pc + 1].v_int;
         } else {
           pc += 2;
         }
-        break;
+        STACK_VM_NEXT();
       }
-      case RJUMP: {
+      STACK_VM_CASE(RJUMP): {
         pc += code[pc + 1].v_int;
-        break;
+        STACK_VM_NEXT();
       }
-      case ASSERT_SP: {
+      STACK_VM_CASE(ASSERT_SP): {
         int64_t expected = code[pc + 1].v_int;
         CHECK_EQ(sp, expected)
             << "sp assertion failed, expected="
             << expected << " now=" << sp << ", pc=" << pc;
         pc += 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case CALL_PACKED_LOWERED: {
+      STACK_VM_CASE(CALL_PACKED_LOWERED): {
         // call packed function.
         TVMValue* value_stack = static_cast<TVMValue*>(stack[sp - 1].v_handle);
         int* type_stack = static_cast<int*>(stack[sp].v_handle);
@@ -370,63 +686,38 @@ void StackVM::Run(State* s) const {
         sp = sp - 1;
         stack[sp] = rv.value();
         pc += 4;
-        break;
+        STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(CALL_PACKED_HEAP): {
+        TVMValue* value_stack = static_cast<TVMValue*>(heap[code[pc + 1].v_int].v_handle);
+        int* type_stack = static_cast<int*>(heap[code[pc + 2].v_int].v_handle);
+        int call_fid = code[pc + 3].v_int;
+        int begin = code[pc + 4].v_int;
+        int end = code[pc + 5].v_int;
+        int num_args = end - begin;
+        runtime::TVMRetValue rv;
+        GetExtern(s, call_fid).CallPacked(
+            runtime::TVMArgs(value_stack + begin, type_stack + begin, num_args), &rv);
+        sp = sp + 1;
+        stack[sp] = rv.value();
+        pc += 6;
+        STACK_VM_NEXT();
       }
       // intrinsics
-      case TVM_STRUCT_GET: {
-        using namespace ir;
-        int index = code[pc + 1].v_int;
-        int kind = code[pc + 2].v_int;
-        TVMArray* arr = static_cast<TVMArray*>(stack[sp].v_handle);
-        switch (kind) {
-          case intrinsic::kArrData: {
-            stack[sp].v_handle = arr[index].data; break;
-          }
-          case intrinsic::kArrShape: {
-            stack[sp].v_handle = arr[index].shape; break;
-          }
-          case intrinsic::kArrStrides: {
-            stack[sp].v_handle = arr[index].strides; break;
-          }
-          case intrinsic::kArrNDim: {
-            stack[sp].v_int64 = arr[index].ndim; break;
-          }
-          case intrinsic::kArrTypeCode: {
-            stack[sp].v_int64 = static_cast<int64_t>(
-                arr[index].dtype.code); break;
-          }
-          case intrinsic::kArrTypeBits: {
-            stack[sp].v_int64 = static_cast<int64_t>(
-                arr[index].dtype.bits); break;
-          }
-          case intrinsic::kArrTypeLanes: {
-            stack[sp].v_int64 = static_cast<int64_t>(
-                arr[index].dtype.lanes); break;
-          }
-          case intrinsic::kArrByteOffset: {
-            stack[sp].v_int64 = static_cast<int64_t>(
-                arr[index].byte_offset); break;
-            break;
-          }
-          case intrinsic::kArrDeviceId: {
-            stack[sp].v_int64 = arr[index].ctx.device_id; break;
-          }
-          case intrinsic::kArrDeviceType: {
-            stack[sp].v_int64 = static_cast<int64_t>(
-                arr[index].ctx.device_type); break;
-          }
-          case intrinsic::kArrAddr: {
-            stack[sp].v_handle = arr + index; break;
-          }
-          case intrinsic::kTVMValueContent: {
-            stack[sp] = static_cast<TVMValue*>(stack[sp].v_handle)[index]; break;
-          }
-          default: LOG(FATAL) << "unhandled get " << kind;
-        }
+      STACK_VM_CASE(TVM_STRUCT_GET): {
+        StackVMStructGet(stack[sp].v_handle, code[pc + 1].v_int,
+                         code[pc + 2].v_int, &stack[sp]);
         pc = pc + 3;
-        break;
+        STACK_VM_NEXT();
+      }
+      STACK_VM_CASE(LOAD_HEAP_STRUCT_GET): {
+        StackVMStructGet(heap[code[pc + 1].v_int].v_handle, code[pc + 2].v_int,
+                         code[pc + 3].v_int, &stack[sp + 1]);
+        sp = sp + 1;
+        pc = pc + 4;
+        STACK_VM_NEXT();
       }
-      case TVM_STRUCT_SET: {
+      STACK_VM_CASE(TVM_STRUCT_SET): {
         using namespace ir;
         int index = code[pc + 1].v_int;
         int kind = code[pc + 2].v_int;
@@ -478,10 +769,10 @@ void StackVM::Run(State* s) const {
         }
         sp -= 2;
         pc += 3;
-        break;
+        STACK_VM_NEXT();
       }
       // alloca
-      case TVM_STACK_ALLOCA_BY_8BYTE: {
+      STACK_VM_CASE(TVM_STACK_ALLOCA_BY_8BYTE): {
         static_assert(sizeof(TVMValue) == 8, "invariance");
         int num = code[pc + 1].v_int;
         void* addr = &stack[sp] + 1;
@@ -489,9 +780,9 @@ void StackVM::Run(State* s) const {
         alloca_sp = sp - 1;
         stack[sp].v_handle = addr;
         pc = pc + 2;
-        break;
+        STACK_VM_NEXT();
       }
-      case TVM_DEVICE_ALLOCA: {
+      STACK_VM_CASE(TVM_DEVICE_ALLOCA): {
         int device_type = static_cast<int>(stack[sp - 4].v_int64);
         int device_id = static_cast<int>(stack[sp - 3].v_int64);
         size_t nbytes = static_cast<size_t>(stack[sp - 2].v_int64);
@@ -502,9 +793,9 @@ void StackVM::Run(State* s) const {
         stack[sp - 4].v_handle = ptr;
         sp = sp - 4;
         pc = pc + 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case TVM_DEVICE_FREE: {
+      STACK_VM_CASE(TVM_DEVICE_FREE): {
         int device_type = static_cast<int>(stack[sp - 2].v_int64);
         int device_id = static_cast<int>(stack[sp - 1].v_int64);
         void* ptr = stack[sp].v_handle;
@@ -512,16 +803,19 @@ void StackVM::Run(State* s) const {
         stack[sp - 2].v_int64 = ret;
         sp = sp - 2;
         pc = pc + 1;
-        break;
+        STACK_VM_NEXT();
       }
-      case TVM_THROW_LAST_ERROR: {
+      STACK_VM_CASE(TVM_THROW_LAST_ERROR): {
         LOG(FATAL) << TVMGetLastError();
-        break;
+        STACK_VM_NEXT();
       }
+#if TVM_STACK_VM_COMPUTED_GOTO
+ vm_exit:
+  return;
+#else
     }
-    CHECK_GE(sp, alloca_sp) << "touch allocated space";
-    CHECK_LT(sp, stack_cap) << "Stack overflow";
   }
+#endif
 }
 
 const PackedFunc& StackVM::GetExtern(State* s, int fid) const {
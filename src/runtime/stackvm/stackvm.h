@@ -263,7 +263,35 @@ class StackVM {
      *  sp = sp - 1
      * \endcode
      */
-    TVM_STRUCT_SET
+    TVM_STRUCT_SET,
+    // Superinstructions fused from common sequences emitted by codegen.
+    /*!
+     * \brief LOAD_HEAP followed by TVM_STRUCT_GET.
+     * \code
+     *  vid = code[pc + 1].v_int;
+     *  index = code[pc + 2].v_int;
+     *  field = code[pc + 3].v_int;
+     *  stack[sp + 1] = ((StructType*)heap[vid].v_handle)[index]->field;
+     *  sp = sp + 1;
+     *  pc = pc + 4
+     * \endcode
+     */
+    LOAD_HEAP_STRUCT_GET,
+    /*!
+     * \brief call an extern packed function whose argument stacks live in the heap.
+     * \code
+     *  value_stack = heap[code[pc + 1].v_int].v_handle;
+     *  type_stack = heap[code[pc + 2].v_int].v_handle;
+     *  call_fid = code[pc + 3].v_int;
+     *  begin = code[pc + 4].v_int;
+     *  end = code[pc + 5].v_int;
+     *  f = extern_func[call_fid];
+     *  stack[sp + 1] = f(&value_stack[begin:end-1], type_stack[begin:end-1], num_args);
+     *  sp = sp + 1;
+     *  pc = pc + 6
+     * \endcode
+     */
+    CALL_PACKED_HEAP
   };
   /*! \brief The code structure */
   union Code {
@@ -283,7 +311,10 @@ class StackVM {
     /*! \brief The current module context of stackvm */
     runtime::ModuleNode* mod_ctx{nullptr};
   };
-  /*! \brief Initialize local cache*/
+  /*!
+   * \brief Initialize local cache.
+   * \note This also computes the static stack bound of the program.
+   */
   void InitCache();
   /*!
    * \brief Save stackvm program to an output stream
@@ -302,7 +333,11 @@ class StackVM {
    * \return the pc to next instruction.
    */
   int64_t PrintCode(std::ostream&os, int64_t pc) const;  // NOLINT(*)
-  /*! \brief Get thread local state of the stack VM */
+  /*!
+   * \brief Get thread local state of the stack VM.
+   * \note Each nested invocation on the same thread gets its own state,
+   *  the returned state is the one used by the next invocation.
+   */
   static State* ThreadLocalState();
   // The code below are programs
   /*! \brief The instructions */
@@ -390,10 +425,18 @@ class StackVM {
  private:
   //  execute the stack vm with given state
   void Run(State* state) const;
+  // the interpreter loop, stack checks are only done when kCheckStack is set.
+  template<bool kCheckStack>
+  void RunLoop(State* state) const;
+  // compute an upper bound of sp over all paths, return -1 if unknown or
+  // if a path may violate the stack checks of the interpreter loop.
+  int64_t ComputeMaxStackPointer() const;
   // get extern function.
   const PackedFunc& GetExtern(State* s, int fid) const;
   // cached extern function
   mutable std::vector<PackedFunc> extern_func_cache_;
+  // static bound of the stack pointer, -1 if the program need runtime checks.
+  int64_t max_sp_{-1};
 };
 
 }  // namespace runtime
@@ -7,18 +7,88 @@
 #include <dmlc/logging.h>
 #include <thread>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
 #if defined(__linux__) || defined(__ANDROID__)
 #include <fstream>
 #else
 #endif
 #if defined(__linux__)
 #include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 #endif
 
 namespace tvm {
 namespace runtime {
 namespace threading {
 
+// Maximum number of NUMA nodes looked up.
+constexpr int kMaxNUMANodes = 64;
+
+std::vector<unsigned> ParseCPUList(const std::string& cpulist) {
+  std::vector<unsigned> cpus;
+  std::istringstream is(cpulist);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    size_t pos = range.find('-');
+    unsigned begin = std::stoul(range.substr(0, pos));
+    unsigned end = pos == std::string::npos ? begin : std::stoul(range.substr(pos + 1));
+    for (unsigned cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// The cpus of each NUMA node, read from /sys/devices/system/node.
+class NUMATopology {
+ public:
+  static const NUMATopology& Global() {
+    static NUMATopology inst;
+    return inst;
+  }
+  // number of nodes that have cpus.
+  int num_nodes() const {
+    return num_nodes_;
+  }
+  // cpus of the node, empty if the node does not exist.
+  const std::vector<unsigned>& cpus(int node) const {
+    return node_cpus_[node];
+  }
+  // node of the cpu, -1 if unknown.
+  int NodeOf(int cpu) const {
+    for (int node = 0; node < kMaxNUMANodes; ++node) {
+      for (unsigned c : node_cpus_[node]) {
+        if (static_cast<int>(c) == cpu) return node;
+      }
+    }
+    return -1;
+  }
+
+ private:
+  NUMATopology() : node_cpus_(kMaxNUMANodes) {
+#if defined(__linux__) || defined(__ANDROID__)
+    // node ids can be sparse, e.g. nodes with memory only.
+    for (int node = 0; node < kMaxNUMANodes; ++node) {
+      std::ostringstream filepath;
+      filepath << "/sys/devices/system/node/node" << node << "/cpulist";
+      std::ifstream ifs(filepath.str());
+      std::string cpulist;
+      if (ifs.fail() || !(ifs >> cpulist)) continue;
+      node_cpus_[node] = ParseCPUList(cpulist);
+      if (!node_cpus_[node].empty()) ++num_nodes_;
+    }
+#endif
+  }
+
+  std::vector<std::vector<unsigned> > node_cpus_;
+  int num_nodes_{0};
+};
+
 class ThreadGroup::Impl {
  public:
   Impl(int num_workers,
@@ -134,9 +204,19 @@ class ThreadGroup::Impl {
 
   void InitSortedOrder() {
     unsigned int threads = std::thread::hardware_concurrency();
+    std::vector<unsigned int> cpus;
+    // only place the workers on the cpus of the NUMA node if requested.
+    int node = NUMANode();
+    if (node >= 0) {
+      cpus = NUMANodeCPUs(node);
+    } else {
+      for (unsigned int i = 0; i < threads; ++i) {
+        cpus.push_back(i);
+      }
+    }
     std::vector<std::pair <unsigned int, int64_t> > max_freqs;
 
-    for (unsigned int i = 0; i < threads; ++i) {
+    for (unsigned int i : cpus) {
       int64_t cur_freq = 0;
       #if defined(__linux__) || defined(__ANDROID__)
         std::ostringstream filepath;
@@ -204,7 +284,12 @@ int MaxConcurrency() {
   if (val != nullptr) {
     max_concurrency = atoi(val);
   } else {
-    max_concurrency = std::thread::hardware_concurrency();
+    int node = NUMANode();
+    if (node >= 0) {
+      max_concurrency = static_cast<int>(NUMANodeCPUs(node).size());
+    } else {
+      max_concurrency = std::thread::hardware_concurrency();
+    }
 #if defined(_M_X64) || defined(__x86_64__)
     max_concurrency /= 2;  // ignore hyper-threading
 #endif
@@ -212,6 +297,62 @@ int MaxConcurrency() {
   return std::max(max_concurrency, 1);
 }
 
+int NUMANode() {
+  const char *val = getenv("TVM_NUMA_NODE");
+  if (val == nullptr) return -1;
+  const NUMATopology& topo = NUMATopology::Global();
+  // nothing to place on a single node machine.
+  if (topo.num_nodes() <= 1) return -1;
+  if (std::string(val) == "auto") {
+#if defined(__linux__)
+    return topo.NodeOf(sched_getcpu());
+#else
+    return -1;
+#endif
+  }
+  int node = atoi(val);
+  CHECK(node >= 0 && node < kMaxNUMANodes && !topo.cpus(node).empty())
+      << "TVM_NUMA_NODE=" << val << " is not a NUMA node with cpus";
+  return node;
+}
+
+std::vector<unsigned> NUMANodeCPUs(int node) {
+  if (node < 0 || node >= kMaxNUMANodes) return {};
+  return NUMATopology::Global().cpus(node);
+}
+
+size_t NUMAPageSize() {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (NUMANode() < 0) return 0;
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+void BindMemoryToNUMANode(void* ptr, size_t nbytes) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (nbytes == 0) return;
+  int node = NUMANode();
+  if (node < 0) return;
+  // The policy applies to whole pages, binding a part of a page would
+  // move the other objects on it as well.
+  uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  CHECK_EQ(reinterpret_cast<uintptr_t>(ptr) % page_size, 0U)
+      << "The memory bound to a NUMA node must be page aligned";
+  CHECK_EQ(nbytes % page_size, 0U)
+      << "The memory bound to a NUMA node must be a multiple of the page size";
+  // MPOL_PREFERRED, the allocation still succeeds if the node is full.
+  const int kMPolPreferred = 1;
+  const int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT(*)
+  unsigned long nodemask[kMaxNUMANodes / kBitsPerWord] = {0};  // NOLINT(*)
+  nodemask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+  // The policy only applies to the pages that are not touched yet.
+  // The result is ignored as the placement is only an optimization.
+  syscall(SYS_mbind, reinterpret_cast<uintptr_t>(ptr), nbytes, kMPolPreferred,
+          nodemask, kMaxNUMANodes + 1, 0);
+#endif
+}
 
 }  // namespace threading
 }  // namespace runtime
@@ -7,6 +7,7 @@
 #include <tvm/schedule_pass.h>
 #include <tvm/operation.h>
 #include <tvm/ir_pass.h>
+#include <tvm/arithmetic.h>
 #include <unordered_map>
 #include <unordered_set>
 #include "graph.h"
@@ -191,6 +192,8 @@ void InferRootBound(const Stage& stage,
 }
 
 Map<IterVar, Range> InferBound(const Schedule& sch) {
+  // The same index expressions are evaluated for each consumer and stage.
+  arith::EvalSetCacheScope eval_set_cache;
   // Prepare context
   GraphContext ctx;
   Array<Operation> roots;
@@ -0,0 +1,220 @@
+#include <dmlc/logging.h>
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using namespace tvm::runtime;
+using Clock = std::chrono::steady_clock;
+
+const auto kCopyTime = std::chrono::milliseconds(200);
+Clock::time_point copy_end;
+Clock::time_point cpu_op_begin;
+
+// A stream executing its tasks in order on a worker thread.
+class SlowStream {
+ public:
+  SlowStream() : worker_([this]() { this->Loop(); }) {}
+  ~SlowStream() {
+    Push(nullptr);
+    worker_.join();
+  }
+  void Push(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(task);
+    ++num_pushed_;
+    cv_.notify_all();
+  }
+  // Wait for the first n tasks.
+  void Wait(int64_t n) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, n]() { return num_done_ >= n; });
+  }
+  void Wait() {
+    int64_t n;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      n = num_pushed_;
+    }
+    Wait(n);
+  }
+  int64_t num_pushed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_pushed_;
+  }
+
+ private:
+  void Loop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !tasks_.empty(); });
+        task = tasks_.front();
+        tasks_.pop_front();
+      }
+      if (task == nullptr) return;
+      task();
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_done_;
+      cv_.notify_all();
+    }
+  }
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()> > tasks_;
+  int64_t num_pushed_{0};
+  int64_t num_done_{0};
+  std::thread worker_;
+};
+
+// A device with host memory and slow copies, its default stream is synchronous.
+class SlowDeviceAPI final : public DeviceAPI {
+ public:
+  void SetDevice(TVMContext ctx) final {}
+  void GetAttr(TVMContext ctx, DeviceAttrKind kind, TVMRetValue* rv) final {
+    if (kind == kExist) *rv = 1;
+  }
+  void* AllocDataSpace(TVMContext ctx, size_t nbytes, size_t alignment,
+                       TVMType type_hint) final {
+    void* ptr = nullptr;
+    CHECK_EQ(posix_memalign(&ptr, alignment, nbytes), 0);
+    return ptr;
+  }
+  void FreeDataSpace(TVMContext ctx, void* ptr) final {
+    free(ptr);
+  }
+  void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset,
+                      size_t size, TVMContext ctx_from, TVMContext ctx_to,
+                      TVMType type_hint, TVMStreamHandle stream) final {
+    auto fcopy = [=]() {
+      std::this_thread::sleep_for(kCopyTime);
+      memcpy(static_cast<char*>(to) + to_offset,
+             static_cast<const char*>(from) + from_offset, size);
+      if (copy_end == Clock::time_point()) copy_end = Clock::now();
+    };
+    if (stream == nullptr) {
+      fcopy();
+    } else {
+      static_cast<SlowStream*>(stream)->Push(fcopy);
+    }
+  }
+  TVMStreamHandle CreateStream(TVMContext ctx) final {
+    return new SlowStream();
+  }
+  void FreeStream(TVMContext ctx, TVMStreamHandle stream) final {
+    delete static_cast<SlowStream*>(stream);
+  }
+  void StreamSync(TVMContext ctx, TVMStreamHandle stream) final {
+    if (stream != nullptr) static_cast<SlowStream*>(stream)->Wait();
+  }
+  void SyncStreamFromTo(TVMContext ctx, TVMStreamHandle event_src,
+                        TVMStreamHandle event_dst) final {
+    SlowStream* src = static_cast<SlowStream*>(event_src);
+    SlowStream* dst = static_cast<SlowStream*>(event_dst);
+    if (src == nullptr) return;
+    if (dst == nullptr) {
+      src->Wait();
+    } else {
+      int64_t n = src->num_pushed();
+      dst->Push([src, n]() { src->Wait(n); });
+    }
+  }
+};
+
+TVM_REGISTER_GLOBAL("device_api.ext_dev")
+.set_body([](TVMArgs args, TVMRetValue* rv) {
+    static SlowDeviceAPI inst;
+    *rv = static_cast<void*>(&inst);
+  });
+
+class AddOneModule final : public ModuleNode {
+ public:
+  const char* type_key() const final {
+    return "add_one";
+  }
+  PackedFunc GetFunction(const std::string& name,
+                         const std::shared_ptr<ModuleNode>& sptr_to_self) final {
+    bool slow = name == "slow_add_one";
+    return PackedFunc([slow](TVMArgs args, TVMRetValue* rv) {
+        if (slow) {
+          cpu_op_begin = Clock::now();
+          std::this_thread::sleep_for(kCopyTime);
+        }
+        DLTensor* x = args[0];
+        DLTensor* y = args[1];
+        for (int64_t i = 0; i < x->shape[0]; ++i) {
+          static_cast<float*>(y->data)[i] = static_cast<float*>(x->data)[i] + 1;
+        }
+      });
+  }
+};
+
+}  // namespace
+
+TEST(GraphRuntime, AsyncCopy) {
+  // x is copied to the device while the cpu computes x + 1.
+  std::string json = R"({
+    "nodes": [
+      {"op": "null", "name": "x", "inputs": []},
+      {"op": "tvm_op", "name": "copy_x", "inputs": [[0, 0, 0]],
+       "attrs": {"func_name": "__copy", "num_inputs": "1",
+                 "num_outputs": "1", "flatten_data": "0"}},
+      {"op": "tvm_op", "name": "cpu_add", "inputs": [[0, 0, 0]],
+       "attrs": {"func_name": "slow_add_one", "num_inputs": "1",
+                 "num_outputs": "1", "flatten_data": "0"}},
+      {"op": "tvm_op", "name": "dev_add", "inputs": [[1, 0, 0]],
+       "attrs": {"func_name": "add_one", "num_inputs": "1",
+                 "num_outputs": "1", "flatten_data": "0"}},
+      {"op": "tvm_op", "name": "copy_out", "inputs": [[3, 0, 0]],
+       "attrs": {"func_name": "__copy", "num_inputs": "1",
+                 "num_outputs": "1", "flatten_data": "0"}}
+    ],
+    "arg_nodes": [0],
+    "node_row_ptr": [0, 1, 2, 3, 4, 5],
+    "heads": [[2, 0, 0], [4, 0, 0]],
+    "attrs": {
+      "dltype": ["list_str", ["float32", "float32", "float32", "float32", "float32"]],
+      "storage_id": ["list_int", [0, 1, 2, 3, 4]],
+      "shape": ["list_shape", [[4], [4], [4], [4], [4]]],
+      "device_index": ["list_int", [1, 12, 1, 12, 1]]
+    }
+  })";
+  Module mod(std::make_shared<AddOneModule>());
+  const PackedFunc* create = Registry::Get("tvm.graph_runtime.create");
+  CHECK(create != nullptr);
+  Module graph = (*create)(json, mod, static_cast<int>(kDLCPU), 0,
+                           static_cast<int>(kDLExtDev), 0);
+  TVMContext cpu{kDLCPU, 0};
+  NDArray x = NDArray::Empty({4}, DLDataType{kDLFloat, 32, 1}, cpu);
+  for (int i = 0; i < 4; ++i) {
+    static_cast<float*>(x->data)[i] = static_cast<float>(i);
+  }
+  graph.GetFunction("set_input")(0, x);
+  graph.GetFunction("run")();
+  // The cpu op started before the first copy finished.
+  CHECK(cpu_op_begin < copy_end);
+  for (int k = 0; k < 2; ++k) {
+    NDArray y = graph.GetFunction("get_output")(k);
+    for (int i = 0; i < 4; ++i) {
+      CHECK_EQ(static_cast<float*>(y->data)[i], i + 1.0f);
+    }
+  }
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
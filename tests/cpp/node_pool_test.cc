@@ -0,0 +1,58 @@
+#include <dmlc/logging.h>
+#include <gtest/gtest.h>
+#include <tvm/node_pool.h>
+#include <tvm/relay/expr.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(NodePool, Basic) {
+  using namespace tvm;
+  const NodePoolStats& stats = NodePoolAllocator<relay::TupleNode>::Stats();
+  int64_t num_alloc = stats.num_alloc;
+  int64_t num_free = stats.num_free;
+  {
+    std::vector<relay::Tuple> tuples;
+    for (int i = 0; i < 1000; ++i) {
+      tuples.push_back(relay::TupleNode::make({}));
+    }
+    CHECK_EQ(stats.num_alloc - num_alloc, 1000);
+    CHECK_GT(stats.num_slab, 0);
+  }
+  CHECK_EQ(stats.num_free - num_free, 1000);
+}
+
+TEST(NodePool, MultiThread) {
+  using namespace tvm;
+  const NodePoolStats& stats = NodePoolAllocator<relay::TupleNode>::Stats();
+  int64_t num_live = stats.num_alloc - stats.num_free;
+  relay::Tuple shared = relay::TupleNode::make({});
+  std::vector<relay::Tuple> nodes;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      std::vector<relay::Tuple> local;
+      for (int i = 0; i < 10000; ++i) {
+        local.push_back(relay::TupleNode::make({shared}));
+        if (i % 2 == 0) local.pop_back();
+      }
+      // nodes freed by other threads are recycled through their caches.
+      std::lock_guard<std::mutex> lock(mutex);
+      for (const auto& n : local) nodes.push_back(n);
+    });
+  }
+  for (auto& t : threads) t.join();
+  CHECK_EQ(nodes.size(), 20000U);
+  for (const auto& n : nodes) {
+    CHECK(n->fields[0].same_as(shared));
+  }
+  nodes.clear();
+  CHECK_EQ(stats.num_alloc - stats.num_free, num_live + 1);
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -1,8 +1,13 @@
 #include <dmlc/logging.h>
 #include <gtest/gtest.h>
 #include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/tvm.h>
 #include <tvm/ir.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST(PackedFunc, Basic) {
   using namespace tvm;
@@ -207,6 +212,49 @@ TEST(PackedFunc, ExtensionType) {
   CHECK_EQ(vret2[2], 4);
 }
 
+TEST(Registry, ConcurrentGet) {
+  using namespace tvm::runtime;
+  const int num_threads = 4;
+  const int num_funcs = 2000;
+  // lookups of existing functions while the table grows.
+  Registry::Register("test.registry.base")
+  .set_body([](TVMArgs args, TVMRetValue* rv) { *rv = 1; });
+  const PackedFunc* base = Registry::Get("test.registry.base");
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int k = 0; k < num_threads; ++k) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        const PackedFunc* f = Registry::Get("test.registry.base");
+        CHECK(f == base);
+        int ret = (*f)();
+        CHECK_EQ(ret, 1);
+      }
+    });
+  }
+  for (int i = 0; i < num_funcs; ++i) {
+    std::string name = "test.registry.f" + std::to_string(i);
+    Registry::Register(name).set_body([i](TVMArgs args, TVMRetValue* rv) { *rv = i; });
+  }
+  done.store(true);
+  for (auto& t : readers) t.join();
+  for (int i = 0; i < num_funcs; ++i) {
+    std::string name = "test.registry.f" + std::to_string(i);
+    int ret = (*Registry::Get(name))();
+    CHECK_EQ(ret, i);
+    CHECK(Registry::Remove(name));
+    CHECK(Registry::Get(name) == nullptr);
+    CHECK(!Registry::Remove(name));
+  }
+  // the handle stays valid when the name is registered again.
+  CHECK(Registry::Remove("test.registry.base"));
+  Registry::Register("test.registry.base")
+  .set_body([](TVMArgs args, TVMRetValue* rv) { *rv = 2; });
+  CHECK(Registry::Get("test.registry.base") == base);
+  int ret = (*base)();
+  CHECK_EQ(ret, 2);
+}
+
 
 int main(int argc, char ** argv) {
   testing::InitGoogleTest(&argc, argv);
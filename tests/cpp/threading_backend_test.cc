@@ -0,0 +1,118 @@
+#include <dmlc/logging.h>
+#include <gtest/gtest.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/threading_backend.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using namespace tvm::runtime::threading;
+
+namespace {
+
+// The cpus the workers may run on when placed on the node.
+std::vector<unsigned> ExpectedCPUs(int node) {
+  if (node >= 0) return NUMANodeCPUs(node);
+  std::vector<unsigned> cpus;
+  for (unsigned i = 0; i < std::thread::hardware_concurrency(); ++i) {
+    cpus.push_back(i);
+  }
+  return cpus;
+}
+
+}  // namespace
+
+TEST(ThreadingBackend, ParseCPUList) {
+  CHECK(ParseCPUList("0-3,8,10-11") ==
+        std::vector<unsigned>({0, 1, 2, 3, 8, 10, 11}));
+  CHECK(ParseCPUList("5") == std::vector<unsigned>({5}));
+  CHECK(ParseCPUList("2,4") == std::vector<unsigned>({2, 4}));
+  CHECK(ParseCPUList("").empty());
+}
+
+TEST(ThreadingBackend, NUMANodeMaxConcurrency) {
+  unsetenv("TVM_NUM_THREADS");
+  unsetenv("OMP_NUM_THREADS");
+  unsetenv("TVM_NUMA_NODE");
+  int default_concurrency = MaxConcurrency();
+  CHECK_EQ(NUMANode(), -1);
+  CHECK_EQ(NUMAPageSize(), 0U);
+
+  setenv("TVM_NUMA_NODE", "0", 1);
+  int node = NUMANode();
+  if (node < 0) {
+    // nothing is placed on a single node machine.
+    CHECK_EQ(MaxConcurrency(), default_concurrency);
+  } else {
+    CHECK_EQ(node, 0);
+    int expected = static_cast<int>(NUMANodeCPUs(node).size());
+#if defined(_M_X64) || defined(__x86_64__)
+    expected /= 2;
+#endif
+    CHECK_EQ(MaxConcurrency(), std::max(expected, 1));
+  }
+  // the number of threads given by the user takes precedence.
+  setenv("TVM_NUM_THREADS", "3", 1);
+  CHECK_EQ(MaxConcurrency(), 3);
+  unsetenv("TVM_NUM_THREADS");
+  unsetenv("TVM_NUMA_NODE");
+}
+
+#if defined(__linux__)
+TEST(ThreadingBackend, NUMANodeAffinity) {
+  unsetenv("TVM_NUM_THREADS");
+  unsetenv("OMP_NUM_THREADS");
+  unsetenv("TVM_BIND_THREADS");
+  setenv("TVM_NUMA_NODE", "0", 1);
+  int node = NUMANode();
+  std::vector<unsigned> expected = ExpectedCPUs(node);
+  int num_workers = MaxConcurrency();
+  std::atomic<bool> configured{false};
+  std::mutex mutex;
+  std::vector<int> cpus;
+  {
+    ThreadGroup group(num_workers, [&](int worker_id) {
+        while (!configured.load()) std::this_thread::yield();
+        int cpu = sched_getcpu();
+        std::lock_guard<std::mutex> lock(mutex);
+        cpus.push_back(cpu);
+      }, false);
+    group.Configure(ThreadGroup::kBig, 0, false);
+    configured = true;
+    group.Join();
+  }
+  CHECK_EQ(cpus.size(), static_cast<size_t>(num_workers));
+  // the workers are only placed on the cpus of the node.
+  for (int cpu : cpus) {
+    CHECK(std::find(expected.begin(), expected.end(),
+                    static_cast<unsigned>(cpu)) != expected.end())
+        << "worker on cpu " << cpu << " outside of node " << node;
+  }
+  unsetenv("TVM_NUMA_NODE");
+}
+#endif
+
+TEST(ThreadingBackend, NUMAPageAlignedAllocation) {
+  using tvm::runtime::NDArray;
+  setenv("TVM_NUMA_NODE", "0", 1);
+  size_t page_size = NUMAPageSize();
+  // the cpu memory bound to the node has whole pages of its own.
+  NDArray a = NDArray::Empty({10}, DLDataType{kDLFloat, 32, 1}, DLContext{kDLCPU, 0});
+  if (page_size != 0) {
+    CHECK_EQ(reinterpret_cast<uintptr_t>(a->data) % page_size, 0U);
+  }
+  unsetenv("TVM_NUMA_NODE");
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
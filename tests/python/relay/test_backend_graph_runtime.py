@@ -94,6 +94,28 @@ def test_with_params():
     tvm.testing.assert_allclose(res, ref_res)
 
 
+def test_dedup_params():
+    x = relay.var('x', shape=(10, 5))
+    c_data = np.random.rand(10, 5).astype('float32')
+    d_data = np.random.rand(10, 5).astype('float32')
+    # c1 and c2 have the same content.
+    c1 = relay.const(c_data)
+    c2 = relay.const(c_data.copy())
+    d = relay.const(d_data)
+    z = relay.multiply(relay.add(x, c1), c2)
+    z = relay.subtract(z, d)
+    func = relay.Function([x], z)
+    graph, lib, params = relay.build(func, "llvm")
+    assert len(params) == 2
+    x_data = np.random.rand(10, 5).astype('float32')
+    mod = graph_runtime.create(graph, lib, ctx=tvm.cpu(0))
+    mod.set_input(**params)
+    mod.set_input(x=x_data)
+    mod.run()
+    res = mod.get_output(0).asnumpy()
+    tvm.testing.assert_allclose(res, (x_data + c_data) * c_data - d_data)
+
+
 def test_plan_memory():
     # it is sufficient to cycle through two memories.
 
@@ -130,6 +152,7 @@ def test_plan_memory():
 if __name__ == "__main__":
     test_plan_memory()
     test_with_params()
+    test_dedup_params()
     test_add_op_scalar()
     test_add_op_tensor()
     test_add_op_broadcast()
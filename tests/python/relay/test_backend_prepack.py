@@ -0,0 +1,96 @@
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_runtime
+from tvm.relay.backend import prepack
+
+
+def test_extract_weight_transforms():
+    x = relay.var("x", shape=(4, 8))
+    w = relay.var("w", shape=(8, 16))
+    b = relay.var("b", shape=(16,))
+    wt = relay.transpose(w) * relay.const(2.0)
+    y = relay.nn.bias_add(relay.nn.dense(x, wt), b + relay.sum(x))
+    func = relay.ir_pass.infer_type(relay.Function([x, w, b], y))
+    main, packed_func, names = prepack.extract_weight_transforms(
+        func, ["w", "b"], "llvm")
+    # b is added to the input, so only the transformation of w is packed.
+    assert names == ["w@llvm"]
+    assert [p.name_hint for p in main.params] == ["x", "b", "w@llvm"]
+    assert [p.name_hint for p in packed_func.params] == ["w"]
+    main, packed_func, names = prepack.extract_weight_transforms(func, ["b"], "llvm")
+    assert main == func and packed_func is None and not names
+
+
+def test_build_prepacked():
+    x = relay.var("x", shape=(4, 8))
+    w = relay.var("w", shape=(8, 16))
+    b = relay.var("b", shape=(16,))
+    wt = relay.transpose(w) * relay.const(2.0)
+    y = relay.nn.bias_add(relay.nn.dense(x, wt), b)
+    func = relay.Function([x, w, b], y)
+    x_data = np.random.uniform(size=(4, 8)).astype("float32")
+    raw = {"w": np.random.uniform(size=(8, 16)).astype("float32"),
+           "b": np.random.uniform(size=(16,)).astype("float32")}
+    ref = np.dot(x_data, raw["w"] * 2.0) + raw["b"]
+    if not tvm.module.enabled("llvm"):
+        return
+    graph, lib, params, prepacker = relay.build_prepacked(func, "llvm", params=raw)
+    assert prepacker.packed_names == ["w@llvm"]
+    assert "w" not in params and "b" in params
+    ctx = tvm.cpu(0)
+
+    def check(all_params):
+        m = graph_runtime.create(graph, lib, ctx)
+        prepacker.load_params(m, all_params)
+        m.run(x=x_data)
+        tvm.testing.assert_allclose(m.get_output(0).asnumpy(), ref, rtol=1e-5)
+
+    # transform on load.
+    check(raw)
+    # the transformation is redone for other raw weights.
+    tuned = {"w": np.random.uniform(size=(8, 16)).astype("float32"), "b": raw["b"]}
+    m = graph_runtime.create(graph, lib, ctx)
+    prepacker.load_params(m, tuned)
+    m.run(x=x_data)
+    tvm.testing.assert_allclose(m.get_output(0).asnumpy(),
+                                np.dot(x_data, tuned["w"] * 2.0) + raw["b"], rtol=1e-5)
+    check(raw)
+    # the weights prepacked for the target, and for another one.
+    packed = prepacker.prepack(raw)
+    all_params = dict(params)
+    all_params.update(packed)
+    all_params["w@cuda"] = packed["w@llvm"]
+    check(all_params)
+
+
+def test_build_prepacked_conv2d():
+    x = relay.var("x", shape=(1, 16, 8, 8))
+    w = relay.var("w", shape=(32, 16, 3, 3))
+    y = relay.nn.conv2d(x, w, channels=32, kernel_size=(3, 3), padding=(1, 1))
+    y = relay.nn.relu(y)
+    func = relay.Function([x, w], y)
+    x_data = np.random.uniform(size=(1, 16, 8, 8)).astype("float32")
+    raw = {"w": np.random.uniform(size=(32, 16, 3, 3)).astype("float32")}
+    if not tvm.module.enabled("llvm"):
+        return
+    ctx = tvm.cpu(0)
+    with relay.build_config(opt_level=3):
+        graph, lib, params = relay.build(func, "llvm", params=raw)
+        m = graph_runtime.create(graph, lib, ctx)
+        m.set_input(**params)
+        m.run(x=x_data)
+        ref = m.get_output(0).asnumpy()
+        graph, lib, params, prepacker = relay.build_prepacked(
+            func, "llvm", params=raw)
+    m = graph_runtime.create(graph, lib, ctx)
+    prepacker.load_params(m, raw)
+    m.run(x=x_data)
+    tvm.testing.assert_allclose(m.get_output(0).asnumpy(), ref, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_extract_weight_transforms()
+    test_build_prepacked()
+    test_build_prepacked_conv2d()
@@ -228,6 +228,20 @@ def test_conv2d_attrs():
     check_json_roundtrip(out)
 
 
+def test_node_pool():
+    x = relay.var("x", shape=(10,))
+    before = tvm.node_pool_stats()["relay.Call"]
+    calls = [relay.add(x, x) for _ in range(100)]
+    stats = tvm.node_pool_stats()["relay.Call"]
+    assert stats["alloc"] >= before["alloc"] + 100
+    assert stats["live"] >= 100
+    assert stats["slab_bytes"] > 0
+    del calls
+    after = tvm.node_pool_stats()["relay.Call"]
+    assert after["free"] >= stats["free"] + 100
+    check_json_roundtrip(relay.add(x, x))
+
+
 if __name__ == "__main__":
     test_bad_constructor()
     test_span()
@@ -247,3 +261,4 @@ if __name__ == "__main__":
     test_tuple_get_item()
     test_op()
     test_conv2d_attrs()
+    test_node_pool()
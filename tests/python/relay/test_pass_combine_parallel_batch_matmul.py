@@ -0,0 +1,97 @@
+from tvm import relay
+
+
+def test_combine_parallel_batch_matmul():
+    """Simple testcase, batch_matmul with different N are combined."""
+    def before(x, y1, y2, y3, y4):
+        args = [x, y1, y2, y3, y4]
+        z1 = relay.nn.batch_matmul(x, y1)
+        z2 = relay.nn.batch_matmul(x, y2)
+        # z3 is not a batch_matmul
+        z3 = relay.nn.relu(x)
+        z4 = relay.nn.batch_matmul(x, y4)
+        z = relay.Tuple((z1, z2, z3, z4))
+        return relay.Function(args, z)
+
+    def expected(x, y1, y2, y3, y4, n1, n2, n4):
+        # use a fixed order of args so alpha equal check can pass
+        args = [x, y1, y2, y3, y4]
+        y = relay.concatenate((y1, y2, y4), axis=1)
+        z = relay.nn.batch_matmul(x, y)
+        z1 = relay.strided_slice(z, [0, 0, 0], [None, None, n1])
+        z2 = relay.strided_slice(z, [0, 0, n1], [None, None, n1 + n2])
+        z3 = relay.nn.relu(x)
+        z4 = relay.strided_slice(z, [0, 0, n1 + n2], [None, None, n1 + n2 + n4])
+        z = relay.Tuple((z1, z2, z3, z4))
+        return relay.Function(args, z)
+
+    def check(b, i, j, k):
+        x = relay.var("x", shape=(b, i, k))
+        y1 = relay.var("y1", shape=(b, j, k))
+        y2 = relay.var("y2", shape=(b, 2 * j, k))
+        y3 = relay.var("y3", shape=(b, 3 * j, k))
+        y4 = relay.var("y4", shape=(b, j, k))
+
+        z_before = before(x, y1, y2, y3, y4)
+        z = relay.ir_pass.infer_type(z_before)
+        z = relay.ir_pass.combine_parallel_batch_matmul(z)
+        z = relay.ir_pass.infer_type(z)
+        z_expected = expected(x, y1, y2, y3, y4, j, 2 * j, j)
+        z_expected = relay.ir_pass.infer_type(z_expected)
+        assert relay.ir_pass.alpha_equal(z, z_expected)
+
+    check(2, 3, 5, 4)
+    check(4, 100, 200, 300)
+
+
+def test_combine_parallel_batch_matmul_biasadd():
+    """Testcase of combining batch_matmul + add + relu"""
+    def before(x, y1, y2, y3, b1, b2, b3):
+        args = [x, y1, y2, y3, b1, b2, b3]
+        zs = []
+        for y, b in [(y1, b1), (y2, b2), (y3, b3)]:
+            z = relay.nn.batch_matmul(x, y)
+            z = relay.add(z, b)
+            zs.append(relay.nn.relu(z))
+        return relay.Function(args, relay.Tuple(zs))
+
+    def expected(x, y1, y2, y3, b1, b2, b3, n):
+        args = [x, y1, y2, y3, b1, b2, b3]
+        y = relay.concatenate((y1, y2, y3), axis=1)
+        b = relay.concatenate((b1, b2, b3), axis=0)
+        z = relay.nn.batch_matmul(x, y)
+        z = relay.add(z, b)
+        z = relay.nn.relu(z)
+        zs = [relay.strided_slice(z, [0, 0, i * n], [None, None, (i + 1) * n])
+              for i in range(3)]
+        return relay.Function(args, relay.Tuple(zs))
+
+    def check(b, i, j, k):
+        x = relay.var("x", shape=(b, i, k))
+        y1 = relay.var("y1", shape=(b, j, k))
+        y2 = relay.var("y2", shape=(b, j, k))
+        y3 = relay.var("y3", shape=(b, j, k))
+        b1 = relay.var("b1", shape=(j,))
+        b2 = relay.var("b2", shape=(j,))
+        b3 = relay.var("b3", shape=(j,))
+
+        z_before = before(x, y1, y2, y3, b1, b2, b3)
+        z = relay.ir_pass.infer_type(z_before)
+        z = relay.ir_pass.combine_parallel_batch_matmul(z)
+        z = relay.ir_pass.infer_type(z)
+        z_expected = expected(x, y1, y2, y3, b1, b2, b3, j)
+        z_expected = relay.ir_pass.infer_type(z_expected)
+        assert relay.ir_pass.alpha_equal(z, z_expected)
+
+        # two branches are below the default threshold
+        z = relay.ir_pass.infer_type(relay.Function([x, y1, y2],
+            relay.Tuple((relay.nn.batch_matmul(x, y1), relay.nn.batch_matmul(x, y2)))))
+        assert relay.ir_pass.alpha_equal(relay.ir_pass.combine_parallel_batch_matmul(z), z)
+
+    check(2, 3, 5, 4)
+    check(4, 100, 200, 300)
+
+
+if __name__ == "__main__":
+    test_combine_parallel_batch_matmul()
+    test_combine_parallel_batch_matmul_biasadd()
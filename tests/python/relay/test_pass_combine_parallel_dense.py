@@ -0,0 +1,98 @@
+from tvm import relay
+
+
+def test_combine_parallel_dense():
+    """Simple testcase, dense with different units are combined."""
+    def before(x, w1, w2, w3, w4):
+        args = [x, w1, w2, w3, w4]
+        y1 = relay.nn.dense(x, w1)
+        y2 = relay.nn.dense(x, w2)
+        # y3 is not a dense
+        y3 = relay.nn.relu(x)
+        y4 = relay.nn.dense(x, w4)
+        y = relay.Tuple((y1, y2, y3, y4))
+        return relay.Function(args, y)
+
+    def expected(x, w1, w2, w3, w4, units1, units2, units4):
+        # use a fixed order of args so alpha equal check can pass
+        args = [x, w1, w2, w3, w4]
+        w = relay.concatenate((w1, w2, w4), axis=0)
+        y = relay.nn.dense(x, w, units=units1 + units2 + units4)
+        y1 = relay.strided_slice(y, [0, 0], [None, units1])
+        y2 = relay.strided_slice(y, [0, units1], [None, units1 + units2])
+        y3 = relay.nn.relu(x)
+        y4 = relay.strided_slice(y, [0, units1 + units2],
+                                 [None, units1 + units2 + units4])
+        y = relay.Tuple((y1, y2, y3, y4))
+        return relay.Function(args, y)
+
+    def check(i, j, k):
+        x = relay.var("x", shape=(i, k))
+        w1 = relay.var("w1", shape=(j, k))
+        w2 = relay.var("w2", shape=(2 * j, k))
+        w3 = relay.var("w3", shape=(3 * j, k))
+        w4 = relay.var("w4", shape=(j, k))
+
+        y_before = before(x, w1, w2, w3, w4)
+        y = relay.ir_pass.infer_type(y_before)
+        y = relay.ir_pass.combine_parallel_dense(y)
+        y = relay.ir_pass.infer_type(y)
+        y_expected = expected(x, w1, w2, w3, w4, j, 2 * j, j)
+        y_expected = relay.ir_pass.infer_type(y_expected)
+        assert relay.ir_pass.alpha_equal(y, y_expected)
+
+    check(3, 5, 4)
+    check(100, 200, 300)
+
+
+def test_combine_parallel_dense_biasadd():
+    """Testcase of combining dense + 1d biasadd + relu"""
+    def before(x, w1, w2, w3, b1, b2, b3):
+        args = [x, w1, w2, w3, b1, b2, b3]
+        ys = []
+        for w, b in [(w1, b1), (w2, b2), (w3, b3)]:
+            y = relay.nn.dense(x, w)
+            y = relay.add(y, b)
+            ys.append(relay.nn.relu(y))
+        return relay.Function(args, relay.Tuple(ys))
+
+    def expected(x, w1, w2, w3, b1, b2, b3, units):
+        args = [x, w1, w2, w3, b1, b2, b3]
+        w = relay.concatenate((w1, w2, w3), axis=0)
+        b = relay.concatenate((b1, b2, b3), axis=0)
+        y = relay.nn.dense(x, w, units=3 * units)
+        y = relay.add(y, b)
+        y = relay.nn.relu(y)
+        ys = [relay.strided_slice(y, [0, i * units], [None, (i + 1) * units])
+              for i in range(3)]
+        return relay.Function(args, relay.Tuple(ys))
+
+    def check(i, j, k):
+        x = relay.var("x", shape=(i, k))
+        w1 = relay.var("w1", shape=(j, k))
+        w2 = relay.var("w2", shape=(j, k))
+        w3 = relay.var("w3", shape=(j, k))
+        b1 = relay.var("b1", shape=(j,))
+        b2 = relay.var("b2", shape=(j,))
+        b3 = relay.var("b3", shape=(j,))
+
+        y_before = before(x, w1, w2, w3, b1, b2, b3)
+        y = relay.ir_pass.infer_type(y_before)
+        y = relay.ir_pass.combine_parallel_dense(y)
+        y = relay.ir_pass.infer_type(y)
+        y_expected = expected(x, w1, w2, w3, b1, b2, b3, j)
+        y_expected = relay.ir_pass.infer_type(y_expected)
+        assert relay.ir_pass.alpha_equal(y, y_expected)
+
+        # two branches are below the default threshold
+        y = relay.ir_pass.infer_type(relay.Function([x, w1, w2],
+            relay.Tuple((relay.nn.dense(x, w1), relay.nn.dense(x, w2)))))
+        assert relay.ir_pass.alpha_equal(relay.ir_pass.combine_parallel_dense(y), y)
+
+    check(3, 5, 4)
+    check(100, 200, 300)
+
+
+if __name__ == "__main__":
+    test_combine_parallel_dense()
+    test_combine_parallel_dense_biasadd()
@@ -0,0 +1,80 @@
+from tvm import relay
+
+
+def test_combine_parallel_add():
+    """Combine add + multiply branches on a shared input"""
+    def before(x, b1, b2, b3, s1, s2, s3):
+        args = [x, b1, b2, b3, s1, s2, s3]
+        ys = []
+        for b, s in [(b1, s1), (b2, s2), (b3, s3)]:
+            y = relay.add(x, b)
+            ys.append(relay.multiply(y, s))
+        return relay.Function(args, relay.Tuple(ys))
+
+    def expected(x, b1, b2, b3, s1, s2, s3):
+        args = [x, b1, b2, b3, s1, s2, s3]
+        def stack(ts):
+            return relay.concatenate(
+                [relay.expand_dims(relay.expand_dims(t, axis=0, num_newaxis=1),
+                                   axis=0, num_newaxis=1) for t in ts], axis=0)
+        y = relay.add(x, stack((b1, b2, b3)))
+        y = relay.multiply(y, stack((s1, s2, s3)))
+        ys = [relay.squeeze(relay.strided_slice(y, [i], [i + 1]), axis=[0])
+              for i in range(3)]
+        return relay.Function(args, relay.Tuple(ys))
+
+    def check(i, j):
+        x = relay.var("x", shape=(i, j))
+        bs = [relay.var("b%d" % k, shape=(j,)) for k in range(3)]
+        ss = [relay.var("s%d" % k, shape=(j,)) for k in range(3)]
+
+        y_before = before(x, *(bs + ss))
+        y = relay.ir_pass.infer_type(y_before)
+        y = relay.ir_pass.combine_parallel_op_batch(y, "add")
+        y = relay.ir_pass.infer_type(y)
+        y_expected = expected(x, *(bs + ss))
+        y_expected = relay.ir_pass.infer_type(y_expected)
+        assert relay.ir_pass.alpha_equal(y, y_expected)
+
+    check(4, 8)
+
+
+def test_combine_parallel_add_bias_add():
+    """Ops with an axis attribute are not combined"""
+    def before(x, bs, cs):
+        ys = []
+        for b, c in zip(bs, cs):
+            y = relay.add(x, b)
+            ys.append(relay.nn.bias_add(y, c, axis=1))
+        return relay.Function([x] + bs + cs, relay.Tuple(ys))
+
+    def expected(x, bs, cs):
+        y = relay.add(x, relay.concatenate(
+            [relay.expand_dims(relay.expand_dims(b, axis=0, num_newaxis=1),
+                               axis=0, num_newaxis=1) for b in bs], axis=0))
+        ys = []
+        for i, c in enumerate(cs):
+            yi = relay.squeeze(relay.strided_slice(y, [i], [i + 1]), axis=[0])
+            ys.append(relay.nn.bias_add(yi, c, axis=1))
+        return relay.Function([x] + bs + cs, relay.Tuple(ys))
+
+    x = relay.var("x", shape=(4, 8))
+    bs = [relay.var("b%d" % k, shape=(8,)) for k in range(3)]
+    cs = [relay.var("c%d" % k, shape=(8,)) for k in range(3)]
+    # the following bias_add stays in the branches.
+    y = relay.ir_pass.infer_type(before(x, bs, cs))
+    y = relay.ir_pass.combine_parallel_op_batch(y, "add")
+    y = relay.ir_pass.infer_type(y)
+    y_expected = relay.ir_pass.infer_type(expected(x, bs, cs))
+    assert relay.ir_pass.alpha_equal(y, y_expected)
+    # bias_add does not start a combined group.
+    f = relay.Function([x] + cs, relay.Tuple([relay.nn.bias_add(x, c, axis=1) for c in cs]))
+    f = relay.ir_pass.infer_type(f)
+    y = relay.ir_pass.combine_parallel_op_batch(f, "nn.bias_add")
+    y = relay.ir_pass.infer_type(y)
+    assert relay.ir_pass.alpha_equal(y, f)
+
+
+if __name__ == "__main__":
+    test_combine_parallel_add()
+    test_combine_parallel_add_bias_add()
@@ -0,0 +1,54 @@
+from tvm import relay
+
+
+def test_simple():
+    def before():
+        x = relay.var("x", shape=(1, 16))
+        y1 = relay.nn.relu(x)
+        y2 = relay.nn.relu(x)
+        y1 = relay.add(y1, relay.const(1.0, "float32"))
+        y2 = relay.add(y2, relay.const(1.0, "float32"))
+        y = relay.add(y1, y2)
+        f = relay.Function([x], y)
+        return f
+
+    def expected():
+        x = relay.var("x", shape=(1, 16))
+        y = relay.nn.relu(x)
+        y = relay.add(y, relay.const(1.0, "float32"))
+        y = relay.add(y, y)
+        f = relay.Function([x], y)
+        return f
+
+    z = before()
+    z = relay.ir_pass.eliminate_common_subexpr(z)
+    assert relay.ir_pass.alpha_equal(z, expected())
+
+
+def test_attrs():
+    def before():
+        x = relay.var("x", shape=(1, 16, 4))
+        y1 = relay.transpose(x, axes=(0, 2, 1))
+        y2 = relay.transpose(x, axes=(0, 2, 1))
+        # different attributes are kept
+        y3 = relay.transpose(x, axes=(2, 1, 0))
+        y = relay.Tuple([relay.add(y1, y2), y3])
+        f = relay.Function([x], y)
+        return f
+
+    def expected():
+        x = relay.var("x", shape=(1, 16, 4))
+        y1 = relay.transpose(x, axes=(0, 2, 1))
+        y3 = relay.transpose(x, axes=(2, 1, 0))
+        y = relay.Tuple([relay.add(y1, y1), y3])
+        f = relay.Function([x], y)
+        return f
+
+    z = before()
+    z = relay.ir_pass.eliminate_common_subexpr(z)
+    assert relay.ir_pass.alpha_equal(z, expected())
+
+
+if __name__ == "__main__":
+    test_simple()
+    test_attrs()
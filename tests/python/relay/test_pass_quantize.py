@@ -0,0 +1,98 @@
+import numpy as np
+import tvm
+from tvm import relay
+from tvm.contrib import graph_runtime
+from tvm.relay import quantize as qtz
+
+
+def make_dataset(shape, num):
+    return [{"data": np.random.uniform(-1, 1, size=shape).astype("float32")}
+            for _ in range(num)]
+
+
+def make_graph(dshape):
+    data = relay.var("data", shape=dshape)
+    w1 = relay.var("w1")
+    w2 = relay.var("w2")
+    b2 = relay.var("b2")
+    y = relay.nn.conv2d(data, w1, channels=8, kernel_size=(3, 3), padding=(1, 1))
+    y = relay.nn.relu(y)
+    y = relay.nn.conv2d(y, w2, channels=8, kernel_size=(3, 3), padding=(1, 1))
+    y = relay.add(y, relay.expand_dims(b2, axis=1, num_newaxis=2))
+    y = relay.nn.relu(y)
+    y = relay.nn.max_pool2d(y, pool_size=(2, 2), strides=(2, 2))
+    func = relay.Function([data, w1, w2, b2], y)
+    params = {
+        "w1": tvm.nd.array(np.random.uniform(-1, 1, size=(8, dshape[1], 3, 3)).astype("float32")),
+        "w2": tvm.nd.array(np.random.uniform(-1, 1, size=(8, 8, 3, 3)).astype("float32")),
+        "b2": tvm.nd.array(np.random.uniform(-1, 1, size=(8,)).astype("float32")),
+    }
+    return func, params
+
+
+def count_calls(expr, op_name):
+    op = relay.op.get(op_name)
+    calls = []
+    def fvisit(e):
+        if isinstance(e, relay.Call) and e.op == op:
+            calls.append(e)
+    relay.ir_pass.post_order_visit(expr, fvisit)
+    return calls
+
+
+def test_annotate():
+    dshape = (1, 4, 8, 8)
+    func, params = make_graph(dshape)
+    func = relay.build_module._bind_params_by_name(func, params)
+    func = relay.ir_pass.fold_constant(func)
+    with qtz.qconfig(skip_k_conv=1):
+        annotated = qtz.annotate(func)
+    # the first conv2d is kept in float: input, weight of the
+    # second conv2d and the bias of the add are annotated.
+    calls = count_calls(annotated, "relay.op.annotation.simulated_quantize")
+    kinds = sorted(call.attrs.kind for call in calls)
+    assert kinds == [qtz.QAnnotateKind.INPUT,
+                     qtz.QAnnotateKind.WEIGHT,
+                     qtz.QAnnotateKind.WEIGHT]
+    with qtz.qconfig(skip_k_conv=0):
+        annotated = qtz.annotate(func)
+    calls = count_calls(annotated, "relay.op.annotation.simulated_quantize")
+    assert len(calls) == 5
+
+
+def test_quantize_realize():
+    dshape = (1, 4, 8, 8)
+    func, params = make_graph(dshape)
+    dataset = make_dataset(dshape, 4)
+    with qtz.qconfig(skip_k_conv=0):
+        qfunc = qtz.quantize(func, params, dataset)
+    qfunc = relay.ir_pass.infer_type(qfunc)
+    assert not count_calls(qfunc, "relay.op.annotation.simulated_quantize")
+    convs = count_calls(qfunc, "nn.conv2d")
+    assert len(convs) == 2
+    for conv in convs:
+        assert conv.args[0].checked_type.dtype == "int8"
+        assert conv.args[1].checked_type.dtype == "int8"
+        assert conv.checked_type.dtype == "int32"
+
+    # the quantized graph stays close to the float graph
+    ref_func = relay.build_module._bind_params_by_name(func, params)
+    x = dataset[0]["data"]
+    ex = relay.create_executor("debug")
+    ref_res = ex.evaluate(ref_func)(x).asnumpy()
+    q_res = ex.evaluate(qfunc)(x).asnumpy()
+    err = np.abs(q_res - ref_res).max()
+    assert err <= 0.1 * np.abs(ref_res).max(), err
+
+    # the integer graph compiles and matches the interpreter
+    with relay.build_config(opt_level=2):
+        graph, lib, _ = relay.build(qfunc, "llvm")
+    m = graph_runtime.create(graph, lib, tvm.cpu())
+    m.set_input("data", x)
+    m.run()
+    np.testing.assert_allclose(m.get_output(0).asnumpy(), q_res, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    test_annotate()
+    test_quantize_realize()
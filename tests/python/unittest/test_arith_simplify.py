@@ -100,7 +100,21 @@ def test_modular():
     assert tvm.ir_pass.CanonicalSimplify(z1 - (ry + y)).value == 0
     assert tvm.ir_pass.CanonicalSimplify(z2 - (rx + x)).value == 0
 
+def test_hash_cons():
+    ib = tvm.ir_builder.create()
+    n = tvm.var('n')
+    A = ib.pointer("int32", name="A")
+    with ib.for_range(0, 16, name="i") as i:
+        A[i] = A[i * 2 + n] - A[n + i * 2]
+    stmt = tvm.ir_pass.CanonicalSimplify(ib.get())
+    assert stmt.body.value.value == 0
+    # structurally equal sub-expressions are simplified to the same node
+    x = tvm.var('x')
+    z = csimplify(tvm.max((x * 4 + 2) / 2, (2 + x * 4) / 2))
+    assert z.a.same_as(z.b)
+
 if __name__ == "__main__":
+    test_hash_cons()
     test_simplify_div()
     test_simplify_mod()
     test_modular()
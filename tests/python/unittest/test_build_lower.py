@@ -1,4 +1,5 @@
 import tvm
+import numpy as np
 
 def test_lower_rfactor():
     n = tvm.var("n")
@@ -16,5 +17,57 @@ def test_lower_rfactor():
     s[BF].compute_at(s[B], s[B].op.reduce_axis[0])
     fapi = tvm.lower(s, [A, B])
 
+def test_lower_incremental():
+    n = 64
+    A = tvm.placeholder((n, n), name='A')
+    B = tvm.compute((n, n), lambda i, j: A[i, j] + 1, name='B')
+    C = tvm.compute((n, n), lambda i, j: B[i, j] * 2, name='C')
+
+    def make_schedule(factor):
+        s = tvm.create_schedule(C.op)
+        xo, xi = s[C].split(C.op.axis[1], factor=factor)
+        s[C].vectorize(xi)
+        return s
+
+    tvm.build_module.reset_lower_pass_profile(clear_cache=True)
+    funcs = []
+    with tvm.build_config(incremental_lower=True):
+        for factor in [4, 8, 4]:
+            funcs.append(tvm.lower(make_schedule(factor), [A, C]))
+    profile = tvm.build_module.lower_pass_profile()
+    num_calls, _, nest_hit, nest_miss = profile["CanonicalSimplify"]
+    assert num_calls == 3
+    # stage B is unchanged and the last schedule equals the first one.
+    assert nest_hit == 3
+    assert nest_miss == 3
+
+    if not tvm.module.enabled("llvm"):
+        return
+    a = tvm.nd.array(np.random.uniform(size=(n, n)).astype(A.dtype))
+    for func in funcs:
+        f = tvm.build(func, "llvm")
+        c = tvm.nd.array(np.zeros((n, n), dtype=C.dtype))
+        f(a, c)
+        np.testing.assert_allclose(c.asnumpy(), (a.asnumpy() + 1) * 2, rtol=1e-5)
+
+
+def test_lower_profile():
+    n = 64
+    A = tvm.placeholder((n,), name='A')
+    B = tvm.compute((n,), lambda i: A[i] + 1, name='B')
+    s = tvm.create_schedule(B.op)
+    tvm.build_module.reset_lower_pass_profile()
+    # the passes are timed with the default config.
+    tvm.lower(s, [A, B])
+    profile = tvm.build_module.lower_pass_profile()
+    for name in ["InferBound", "ScheduleOps", "StorageFlatten",
+                 "CanonicalSimplify", "Simplify"]:
+        num_calls, _, nest_hit, nest_miss = profile[name]
+        assert num_calls == 1
+        assert nest_hit == 0 and nest_miss == 0
+
+
 if __name__ == "__main__":
     test_lower_rfactor()
+    test_lower_incremental()
+    test_lower_profile()
@@ -82,6 +82,80 @@ def test_add_pipeline():
     with tvm.build_config(offset_factor=4):
         check_c()
 
+def test_parallel_vectorize():
+    nn = 1024
+    n = tvm.convert(nn)
+    A = tvm.placeholder((n,), name='A')
+    B = tvm.placeholder((n,), name='B')
+    C = tvm.compute(A.shape, lambda i: tvm.max(A[i] * 2.0, B[i]) + i.astype(A.dtype), name='C')
+    s = tvm.create_schedule(C.op)
+    xo, xi = s[C].split(C.op.axis[0], factor=4)
+    s[C].parallel(xo)
+    s[C].vectorize(xi)
+
+    def check_c():
+        f1 = tvm.lower(s, [A, B, C], name="fparallel")
+        fsplits = [x for x in tvm.ir_pass.SplitHostDevice(f1)]
+        fsplits[0] = tvm.ir_pass.LowerTVMBuiltin(fsplits[0])
+        mhost = tvm.codegen.build_module(fsplits[0], "c")
+        code = mhost.get_source()
+        assert "TVMBackendParallelLaunch" in code
+        assert "vector_size" in code
+        temp = util.tempdir()
+        path_dso = temp.relpath("temp.so")
+        mhost.export_library(path_dso)
+        m = tvm.module.load(path_dso)
+        fparallel = m['fparallel']
+        ctx = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=nn).astype(A.dtype), ctx)
+        b = tvm.nd.array(np.random.uniform(size=nn).astype(B.dtype), ctx)
+        c = tvm.nd.array(np.zeros(nn, dtype=C.dtype), ctx)
+        fparallel(a, b, c)
+        tvm.testing.assert_allclose(
+            c.asnumpy(),
+            np.maximum(a.asnumpy() * 2.0, b.asnumpy()) + np.arange(nn))
+    check_c()
+
+def test_vector_select():
+    def check_c(dtype):
+        n = 64
+        A = tvm.placeholder((n,), name='A', dtype=dtype)
+        B = tvm.placeholder((n,), name='B', dtype=dtype)
+        # the masks have the lanes of the compared and the selected values.
+        C = tvm.compute(A.shape, lambda i: tvm.select(A[i] > B[i], A[i], B[i] + 1), name='C')
+        D = tvm.compute(A.shape, lambda i: tvm.select(
+            A[i].astype("float32") > 0.5, A[i], B[i]), name='D')
+        s = tvm.create_schedule([C.op, D.op])
+        for T in (C, D):
+            _, xi = s[T].split(T.op.axis[0], factor=4)
+            s[T].vectorize(xi)
+        f1 = tvm.lower(s, [A, B, C, D], name="fselect")
+        fsplits = [x for x in tvm.ir_pass.SplitHostDevice(f1)]
+        fsplits[0] = tvm.ir_pass.LowerTVMBuiltin(fsplits[0])
+        mhost = tvm.codegen.build_module(fsplits[0], "c")
+        assert "__builtin_convertvector" in mhost.get_source()
+        temp = util.tempdir()
+        path_dso = temp.relpath("temp.so")
+        mhost.export_library(path_dso)
+        m = tvm.module.load(path_dso)
+        fselect = m['fselect']
+        ctx = tvm.cpu(0)
+        a_np = np.random.randint(0, 3, size=n).astype(dtype)
+        b_np = np.random.randint(0, 3, size=n).astype(dtype)
+        a = tvm.nd.array(a_np, ctx)
+        b = tvm.nd.array(b_np, ctx)
+        c = tvm.nd.array(np.zeros(n, dtype=dtype), ctx)
+        d = tvm.nd.array(np.zeros(n, dtype=dtype), ctx)
+        fselect(a, b, c, d)
+        tvm.testing.assert_allclose(
+            c.asnumpy(), np.where(a_np > b_np, a_np, b_np + 1))
+        tvm.testing.assert_allclose(
+            d.asnumpy(), np.where(a_np > 0.5, a_np, b_np))
+    check_c("int64")
+    check_c("int8")
+
 if __name__ == "__main__":
     test_add()
     test_add_pipeline()
+    test_parallel_vectorize()
+    test_vector_select()
@@ -307,6 +307,33 @@ def test_llvm_condition():
     check_llvm(64, 8)
 
 
+def test_llvm_vectorize_predicate():
+    def check_llvm(n, factor):
+        if not tvm.module.enabled("llvm"):
+            return
+        A = tvm.placeholder((n, ), name='A')
+        B = tvm.compute((n,), lambda i: A[i] + 1.0, name='B')
+        C = tvm.compute((n,), lambda i: tvm.if_then_else(i >= 3, B[i], 0.0), name='C')
+        s = tvm.create_schedule(C.op)
+        # the tail of the split is masked
+        _, xi = s[B].split(B.op.axis[0], factor=factor)
+        s[B].vectorize(xi)
+        _, xi = s[C].split(C.op.axis[0], factor=factor)
+        s[C].vectorize(xi)
+        # build and invoke the kernel.
+        f = tvm.build(s, [A, C], "llvm")
+        ctx = tvm.cpu(0)
+        # launch the kernel.
+        a = tvm.nd.array(np.random.uniform(size=(n,)).astype(A.dtype), ctx)
+        c = tvm.nd.empty((n,), A.dtype, ctx)
+        f(a, c)
+        c_np = a.asnumpy() + 1
+        c_np[:3] = 0
+        tvm.testing.assert_allclose(c.asnumpy(), c_np)
+    check_llvm(37, 8)
+    check_llvm(64, 16)
+
+
 def test_llvm_bool():
     def check_llvm(n):
         if not tvm.module.enabled("llvm"):
@@ -463,6 +490,7 @@ if __name__ == "__main__":
     test_llvm_bool()
     test_llvm_persist_parallel()
     test_llvm_condition()
+    test_llvm_vectorize_predicate()
     test_llvm_vadd_pipeline()
     test_llvm_add_pipeline()
     test_llvm_intrin()
@@ -74,6 +74,64 @@ def test_stack_vm_cond():
         np.testing.assert_equal(a.asnumpy(), y)
     run_jit(fapi, check)
 
+def test_stack_vm_logical():
+    dtype = 'int64'
+    n = tvm.var('n')
+    Ab = tvm.decl_buffer((n, ), dtype)
+
+    ib = tvm.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n, "i") as i:
+        with ib.if_scope(tvm.any(i < 2, i > 6)):
+            A[i] = 1
+        with ib.else_scope():
+            with ib.if_scope(tvm.all(i > 3, i < 5)):
+                A[i] = 2
+            with ib.else_scope():
+                A[i] = 3
+
+    stmt = ib.get()
+    fapi = tvm.ir_pass.MakeAPI(stmt, "test", [Ab], 0, True)
+    fapi = tvm.ir_pass.LowerTVMBuiltin(fapi)
+    def check(f):
+        a = tvm.nd.array(np.zeros(10, dtype=dtype))
+        f(a)
+        y = np.array([1, 1, 3, 3, 2, 3, 3, 1, 1, 1])
+        np.testing.assert_equal(a.asnumpy(), y)
+    run_jit(fapi, check)
+
+
+def test_stack_vm_nested_call():
+    dtype = 'int64'
+    n = tvm.var('n')
+    Ab = tvm.decl_buffer((n, ), dtype)
+    ib = tvm.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n, "i") as i:
+        A[i] = A[i] + 1
+    fapi = tvm.ir_pass.MakeAPI(ib.get(), "inner", [Ab], 0, True)
+    fapi = tvm.ir_pass.LowerTVMBuiltin(fapi)
+    finner = tvm.codegen.build_module(fapi, "stackvm")
+
+    @tvm.register_func("tvm_stack_vm_call_inner", override=True)
+    def call_inner(x):
+        finner(x)
+
+    Bb = tvm.decl_buffer((n, ), dtype)
+    ib = tvm.ir_builder.create()
+    B = ib.buffer_ptr(Bb)
+    with ib.for_range(0, n, "i") as i:
+        ib.emit(tvm.call_packed("tvm_stack_vm_call_inner", Bb))
+        B[i] = B[i] + 1
+    fapi = tvm.ir_pass.MakeAPI(ib.get(), "outer", [Bb], 0, True)
+    fapi = tvm.ir_pass.LowerTVMBuiltin(fapi)
+    def check(f):
+        b = tvm.nd.array(np.zeros(4, dtype=dtype))
+        f(b)
+        np.testing.assert_equal(b.asnumpy(), np.full(4, 5))
+    run_jit(fapi, check)
+
+
 def test_vm_parallel():
     dtype = 'int64'
     n = tvm.var('n')
@@ -98,3 +156,5 @@ if __name__ == "__main__":
     test_stack_vm_loop()
     test_stack_vm_basic()
     test_stack_vm_cond()
+    test_stack_vm_logical()
+    test_stack_vm_nested_call()
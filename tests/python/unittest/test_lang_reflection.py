@@ -1,4 +1,5 @@
 import tvm
+import numpy as np
 
 def test_const_saveload_json():
     # save load json
@@ -11,6 +12,44 @@ def test_const_saveload_json():
     assert tvm.save_json(zz) == tvm.save_json(z)
 
 
+def test_saveload_binary():
+    x = tvm.var("x")
+    y = tvm.const(1.5, "float32")
+    z = tvm.convert({"z": x * 2 - 1, "y": y, "t": tvm.cast("float32x4", y)})
+    blob = tvm.save_binary(z)
+    zz = tvm.load_binary(blob)
+    assert zz["z"].a.a.name == "x"
+    assert zz["z"].b.value == 1
+    assert zz["y"].value == 1.5
+    assert zz["t"].dtype == "float32x4"
+    # reduction with a combiner and shared nodes
+    A = tvm.placeholder((2, 10), name='A')
+    k = tvm.reduce_axis((0, 10), "k")
+    B = tvm.compute((2,), lambda i: tvm.sum(A[i, k], axis=k), name="B")
+    BB = tvm.load_binary(bytes(tvm.save_binary(B)))
+    assert BB.op.body[0].combiner is not None
+    assert tvm.save_json(BB) == tvm.save_json(B)
+
+
+def test_saveload_binary_ndarray():
+    from tvm import relay
+    data = np.random.uniform(size=(3, 17)).astype("float32")
+    c = relay.const(data)
+    shared = relay.Tuple([c, c, relay.const(np.arange(5).astype("int8"))])
+    blob = tvm.save_binary(shared)
+    loaded = tvm.load_binary(blob)
+    assert loaded.fields[0].same_as(loaded.fields[1])
+    np.testing.assert_equal(loaded.fields[0].data.asnumpy(), data)
+    np.testing.assert_equal(loaded.fields[2].data.asnumpy(), np.arange(5))
+    # raw payload is smaller than the base64 text
+    assert len(blob) < len(tvm.save_json(shared))
+    try:
+        tvm.load_binary(blob[:len(blob) - 1])
+        assert False
+    except tvm.TVMError:
+        pass
+
+
 def test_make_smap():
     # save load json
     x = tvm.const(1, "int32")
@@ -104,4 +143,6 @@ if __name__ == "__main__":
     test_make_node()
     test_make_smap()
     test_const_saveload_json()
+    test_saveload_binary()
+    test_saveload_binary_ndarray()
     test_make_sum()
@@ -0,0 +1,57 @@
+import tvm
+import numpy as np
+
+def collect_prefetch(stmt):
+    ret = []
+    def fvisit(x):
+        if isinstance(x, tvm.expr.Call) and x.name == "prefetch":
+            ret.append(x)
+    tvm.ir_pass.PostOrderVisit(stmt, fvisit)
+    return ret
+
+def test_inject_cpu_prefetch():
+    ib = tvm.ir_builder.create()
+    n = tvm.var("n")
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    C = ib.pointer("float32", name="C")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, 1024, name="j") as j:
+            C[i * 1024 + j] = A[i * 1024 + j] + B[j * 16]
+        with ib.for_range(0, 4, name="k") as k:
+            C[i * 1024 + k] = A[i * 1024 + k]
+    stmt = ib.get()
+    assert not collect_prefetch(tvm.ir_pass.InjectCPUPrefetch(stmt, 0))
+    stmt = tvm.ir_pass.InjectCPUPrefetch(stmt, 256)
+    # A is prefetched every 16 iterations, B in each iteration,
+    # the loop k touches less than a cache line.
+    prefetch = collect_prefetch(stmt)
+    assert len(prefetch) == 2
+    inner = stmt.body.first
+    assert inner.loop_var.name == "j"
+    assert isinstance(inner.body.first.first, tvm.stmt.IfThenElse)
+    assert isinstance(inner.body.first.rest, tvm.stmt.Evaluate)
+    assert isinstance(stmt.body.rest.body, tvm.stmt.Store)
+
+def test_cpu_prefetch_build():
+    n = 4096
+    A = tvm.placeholder((n,), name="A")
+    B = tvm.placeholder((n,), name="B")
+    C = tvm.compute((n,), lambda i: A[i] * B[i], name="C")
+    s = tvm.create_schedule(C.op)
+    with tvm.build_config(cpu_prefetch_distance=512):
+        stmt = tvm.lower(s, [A, B, C], simple_mode=True)
+        assert len(collect_prefetch(stmt)) == 2
+        if not tvm.module.enabled("llvm"):
+            return
+        f = tvm.build(s, [A, B, C], "llvm")
+    ctx = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), ctx)
+    b = tvm.nd.array(np.random.uniform(size=n).astype(B.dtype), ctx)
+    c = tvm.nd.array(np.zeros(n, dtype=C.dtype), ctx)
+    f(a, b, c)
+    tvm.testing.assert_allclose(c.asnumpy(), a.asnumpy() * b.asnumpy())
+
+if __name__ == "__main__":
+    test_inject_cpu_prefetch()
+    test_cpu_prefetch_build()
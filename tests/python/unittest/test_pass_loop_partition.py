@@ -328,6 +328,71 @@ def test_conv_tiling():
     stmt = tvm.ir_pass.Simplify(stmt)
     assert(not any(collect_visit(stmt, lambda x: isinstance(x, tvm.stmt.IfThenElse))))
 
+def test_multi_condition():
+    ib = tvm.ir_builder.create()
+    data = ib.pointer("float32", name="data")
+    out = ib.pointer("float32", name="out")
+    with ib.for_range(0, 16, 'oh') as oh:
+        with ib.for_range(0, 16, 'ow') as ow:
+            with ib.for_range(0, 3, 'kh') as kh:
+                with ib.for_range(0, 3, 'kw') as kw:
+                    h = oh + kh
+                    w = ow + kw
+                    with ib.if_scope(ib.likely(tvm.all(h >= 1, h < 17, w >= 1, w < 17))):
+                        out[oh * 16 + ow] += data[(h - 1) * 16 + w - 1]
+    stmt = ib.get()
+    stmt = tvm.ir_pass.LoopPartition(stmt, True)
+    stmt = tvm.ir_pass.Simplify(stmt)
+    # the main body of oh and ow is free of the bound checks
+    loops = [x for x in collect_visit(stmt, lambda x: x)
+             if isinstance(x, tvm.stmt.For) and x.loop_var.name == 'ow']
+    assert len(loops) > 1
+    assert any(not any(collect_visit(x, lambda y: isinstance(y, tvm.stmt.IfThenElse)))
+               for x in loops)
+
+def test_multi_nest_budget():
+    ib = tvm.ir_builder.create()
+    data = ib.pointer("float32", name="data")
+    out = ib.pointer("float32", name="out")
+    num_nests = 12
+    for i in range(num_nests):
+        with ib.for_range(0, 16, 'oh%d' % i) as oh:
+            with ib.for_range(0, 16, 'ow%d' % i) as ow:
+                with ib.for_range(0, 3, 'kh') as kh:
+                    with ib.for_range(0, 3, 'kw') as kw:
+                        h = oh + kh
+                        w = ow + kw
+                        with ib.if_scope(ib.likely(tvm.all(h >= 1, h < 17, w >= 1, w < 17))):
+                            out[i * 256 + oh * 16 + ow] += data[(h - 1) * 16 + w - 1]
+    stmt = ib.get()
+    stmt = tvm.ir_pass.LoopPartition(stmt, True)
+    stmt = tvm.ir_pass.Simplify(stmt)
+    # the code growth is bounded per nest, the last nests are partitioned too
+    for i in range(num_nests):
+        loops = [x for x in collect_visit(stmt, lambda x: x)
+                 if isinstance(x, tvm.stmt.For) and x.loop_var.name == 'ow%d' % i]
+        assert any(not any(collect_visit(x, lambda y: isinstance(y, tvm.stmt.IfThenElse)))
+                   for x in loops)
+
+def test_symbolic_pad():
+    import topi
+    n = tvm.var('n')
+    A = tvm.placeholder((n, 16), name='A')
+    B = topi.nn.pad(A, [1, 1], [1, 1])
+    # the border of a symbolic shape is not marked, it is not partitioned
+    assert "likely" not in str(B.op.body[0])
+    s = tvm.create_schedule(B.op)
+    stmt = lower(s, [A, B])
+    ifs = collect_visit(stmt, lambda x: isinstance(x, tvm.expr.Call) and
+                        x.name == "tvm_if_then_else")
+    loops = collect_visit(stmt, lambda x: isinstance(x, tvm.stmt.For))
+    assert any(ifs)
+    assert sum(loops) == 2
+    # the border of a constant shape is
+    A = tvm.placeholder((16, 16), name='A')
+    B = topi.nn.pad(A, [1, 1], [1, 1])
+    assert "likely" in str(B.op.body[0])
+
 if __name__ == "__main__":
     test_basic()
     test_const_loop()
@@ -345,3 +410,6 @@ if __name__ == "__main__":
     test_cce_loop_2()
     test_cce_loop_3()
     test_conv_tiling()
+    test_multi_condition()
+    test_multi_nest_budget()
+    test_symbolic_pad()
@@ -0,0 +1,63 @@
+import tvm
+import numpy as np
+
+def lower_builtin(s, args, name):
+    f = tvm.lower(s, args, name=name)
+    f = tvm.ir_pass.BindDeviceType(f, tvm.cpu(0).device_type)
+    return tvm.ir_pass.LowerTVMBuiltin(f)
+
+def collect(stmt):
+    calls = []
+    attrs = []
+    def fvisit(n):
+        if isinstance(n, tvm.expr.Call):
+            calls.append(n.name)
+        elif isinstance(n, tvm.stmt.AttrStmt):
+            attrs.append(n.attr_key)
+    tvm.ir_pass.PostOrderVisit(stmt, fvisit)
+    return calls, attrs
+
+def test_workspace_arena():
+    n, m = 8, 1024
+    A = tvm.placeholder((n, m), name='A')
+    B = tvm.compute((n, m), lambda i, j: A[i, j] + 1, name='B')
+    C = tvm.compute((n, m), lambda i, j: B[i, j] * 2, name='C')
+    D = tvm.compute((n, m), lambda i, j: B[i, j] + C[i, j], name='D')
+    s = tvm.create_schedule(D.op)
+    f = lower_builtin(s, [A, D], "arena")
+    calls, attrs = collect(f.body)
+    # both buffers live in a single workspace allocation
+    assert calls.count("TVMBackendAllocWorkspace") == 1
+    assert calls.count("TVMBackendFreeWorkspace") == 1
+    assert "pragma_parallel_launch_point" not in attrs
+
+def test_workspace_arena_parallel():
+    n, m = 8, 1024
+    A = tvm.placeholder((n, m), name='A')
+    B = tvm.compute((n, m), lambda i, j: A[i, j] + 1, name='B')
+    C = tvm.compute((n, m), lambda i, j: B[i, j] * 2, name='C')
+    D = tvm.compute((n, m), lambda i, j: B[i, j] + C[i, j], name='D')
+    s = tvm.create_schedule(D.op)
+    s[D].parallel(D.op.axis[0])
+    s[B].compute_at(s[D], D.op.axis[0])
+    s[C].compute_at(s[D], D.op.axis[0])
+    f = lower_builtin(s, [A, D], "arena")
+    calls, attrs = collect(f.body)
+    # the workspace is allocated once for each parallel task
+    assert calls.count("TVMBackendAllocWorkspace") == 1
+    assert "pragma_parallel_launch_point" in attrs
+
+    if not tvm.module.enabled("llvm"):
+        return
+    fbuild = tvm.build(s, [A, D], "llvm")
+    ctx = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=(n, m)).astype(A.dtype), ctx)
+    d = tvm.nd.empty((n, m), D.dtype, ctx)
+    fbuild(a, d)
+    b_np = a.asnumpy() + 1
+    tvm.testing.assert_allclose(d.asnumpy(), b_np * 3, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_workspace_arena()
+    test_workspace_arena_parallel()
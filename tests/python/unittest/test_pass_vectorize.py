@@ -1,4 +1,5 @@
 import tvm
+import numpy as np
 
 def test_vectorize_loop():
     dtype = 'int64'
@@ -51,7 +52,104 @@ def test_vectorize_with_if():
     assert isinstance(stmt.then_case.index, tvm.expr.Ramp)
     assert isinstance(stmt.then_case.value, tvm.expr.Add)
     assert stmt.then_case.value.dtype == "float32x4"
-    assert isinstance(stmt.else_case, tvm.stmt.For)
+    # the vector condition is turned into a predicate of the store
+    assert isinstance(stmt.else_case, tvm.stmt.Store)
+    assert isinstance(stmt.else_case.index, tvm.expr.Ramp)
+    assert stmt.else_case.predicate.dtype == "uint1x4"
+
+def test_vectorize_with_if_load():
+    n = tvm.var('n')
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, for_type="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = B[i] + 1
+        with ib.else_scope():
+            A[i] = 0.0
+    stmt = ib.get()
+    stmt = tvm.ir_pass.VectorizeLoop(stmt)
+    assert isinstance(stmt, tvm.stmt.Block)
+    then_case, else_case = stmt.first, stmt.rest
+    # both the load and the store of the branch are masked
+    assert then_case.value.a.predicate.dtype == "uint1x4"
+    assert then_case.predicate.dtype == "uint1x4"
+    assert isinstance(else_case.predicate, tvm.expr.Not)
+
+def test_vectorize_with_if_load_condition():
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, for_type="vectorize") as i:
+        with ib.if_scope(A[i] > 0):
+            A[i] = 0.0
+        with ib.else_scope():
+            A[i] = 1.0
+    stmt = ib.get()
+    stmt = tvm.ir_pass.VectorizeLoop(stmt)
+    # the condition is evaluated before the then branch writes A
+    assert isinstance(stmt, tvm.stmt.LetStmt)
+    assert isinstance(stmt.value.a, tvm.expr.Load)
+    then_case, else_case = stmt.body.first, stmt.body.rest
+    assert then_case.predicate.same_as(stmt.var)
+    assert else_case.predicate.a.same_as(stmt.var)
+
+    if not tvm.module.enabled("llvm"):
+        return
+    n = 8
+    Ab = tvm.decl_buffer((n,), "float32", name="A")
+    ib = tvm.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n // 4) as k:
+        with ib.for_range(0, 4, for_type="vectorize") as i:
+            with ib.if_scope(A[k * 4 + i] > 0):
+                A[k * 4 + i] = 0.0
+            with ib.else_scope():
+                A[k * 4 + i] = 1.0
+    stmt = tvm.ir_pass.VectorizeLoop(ib.get())
+    f = tvm.build(tvm.ir_pass.MakeAPI(stmt, "fif", [Ab], 0, True), target="llvm")
+    a_np = np.array([1, -1, 2, 0, -3, 4, 0, 5], dtype="float32")
+    a = tvm.nd.array(a_np)
+    f(a)
+    np.testing.assert_equal(a.asnumpy(), np.where(a_np > 0, 0, 1))
+
+def test_vectorize_with_if_scalarize():
+    n = tvm.var('n')
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("int32", name="A")
+    B = ib.pointer("int32", name="B")
+    with ib.for_range(0, 4, for_type="vectorize") as i:
+        # the division can trap on the masked lanes
+        with ib.if_scope(i < n):
+            A[i] = A[i] / B[i]
+    stmt = ib.get()
+    stmt = tvm.ir_pass.VectorizeLoop(stmt)
+    assert isinstance(stmt, tvm.stmt.For)
+
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    tx = tvm.thread_axis("threadIdx.x")
+    ib.scope_attr(tx, "thread_extent", 32)
+    with ib.for_range(0, 4, for_type="vectorize") as i:
+        # device kernels do not support masked accesses
+        with ib.if_scope(i < n):
+            A[i] = 1.0
+    stmt = ib.get()
+    stmt = tvm.ir_pass.VectorizeLoop(stmt)
+    assert isinstance(stmt.body, tvm.stmt.For)
+
+def test_vectorize_with_vector_extent():
+    ib = tvm.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, for_type="vectorize") as i:
+        with ib.for_range(0, i + 1) as j:
+            A[j * 4 + i] = 1.0
+    stmt = ib.get()
+    stmt = tvm.ir_pass.VectorizeLoop(stmt)
+    # the loop runs to the largest extent, with the finished lanes masked
+    assert isinstance(stmt, tvm.stmt.For)
+    assert tvm.ir_pass.Simplify(stmt.extent).value == 4
+    assert isinstance(stmt.body, tvm.stmt.Store)
+    assert stmt.body.predicate.dtype == "uint1x4"
 
 def test_vectorize_if_then_else():
     n = tvm.var('n')
@@ -64,7 +162,9 @@ def test_vectorize_if_then_else():
                                A[i] + 1, A[i])
     stmt = ib.get()
     stmt = tvm.ir_pass.VectorizeLoop(stmt)
-    assert isinstance(stmt, tvm.stmt.For)
+    assert isinstance(stmt, tvm.stmt.Store)
+    assert isinstance(stmt.value, tvm.expr.Select)
+    assert stmt.value.dtype == "float32x4"
 
 
     ib = tvm.ir_builder.create()
@@ -84,5 +184,9 @@ def test_vectorize_if_then_else():
 if __name__ == "__main__":
     test_vectorize_vector()
     test_vectorize_with_if()
+    test_vectorize_with_if_load()
+    test_vectorize_with_if_load_condition()
+    test_vectorize_with_if_scalarize()
+    test_vectorize_with_vector_extent()
     test_vectorize_loop()
     test_vectorize_if_then_else()
@@ -0,0 +1,82 @@
+import json
+import numpy as np
+import tvm
+from tvm.contrib import util
+from tvm.contrib.model_manager import ModelManager, graph_memory_bytes
+
+
+def get_graph(n):
+    node0 = {"op": "null", "name": "x", "inputs": []}
+    node1 = {"op": "tvm_op", "name": "add",
+             "inputs": [[0, 0, 0]],
+             "attrs": {"func_name": "myadd",
+                       "flatten_data": "1",
+                       "num_inputs" : "1",
+                       "num_outputs" : "1"}}
+    attrs = {
+        "shape" : ["list_shape", [(n,), (n,)]],
+        "dltype" : ["list_str", ["float32", "float32"]],
+        "storage_id" : ["list_int", [0, 1]],
+    }
+    graph = {"nodes": [node0, node1],
+             "arg_nodes": [0],
+             "node_row_ptr": [0, 1, 2],
+             "heads": [[1, 0, 0]],
+             "attrs": attrs}
+    return json.dumps(graph)
+
+
+def test_graph_memory_bytes():
+    assert graph_memory_bytes(get_graph(4)) == 32
+    assert graph_memory_bytes(get_graph(10)) == 80
+
+
+def test_model_manager():
+    if not tvm.module.enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    n = 4
+    A = tvm.placeholder((n,), name='A')
+    B = tvm.compute(A.shape, lambda *i: A(*i) + 1.0, name='B')
+    s = tvm.create_schedule(B.op)
+    mlib = tvm.build(s, [A, B], "llvm", name="myadd")
+    graph = get_graph(n)
+
+    a = np.random.uniform(size=(n,)).astype(A.dtype)
+    b = np.random.uniform(size=(n,)).astype(A.dtype)
+    temp = util.tempdir()
+    path_params = temp.relpath("b.params")
+    with open(path_params, "wb") as f:
+        f.write(tvm.get_global_func("_save_param_dict")("x", tvm.nd.array(b)))
+
+    # budget of one model
+    manager = ModelManager(budget_bytes=graph_memory_bytes(graph))
+    manager.add("a", graph, mlib, tvm.cpu(0), params={"x": tvm.nd.array(a)})
+    manager.add("b", graph, mlib, tvm.cpu(0), params=path_params)
+
+    def check(name, data):
+        mod = manager.get(name)
+        mod.run()
+        out = mod.get_output(0, tvm.nd.empty((n,)))
+        np.testing.assert_equal(out.asnumpy(), data + 1)
+
+    check("a", a)
+    check("a", a)
+    assert manager.is_resident("a")
+    check("b", b)
+    assert not manager.is_resident("a")
+    assert manager.memory_bytes() == graph_memory_bytes(graph)
+    check("a", a)
+    stats = manager.stats("a")
+    assert stats.loads == 2
+    assert stats.hits == 1
+    assert stats.evictions == 1
+    assert stats.last_load_ms > 0
+    assert manager.stats("b").evictions == 1
+    manager.remove("a")
+    assert manager.memory_bytes() == 0
+
+
+if __name__ == "__main__":
+    test_graph_memory_bytes()
+    test_model_manager()
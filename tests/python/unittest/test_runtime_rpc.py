@@ -68,6 +68,48 @@ def test_rpc_simple():
     f2 = client.get_function("rpc.test.strcat")
     assert f2("abc", 11) == "abc:11"
 
+def test_rpc_async():
+    if not tvm.module.enabled("rpc"):
+        return
+    @tvm.register_func("rpc.test.async_addone")
+    def addone(x):
+        return x + 1
+
+    @tvm.register_func("rpc.test.async_except")
+    def remotethrow(name):
+        raise ValueError("%s" % name)
+
+    server = rpc.Server("localhost", key="x1")
+    client = rpc.connect(server.host, server.port, key="x1")
+    fadd = client.get_async_function("rpc.test.async_addone")
+    fthrow = client.get_async_function("rpc.test.async_except")
+    # more calls than can be in flight at once
+    reqs = [fadd(i) for i in range(100)]
+    req_except = fthrow("abc")
+    req_last = fadd(100)
+    # returns can be waited out of order
+    assert client.wait(reqs[50]) == 51
+    assert client.wait(req_last) == 101
+    try:
+        client.wait(req_except)
+        assert False
+    except tvm.TVMError as e:
+        assert "abc" in str(e)
+    for i, req in enumerate(reqs):
+        if i != 50:
+            assert client.wait(req) == i + 1
+    # synchronous calls still work with calls in flight
+    req = fadd(1)
+    f1 = client.get_function("rpc.test.async_addone")
+    assert f1(10) == 11
+    assert client.wait(req) == 2
+    # async upload
+    blob = bytearray(np.random.randint(0, 10, size=(10)))
+    fupload = client.get_async_function("tvm.rpc.server.upload")
+    client.wait(fupload("dat.bin", blob))
+    assert client.download("dat.bin") == blob
+
+
 def test_rpc_array():
     if not tvm.module.enabled("rpc"):
         return
@@ -323,6 +365,7 @@ if __name__ == "__main__":
     test_rpc_file_exchange()
     test_rpc_array()
     test_rpc_simple()
+    test_rpc_async()
     test_local_func()
     test_rpc_tracker_register()
     test_rpc_tracker_request()
@@ -259,8 +259,32 @@ def test_gemm_bound():
     assert(bounds[CC.op.axis[0]].extent.value == 8)
     assert(bounds[CC.op.axis[1]].extent.value == 8)
 
+def test_bound_fused_chain():
+    n = 64
+    depth = 6
+    def shift_add(prev):
+        return lambda i: prev[i] + prev[i + 1]
+    stages = [tvm.placeholder((n + depth,), name='A')]
+    for k in range(depth):
+        stages.append(tvm.compute((n + depth - k - 1,), shift_add(stages[-1]), name='B%d' % k))
+    C = stages[-1]
+    s = tvm.create_schedule(C.op)
+    xo, xi = s[C].split(C.op.axis[0], factor=4)
+    for t in stages[1:-1]:
+        s[t].compute_at(s[C], xo)
+    s = s.normalize()
+    bounds = tvm.schedule.InferBound(s)
+    for k, t in enumerate(stages[1:-1]):
+        assert(bounds[t.op.axis[0]].extent.value == 4 + depth - 1 - k)
+    # results are the same when the sets are evaluated again
+    bounds2 = tvm.schedule.InferBound(s)
+    for t in stages[1:]:
+        assert tvm.ir_pass.Equal(bounds[t.op.axis[0]].extent,
+                                 bounds2[t.op.axis[0]].extent)
+
 
 if __name__ == "__main__":
+    test_bound_fused_chain()
     test_bound_nest_thread()
     test_bound1()
     test_bound_nest_group()
@@ -175,6 +175,13 @@ inline tvm::Tensor pad(const tvm::Tensor& t,
   if (!pad_value.defined()) {
     pad_value = tvm::make_const(t->dtype, 0);
   }
+  // Loops of symbolic extent are always partitioned, so only the border of
+  // constant shapes is marked for LoopPartition.
+  bool const_shape = true;
+  for (size_t i = 0; i < pad_before.size(); ++i) {
+    const_shape = const_shape && topi::detail::IsConstInt(t->shape[i]) &&
+        topi::detail::IsConstInt(pad_before[i]) && topi::detail::IsConstInt(pad_after[i]);
+  }
 
   auto l = [&](tvm::Array<tvm::Var> ovars) {
     tvm::Array<tvm::Expr> indices;
@@ -195,8 +202,10 @@ inline tvm::Tensor pad(const tvm::Tensor& t,
       }
     }
     if (sel.size() != 0) {
-      return tvm::if_then_else(
-          detail::Map(sel, tvm::ir::And::make), t(indices), pad_value);
+      Expr cond = detail::Map(sel, tvm::ir::And::make);
+      // likely lets LoopPartition split the border off the loops
+      if (const_shape) cond = tvm::likely(cond);
+      return tvm::if_then_else(cond, t(indices), pad_value);
     }
     return t(indices);
   };
@@ -81,9 +81,11 @@ inline Tensor softmax(const Tensor &x,
   auto expsum = tvm::compute(reduced_shape, [&](const Array<Var> &indices) {
       return _compute_expsum(max_elem, indices);
   });
+  Map<std::string, NodeRef> attrs;
+  attrs.Set("axis", Integer(axis));
   return tvm::compute(input_shape, [&](const Array<Var> &indices) {
       return _normalize(max_elem, expsum, indices);
-  }, name, tag);
+  }, name, tag, attrs);
 }
 
 /*!
@@ -113,10 +115,12 @@ inline Tensor log_softmax(const Tensor& x,
     { m }, [&](Var i) {
       return tvm::sum(tvm::exp(x(i, k) - max_elem(i)), { k }); });
 
+  Map<std::string, NodeRef> attrs;
+  attrs.Set("axis", Integer(1));
   return tvm::compute(
     x->shape, [&](Var i, Var j) {
       return x(i, j) - max_elem(i) - tvm::log(expsum(i));
-    }, name, tag);
+    }, name, tag, attrs);
 }
 
 }  // namespace nn
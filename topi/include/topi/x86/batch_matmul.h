@@ -0,0 +1,103 @@
+/*!
+*  Copyright (c) 2018 by Contributors
+* \file x86/batch_matmul.h
+* \brief x86 schedule for batch_matmul
+*/
+#ifndef TOPI_X86_BATCH_MATMUL_H_
+#define TOPI_X86_BATCH_MATMUL_H_
+
+#include "topi/tags.h"
+#include "topi/detail/array_utils.h"
+#include "topi/detail/constant_utils.h"
+#include "topi/detail/fuse.h"
+#include "topi/x86/util.h"
+#include "tvm/tvm.h"
+#include "tvm/build_module.h"
+
+namespace topi {
+using namespace tvm;
+
+namespace x86 {
+/*!
+* \brief Create an x86 schedule for batch_matmul.
+* Both operands are contiguous along the reduction axis, so the reduction is
+* factored into vector lanes that are summed once per output element. Each
+* parallel task computes a tile of the output of one batch.
+*
+* \param target The target to generate a schedule for.
+* \param outs The output tensors.
+*
+* \return A schedule for the given ops.
+*/
+inline Schedule schedule_batch_matmul(const Target &target, const Array<Tensor>& outs) {
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  auto s = create_schedule(out_ops);
+
+  auto _schedule = [&](const Tensor& C) {
+    int M = static_cast<int>(detail::GetConstInt(C->shape[1]));
+    int N = static_cast<int>(detail::GetConstInt(C->shape[2]));
+    auto x = C->op->InputTensors()[0];
+    int K = static_cast<int>(detail::GetConstInt(x->shape[2]));
+    int vec = LargestDivisor(K, GetFP32Len(target));
+    int y_bn = 8;
+    while (M % y_bn != 0) y_bn /= 2;
+    int x_bn = 8;
+    while (N % x_bn != 0) x_bn /= 2;
+
+    Tensor CC;
+    if (vec > 1) {
+      IterVar ko, ki;
+      s[C].split(s[C]->op.as<ComputeOpNode>()->reduce_axis[0], vec, &ko, &ki);
+      // place the lanes last, so the partial sums are stored contiguously.
+      CC = s.rfactor(C, ki, 3)[0];
+    }
+
+    auto axis = s[C]->op.as<ComputeOpNode>()->axis;
+    IterVar yo, yi, xo, xi;
+    s[C].split(axis[1], y_bn, &yo, &yi);
+    s[C].split(axis[2], x_bn, &xo, &xi);
+    s[C].reorder({ axis[0], yo, xo, yi, xi });
+    auto bxyo = detail::Fuse(s[C], { axis[0], yo, xo });
+    s[C].parallel(bxyo);
+    s[C].pragma(bxyo, "auto_unroll_max_step", 16);
+
+    if (CC.defined()) {
+      s[CC].compute_at(s[C], bxyo);
+      auto cc_op = s[CC]->op.as<ComputeOpNode>();
+      auto yx = detail::Fuse(s[CC], { cc_op->axis[1], cc_op->axis[2] });
+      s[CC].reorder({ yx, cc_op->reduce_axis[0], cc_op->axis[3] });
+      s[CC].vectorize(cc_op->axis[3]);
+    } else {
+      s[C].vectorize(xi);
+    }
+  };
+
+  std::function<void(Operation)> traverse;
+  traverse = [&](const Operation& op) {
+    // Inline all one-to-one-mapping operators except the last stage (output)
+    if (is_broadcast(op->tag)) {
+      if (!detail::contains(s->outputs, op)) {
+        s[op].compute_inline();
+      }
+      for (auto tensor : op->InputTensors()) {
+        if (tensor->op->InputTensors().size() > 0) {
+          traverse(tensor->op);
+        }
+      }
+    } else if (op->tag == kBatchMatMul) {
+      _schedule(op.output(0));
+    } else {
+      LOG(ERROR) << "Unsupported operator " << op->tag;
+    }
+  };
+
+  traverse(outs[0]->op);
+  return s;
+}
+
+}  // namespace x86
+}  // namespace topi
+#endif  // TOPI_X86_BATCH_MATMUL_H_
@@ -0,0 +1,230 @@
+/*!
+*  Copyright (c) 2018 by Contributors
+* \file x86/conv2d.h
+* \brief x86 conv2d in the NCHW[x]c layout with packed weights
+*/
+#ifndef TOPI_X86_CONV2D_H_
+#define TOPI_X86_CONV2D_H_
+
+#include <string>
+
+#include "topi/tags.h"
+#include "topi/nn.h"
+#include "topi/detail/array_utils.h"
+#include "topi/detail/constant_utils.h"
+#include "topi/detail/fuse.h"
+#include "topi/x86/util.h"
+#include "tvm/tvm.h"
+#include "tvm/build_module.h"
+
+namespace topi {
+using namespace tvm;
+
+namespace x86 {
+/*!
+* \brief Pack NCHW data into the NCHW[x]c layout.
+*
+* \param data The 4-D input tensor
+* \param ic_bn The block size of the channels
+* \param name The name of the operation
+* \param tag The tag to mark the operation
+*
+* \return A 5-D tensor with shape [batch, channel / ic_bn, height, width, ic_bn]
+*/
+inline Tensor pack_data_NCHWc(const Tensor& data,
+                              int ic_bn,
+                              std::string name = "data_vec",
+                              std::string tag = kInjective) {
+  CHECK_EQ(data->shape.size(), 4) << "pack_data_NCHWc requires 4-D data";
+  Array<Expr> oshape{data->shape[0], data->shape[1] / ic_bn,
+                     data->shape[2], data->shape[3], ic_bn};
+  return compute(oshape, [&](const Array<Var>& i) {
+      return data(i[0], i[1] * ic_bn + i[4], i[2], i[3]);
+    }, name, tag);
+}
+
+/*!
+* \brief Pack OIHW weights into the OIHW[x]i[x]o layout.
+*
+* \param kernel The 4-D weight tensor
+* \param ic_bn The block size of the input channels
+* \param oc_bn The block size of the output channels
+* \param name The name of the operation
+* \param tag The tag to mark the operation
+*
+* \return A 6-D tensor with shape
+*  [out_channel / oc_bn, in_channel / ic_bn, kernel_h, kernel_w, ic_bn, oc_bn]
+*/
+inline Tensor pack_kernel_NCHWc(const Tensor& kernel,
+                                int ic_bn,
+                                int oc_bn,
+                                std::string name = "kernel_vec",
+                                std::string tag = kInjective) {
+  CHECK_EQ(kernel->shape.size(), 4) << "pack_kernel_NCHWc requires 4-D kernel";
+  Array<Expr> oshape{kernel->shape[0] / oc_bn, kernel->shape[1] / ic_bn,
+                     kernel->shape[2], kernel->shape[3], ic_bn, oc_bn};
+  return compute(oshape, [&](const Array<Var>& i) {
+      return kernel(i[0] * oc_bn + i[5], i[1] * ic_bn + i[4], i[2], i[3]);
+    }, name, tag);
+}
+
+/*!
+* \brief Creates an operation that performs a 2-D convolution in the
+* NCHW[x]c layout, with weights packed in the OIHW[x]i[x]o layout.
+*
+* \param data The 5-D input tensor [batch, in_channel / ic_bn, height, width, ic_bn]
+* \param kernel The 6-D weight tensor
+*  [out_channel / oc_bn, in_channel / ic_bn, kernel_h, kernel_w, ic_bn, oc_bn]
+* \param stride_h A static constant striding amount applied to the height
+* \param stride_w A static constant striding amount applied to the width
+* \param pad_h A static constant symmetric padding applied to the height
+* \param pad_w A static constant symmetric padding applied to the width
+* \param out_dtype The output data type
+* \param name The name of the operation
+* \param tag The tag to mark the operation
+*
+* \return A 5-D tensor [batch, out_channel / oc_bn, out_height, out_width, oc_bn]
+*/
+inline Tensor conv2d_NCHWc(const Tensor& data,
+                           const Tensor& kernel,
+                           int stride_h,
+                           int stride_w,
+                           int pad_h,
+                           int pad_w,
+                           Type out_dtype,
+                           std::string name = "conv2d_NCHWc",
+                           std::string tag = kConv2dNCHWc) {
+  CHECK_EQ(data->shape.size(), 5) << "conv2d_NCHWc requires 5-D data";
+  CHECK_EQ(kernel->shape.size(), 6) << "conv2d_NCHWc requires 6-D kernel";
+  auto ic_bn = data->shape[4];
+  auto kernel_h = kernel->shape[2];
+  auto kernel_w = kernel->shape[3];
+  Array<Expr> oshape{
+      data->shape[0],
+      kernel->shape[0],
+      (data->shape[2] + 2 * pad_h - kernel_h) / stride_h + 1,
+      (data->shape[3] + 2 * pad_w - kernel_w) / stride_w + 1,
+      kernel->shape[5]};
+  auto data_pad = (pad_h == 0 && pad_w == 0)
+      ? data
+      : pad(data, {Expr(0), Expr(0), pad_h, pad_w, Expr(0)}, Array<Expr>(), Expr(), "data_pad");
+
+  auto ic = reduce_axis(Range(0, data->shape[1] * ic_bn), "ic");
+  auto kh = reduce_axis(Range(0, kernel_h), "kh");
+  auto kw = reduce_axis(Range(0, kernel_w), "kw");
+  return compute(oshape, [&](const Array<Var>& i) {
+      return sum(
+          cast(out_dtype, data_pad(i[0], ic / ic_bn, i[2] * stride_h + kh,
+                                   i[3] * stride_w + kw, ic % ic_bn)) *
+          cast(out_dtype, kernel(i[1], ic / ic_bn, kh, kw, ic % ic_bn, i[4])),
+          {ic, kh, kw});
+    }, name, tag);
+}
+
+/*!
+* \brief Create an x86 schedule for conv2d in the NCHW[x]c layout.
+*  The output channel block is vectorized and a row of reg_n outputs
+*  is accumulated in registers, with the block sizes chosen from the
+*  vector width of the target (AVX2 or AVX-512).
+*
+* \param target The target to generate a schedule for.
+* \param outs The output tensors.
+*
+* \return A schedule for the given ops.
+*/
+inline Schedule schedule_conv2d_NCHWc(const Target &target, const Array<Tensor>& outs) {
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  auto s = create_schedule(out_ops);
+
+  auto _schedule = [&](const Tensor& conv_out) {
+    auto data = conv_out->op->InputTensors()[0];
+    auto kernel = conv_out->op->InputTensors()[1];
+    if (data->op->name == "data_pad") {
+      s[data].compute_inline();
+      data = data->op->InputTensors()[0];
+    }
+    int ic_bn = static_cast<int>(detail::GetConstInt(data->shape[4]));
+    int reg_n = LargestDivisor(detail::GetConstInt(conv_out->shape[3]), 31);
+
+    // packing of the data and kernel in the same graph.
+    if (data->op.as<ComputeOpNode>()) {
+      auto axis = s[data]->op.as<ComputeOpNode>()->axis;
+      s[data].parallel(detail::Fuse(s[data], { axis[1], axis[2] }));
+    }
+    if (kernel->op.as<ComputeOpNode>()) {
+      auto axis = s[kernel]->op.as<ComputeOpNode>()->axis;
+      s[kernel].reorder({ axis[0], axis[2], axis[1], axis[3], axis[4], axis[5] });
+      s[kernel].vectorize(axis[5]);
+      s[kernel].parallel(detail::Fuse(s[kernel], { axis[0], axis[2] }));
+    }
+
+    auto C = conv_out;
+    auto O = outs[0];
+    auto CC = s.cache_write(C, "global");
+
+    auto c_axis = s[C]->op.as<ComputeOpNode>()->axis;
+    IterVar ow_chunk, ow_block;
+    s[C].split(c_axis[3], reg_n, &ow_chunk, &ow_block);
+    s[C].reorder({ c_axis[1], c_axis[2], ow_chunk, ow_block, c_axis[4] });
+    auto c_fused = detail::Fuse(s[C], { c_axis[1], c_axis[2] });
+    s[C].vectorize(c_axis[4]);
+    if (C->op.same_as(O->op)) {
+      s[C].parallel(c_fused);
+    }
+
+    s[CC].compute_at(s[C], ow_chunk);
+    auto cc_op = s[CC]->op.as<ComputeOpNode>();
+    auto cc_axis = cc_op->axis;
+    auto ic = cc_op->reduce_axis[0];
+    auto kh = cc_op->reduce_axis[1];
+    auto kw = cc_op->reduce_axis[2];
+    IterVar cc_ow_chunk, cc_ow_block, ic_chunk, ic_block;
+    s[CC].split(cc_axis[3], reg_n, &cc_ow_chunk, &cc_ow_block);
+    s[CC].split(ic, ic_bn, &ic_chunk, &ic_block);
+    s[CC].reorder({ cc_axis[1], cc_axis[2], cc_ow_chunk, ic_chunk, kh, kw,
+                    ic_block, cc_ow_block, cc_axis[4] });
+    s[CC].vectorize(cc_axis[4]);
+    s[CC].unroll(cc_ow_block);
+
+    if (!C->op.same_as(O->op)) {
+      auto o_axis = s[O]->op.as<ComputeOpNode>()->axis;
+      CHECK_EQ(o_axis.size(), 5) << "conv2d_NCHWc output must stay in the NCHW[x]c layout";
+      IterVar o_ow_chunk, o_ow_block;
+      s[O].split(o_axis[3], reg_n, &o_ow_chunk, &o_ow_block);
+      s[O].reorder({ o_axis[1], o_axis[2], o_ow_chunk, o_ow_block, o_axis[4] });
+      auto o_fused = detail::Fuse(s[O], { o_axis[1], o_axis[2] });
+      s[C].compute_at(s[O], o_fused);
+      s[O].vectorize(o_axis[4]);
+      s[O].parallel(o_fused);
+    }
+  };
+
+  std::function<void(Operation)> traverse;
+  traverse = [&](const Operation& op) {
+    // Inline all one-to-one-mapping operators except the last stage (output)
+    if (is_broadcast(op->tag)) {
+      if (!detail::contains(s->outputs, op)) {
+        s[op].compute_inline();
+      }
+      for (auto tensor : op->InputTensors()) {
+        if (tensor->op->InputTensors().size() > 0) {
+          traverse(tensor->op);
+        }
+      }
+    } else if (op->tag == kConv2dNCHWc) {
+      _schedule(op.output(0));
+    } else {
+      LOG(ERROR) << "Unsupported operator " << op->tag;
+    }
+  };
+
+  traverse(outs[0]->op);
+  return s;
+}
+
+}  // namespace x86
+}  // namespace topi
+#endif  // TOPI_X86_CONV2D_H_
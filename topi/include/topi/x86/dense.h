@@ -0,0 +1,252 @@
+/*!
+*  Copyright (c) 2018 by Contributors
+* \file x86/dense.h
+* \brief x86 dense with blocked weights
+*/
+#ifndef TOPI_X86_DENSE_H_
+#define TOPI_X86_DENSE_H_
+
+#include "topi/tags.h"
+#include "topi/nn/dense.h"
+#include "topi/detail/array_utils.h"
+#include "topi/detail/constant_utils.h"
+#include "topi/detail/fuse.h"
+#include "topi/x86/util.h"
+#include "tvm/tvm.h"
+#include "tvm/build_module.h"
+
+namespace topi {
+using namespace tvm;
+
+namespace x86 {
+/*!
+* \brief Dense that packs the weight into [out_dim / bn, in_dim, bn] blocks,
+* so the inner loop over the output reads the weight contiguously.
+*
+* \param target The target device
+* \param data Tensor with shape [batch, in_dim]
+* \param weight Tensor with shape [out_dim, in_dim]
+* \param bias Tensor with shape [out_dim]. Optional; to omit bias, pass Tensor()
+*
+* \return Tensor with shape [batch, out_dim]
+*/
+inline tvm::Tensor dense_pack(const Target& target,
+                              const tvm::Tensor& data,
+                              const tvm::Tensor& weight,
+                              const tvm::Tensor& bias) {
+  auto batch = data->shape[0];
+  auto in_dim = data->shape[1];
+  auto out_dim = weight->shape[0];
+  int bn = LargestDivisor(detail::GetConstInt(out_dim), GetFP32Len(target) * 2);
+
+  auto packw = tvm::compute(
+    { out_dim / bn, in_dim, bn },
+    [&](Var z, Var y, Var x) {
+      return weight(z * bn + x, y);
+    }, "packed_weight", kInjective);
+
+  auto k = tvm::reduce_axis(Range(0, in_dim), "k");
+  auto matmul = tvm::compute(
+    { batch, out_dim },
+    [&](Var y, Var x) {
+      return tvm::sum(data(y, k) * packw(x / bn, k, x % bn), { k });
+    }, "tensor", "dense_pack");
+
+  if (bias.defined()) {
+    matmul = tvm::compute(
+      { batch, out_dim },
+      [&](Var i, Var j) {
+        return matmul(i, j) + bias(j);
+      }, "tensor", kBroadcast);
+  }
+  return matmul;
+}
+
+/*!
+* \brief Dense that splits the reduction into vector lanes and
+* sums the lanes at the end, without packing the weight.
+*
+* \param target The target device
+* \param data Tensor with shape [batch, in_dim]
+* \param weight Tensor with shape [out_dim, in_dim]
+* \param bias Tensor with shape [out_dim]. Optional; to omit bias, pass Tensor()
+*
+* \return Tensor with shape [batch, out_dim]
+*/
+inline tvm::Tensor dense_nopack(const Target& target,
+                                const tvm::Tensor& data,
+                                const tvm::Tensor& weight,
+                                const tvm::Tensor& bias) {
+  auto batch = data->shape[0];
+  auto in_dim = data->shape[1];
+  auto out_dim = weight->shape[0];
+  int vec = LargestDivisor(detail::GetConstInt(in_dim), GetFP32Len(target) * 2);
+
+  auto k = tvm::reduce_axis(Range(0, in_dim / vec), "k");
+  auto partial = tvm::compute(
+    { batch, out_dim, vec },
+    [&](Var z, Var y, Var x) {
+      return tvm::sum(data(z, k * vec + x) * weight(y, k * vec + x), { k });
+    }, "dense_partial", "dense_partial");
+
+  auto kk = tvm::reduce_axis(Range(0, vec), "kk");
+  auto matmul = tvm::compute(
+    { batch, out_dim },
+    [&](Var y, Var x) {
+      return tvm::sum(partial(y, x, kk), { kk });
+    }, "tensor", "dense_nopack");
+
+  if (bias.defined()) {
+    matmul = tvm::compute(
+      { batch, out_dim },
+      [&](Var i, Var j) {
+        return matmul(i, j) + bias(j);
+      }, "tensor", kBroadcast);
+  }
+  return matmul;
+}
+
+/*!
+* \brief Implementation of dense for x86 backend. Small batches do not
+* pack the weight, because there is little reuse to pay for the packing.
+*
+* \param target The target device
+* \param data Tensor with shape [batch, in_dim]
+* \param weight Tensor with shape [out_dim, in_dim]
+* \param bias Tensor with shape [out_dim]. Optional; to omit bias, pass Tensor()
+*
+* \return Tensor with shape [batch, out_dim]
+*/
+inline tvm::Tensor dense_x86(const Target& target,
+                             const tvm::Tensor& data,
+                             const tvm::Tensor& weight,
+                             const tvm::Tensor& bias) {
+  CHECK_EQ(data->shape.size(), 2) << "dense requires 2-D data";
+  CHECK_EQ(weight->shape.size(), 2) << "dense requires 2-D weight";
+  if (bias.defined()) {
+    CHECK_EQ(bias->shape.size(), 1) << "dense requires 1-D bias";
+  }
+  if (!detail::IsConstInt(data->shape[0]) ||
+      !detail::IsConstInt(data->shape[1]) ||
+      !detail::IsConstInt(weight->shape[0])) {
+    return topi::nn::dense(data, weight, bias);
+  }
+  if (detail::GetConstInt(data->shape[0]) <= 16) {
+    return dense_nopack(target, data, weight, bias);
+  }
+  return dense_pack(target, data, weight, bias);
+}
+
+/*!
+* \brief Create an x86 schedule for dense
+*
+* \param target The target to generate a schedule for.
+* \param outs The output tensors.
+*
+* \return A schedule for the given ops.
+*/
+inline Schedule schedule_dense(const Target &target, const Array<Tensor>& outs) {
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  auto s = create_schedule(out_ops);
+
+  // The output O is tiled and C is computed under its tiles. When O is an
+  // epilogue of C, such as the bias add, C itself is the accumulator,
+  // otherwise C is accumulated in a cache.
+  auto _schedule_pack = [&](const Tensor& C, const Tensor& O) {
+    auto packw = C->op->InputTensors()[1];
+    int M = static_cast<int>(detail::GetConstInt(C->shape[0]));
+    int N = static_cast<int>(detail::GetConstInt(C->shape[1]));
+    int x_ii = static_cast<int>(detail::GetConstInt(packw->shape[2]));
+    int y_ii = 8;
+    while (M % y_ii != 0) y_ii /= 2;
+    // keep at most 4 outer tiles of each axis as parallel tasks.
+    auto outer_factor = [](int n) {
+      int oi = 1;
+      while (n / oi > 4 && (n / oi) % 2 == 0) oi *= 2;
+      return oi;
+    };
+    int y_oi = outer_factor(M / y_ii);
+    int x_oi = outer_factor(N / x_ii);
+
+    Tensor CC = C;
+    if (O->op.same_as(C->op)) {
+      CC = s.cache_write(C, "global");
+    }
+    auto axis = s[O]->op.as<ComputeOpNode>()->axis;
+    IterVar yt, yo, yi, xt, xo, xi, y_outer, x_outer;
+    s[O].split(axis[0], y_ii, &y_outer, &yi);
+    s[O].split(y_outer, y_oi, &yt, &yo);
+    s[O].split(axis[1], x_ii, &x_outer, &xi);
+    s[O].split(x_outer, x_oi, &xt, &xo);
+    s[O].reorder({ yt, xt, yo, xo, yi, xi });
+    s[O].parallel(detail::Fuse(s[O], { yt, xt }));
+    auto xyo = detail::Fuse(s[O], { yo, xo });
+    s[O].unroll(yi);
+    s[O].vectorize(xi);
+
+    s[CC].compute_at(s[O], xyo);
+    auto cc_op = s[CC]->op.as<ComputeOpNode>();
+    s[CC].reorder({ cc_op->reduce_axis[0], cc_op->axis[0], cc_op->axis[1] });
+    s[CC].vectorize(cc_op->axis[1]);
+    s[CC].unroll(cc_op->axis[0]);
+
+    auto w_axis = s[packw]->op.as<ComputeOpNode>()->axis;
+    s[packw].reorder({ w_axis[0], w_axis[2], w_axis[1] });
+    s[packw].parallel(w_axis[0]);
+    s[packw].vectorize(w_axis[1]);
+  };
+
+  auto _schedule_nopack = [&](const Tensor& C, const Tensor& O) {
+    // the partial sums of all the rows are computed for each output column.
+    auto axis = s[O]->op.as<ComputeOpNode>()->axis;
+    IterVar yo, yi, xo, xi;
+    s[O].split(axis[0], O->shape[0], &yo, &yi);
+    s[O].split(axis[1], 1, &xo, &xi);
+    s[O].reorder({ yo, xo, yi, xi });
+    auto xyo = detail::Fuse(s[O], { yo, xo });
+    s[O].parallel(xyo);
+    if (!O->op.same_as(C->op)) {
+      s[C].compute_at(s[O], xyo);
+    }
+    s[C].unroll(s[C]->op.as<ComputeOpNode>()->reduce_axis[0]);
+
+    auto partial = C->op->InputTensors()[0];
+    s[partial].compute_at(s[O], xyo);
+    auto p_op = s[partial]->op.as<ComputeOpNode>();
+    auto yz = detail::Fuse(s[partial], { p_op->axis[0], p_op->axis[1] });
+    s[partial].reorder({ p_op->reduce_axis[0], yz, p_op->axis[2] });
+    s[partial].unroll(yz);
+    s[partial].vectorize(p_op->axis[2]);
+  };
+
+  std::function<void(Operation)> traverse;
+  traverse = [&](const Operation& op) {
+    // Inline all one-to-one-mapping operators except the last stage (output)
+    if (is_broadcast(op->tag)) {
+      if (!detail::contains(s->outputs, op)) {
+        s[op].compute_inline();
+      }
+      for (auto tensor : op->InputTensors()) {
+        if (tensor->op->InputTensors().size() > 0) {
+          traverse(tensor->op);
+        }
+      }
+    } else if (op->tag == "dense_pack") {
+      _schedule_pack(op.output(0), outs[0]);
+    } else if (op->tag == "dense_nopack") {
+      _schedule_nopack(op.output(0), outs[0]);
+    } else if (op->tag != "dense") {
+      LOG(ERROR) << "Unsupported operator " << op->tag;
+    }
+  };
+
+  traverse(outs[0]->op);
+  return s;
+}
+
+}  // namespace x86
+}  // namespace topi
+#endif  // TOPI_X86_DENSE_H_
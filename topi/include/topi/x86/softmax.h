@@ -0,0 +1,124 @@
+/*!
+*  Copyright (c) 2018 by Contributors
+* \file x86/softmax.h
+* \brief x86 schedule for softmax operations
+*/
+#ifndef TOPI_X86_SOFTMAX_H_
+#define TOPI_X86_SOFTMAX_H_
+
+#include "topi/tags.h"
+#include "topi/detail/fuse.h"
+#include "topi/x86/default.h"
+#include "topi/x86/util.h"
+#include "tvm/tvm.h"
+#include "tvm/build_module.h"
+
+namespace topi {
+using namespace tvm;
+
+namespace x86 {
+
+/*!
+* \brief Vectorize the reduction of a stage along its contiguous last axis,
+*  by accumulating vec_len partial results in a vector.
+*
+* \param sch The schedule to update.
+* \param red The reduction tensor.
+* \param vec_len The number of lanes.
+*/
+inline void VectorizeRowReduction(Schedule sch, const Tensor& red, int vec_len) {
+  IterVar k = red->op.as<ComputeOpNode>()->reduce_axis[0];
+  const int64_t* extent = as_const_int(k->dom->extent);
+  if (extent == nullptr || *extent % vec_len != 0 || *extent <= vec_len) return;
+  IterVar ko, ki;
+  sch[red].split(k, vec_len, &ko, &ki);
+  Tensor rf = sch.rfactor(red, ki)[0];
+  const ComputeOpNode* rf_op = sch[rf]->op.as<ComputeOpNode>();
+  IterVar lane = rf_op->axis[0];
+  Array<IterVar> order;
+  for (size_t i = 1; i < rf_op->axis.size(); ++i) {
+    order.push_back(rf_op->axis[i]);
+  }
+  order.push_back(rf_op->reduce_axis[0]);
+  order.push_back(lane);
+  sch[rf].reorder(order);
+  sch[rf].vectorize(lane);
+  const ComputeOpNode* red_op = sch[red]->op.as<ComputeOpNode>();
+  if (red_op->axis.size() != 0) {
+    sch[rf].compute_at(sch[red], red_op->axis[red_op->axis.size() - 1]);
+  }
+}
+
+/*!
+* \brief Create a x86 schedule for the given softmax or log_softmax output tensors.
+*
+*  The max and the sum of each row are computed at the outer loop of the
+*  output, so the row stays in cache across the passes over it, and the
+*  passes along a contiguous axis are vectorized.
+*
+* \param target The target to generate a schedule for.
+* \param outs The output tensors.
+*
+* \return A schedule for the given ops.
+*/
+inline Schedule schedule_softmax(const Target &target, const Array<Tensor>& outs) {
+  auto softmax = outs[0];
+  if (!softmax->op->attrs.count("axis")) {
+    return MakeDefaultSchedule(target, outs, false);
+  }
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  auto s = create_schedule(out_ops);
+  int axis = static_cast<int>(softmax->op->attrs["axis"].as<ir::IntImm>()->value);
+  auto max_elem = softmax->op->InputTensors()[1];
+  auto expsum = softmax->op->InputTensors()[2];
+  int vec_len = GetFP32Len(target);
+  auto axes = softmax->op.as<ComputeOpNode>()->axis;
+
+  if (axis > 0) {
+    Array<IterVar> outer;
+    for (int i = 0; i < axis; ++i) {
+      outer.push_back(axes[i]);
+    }
+    auto fused = detail::Fuse(s[softmax], outer);
+    s[softmax].parallel(fused);
+    s[max_elem].compute_at(s[softmax], fused);
+    s[expsum].compute_at(s[softmax], fused);
+  }
+
+  IterVar xo, xi;
+  if (axis == static_cast<int>(axes.size()) - 1) {
+    // reduce along the contiguous row
+    VectorizeRowReduction(s, max_elem, vec_len);
+    VectorizeRowReduction(s, expsum, vec_len);
+    s[softmax].split(axes[axis], vec_len, &xo, &xi);
+  } else {
+    // reduce across the inner axes, which are contiguous
+    for (const Tensor& red : {max_elem, expsum}) {
+      const ComputeOpNode* red_op = s[red]->op.as<ComputeOpNode>();
+      Array<IterVar> inner;
+      Array<IterVar> order{red_op->reduce_axis[0]};
+      for (size_t i = axis; i < red_op->axis.size(); ++i) {
+        inner.push_back(red_op->axis[i]);
+        order.push_back(red_op->axis[i]);
+      }
+      s[red].reorder(order);
+      IterVar ro, ri;
+      s[red].split(detail::Fuse(s[red], inner), vec_len, &ro, &ri);
+      s[red].vectorize(ri);
+    }
+    Array<IterVar> inner;
+    for (size_t i = axis + 1; i < axes.size(); ++i) {
+      inner.push_back(axes[i]);
+    }
+    s[softmax].split(detail::Fuse(s[softmax], inner), vec_len, &xo, &xi);
+  }
+  s[softmax].vectorize(xi);
+  return s;
+}
+
+}  // namespace x86
+}  // namespace topi
+#endif  // TOPI_X86_SOFTMAX_H_
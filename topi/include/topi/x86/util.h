@@ -0,0 +1,49 @@
+/*!
+*  Copyright (c) 2018 by Contributors
+* \file x86/util.h
+* \brief Common x86 related utilities
+*/
+#ifndef TOPI_X86_UTIL_H_
+#define TOPI_X86_UTIL_H_
+
+#include "tvm/tvm.h"
+#include "tvm/build_module.h"
+
+namespace topi {
+using namespace tvm;
+
+namespace x86 {
+/*!
+* \brief Get the number of fp32 lanes in a vector register of the target.
+*
+* \param target The target, can be undefined.
+*
+* \return 16 when AVX-512 is available, 8 otherwise.
+*/
+inline int GetFP32Len(const Target& target) {
+  if (target.defined()) {
+    for (const std::string& opt : target->options()) {
+      if (opt == "-mcpu=skylake-avx512") return 16;
+    }
+  }
+  return 8;
+}
+
+/*!
+* \brief Get the largest divisor of n that is not larger than max_factor.
+*
+* \param n The number to divide.
+* \param max_factor The maximum factor.
+*
+* \return The largest divisor, at least 1.
+*/
+inline int LargestDivisor(int64_t n, int max_factor) {
+  for (int bn = max_factor; bn > 1; --bn) {
+    if (n % bn == 0) return bn;
+  }
+  return 1;
+}
+
+}  // namespace x86
+}  // namespace topi
+#endif  // TOPI_X86_UTIL_H_
@@ -9,6 +9,7 @@ from .elemwise import *
 from .dilate import *
 from .flatten import *
 from .dense import *
+from .batch_matmul import *
 from .mapping import *
 from .pooling import *
 from .softmax import *
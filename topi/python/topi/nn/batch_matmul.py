@@ -0,0 +1,26 @@
+"""Batch matrix multiplication"""
+# pylint: disable=invalid-name
+from __future__ import absolute_import as _abs
+import tvm
+from .. import cpp
+
+
+@tvm.target.generic_func
+def batch_matmul(x, y):
+    """Computes batch matrix multiplication of `x` and `y` when `x` and `y` are
+    data in batch.
+
+    Parameters
+    ----------
+    x : tvm.Tensor
+        3-D with shape [batch, M, K]
+
+    y : tvm.Tensor
+        3-D with shape [batch, N, K]
+
+    Returns
+    -------
+    output : tvm.Tensor
+        3-D with shape [batch, M, N]
+    """
+    return cpp.nn.batch_matmul(x, y)
@@ -43,6 +43,10 @@ def pad(data, pad_before, pad_after=None, pad_value=0.0, name="PadInput"):
             (data.shape[i] + pad_before[i] + pad_after[i])) for i in range(n))
     pad_value = (pad_value if isinstance(pad_value, tvm.expr.Expr)
                  else tvm.const(pad_value, data.dtype))
+    # Loops of symbolic extent are always partitioned, so only the border of
+    # constant shapes is marked for LoopPartition.
+    const_shape = all(isinstance(x, (int, tvm.expr.IntImm, tvm.expr.UIntImm))
+                      for x in list(data.shape) + list(pad_before) + list(pad_after))
     def _pad(*indices):
         not_zero = []
         index_tuple = []
@@ -55,6 +59,9 @@ def pad(data, pad_before, pad_after=None, pad_value=0.0, name="PadInput"):
                 not_zero.append(indices[i] < data.shape[i] + pad_before[i])
         if not_zero:
             not_zero = tvm.all(*not_zero)
+            # likely lets LoopPartition split the border off the loops
+            if const_shape:
+                not_zero = tvm.call_pure_intrin("bool", "likely", not_zero)
             return tvm.if_then_else(not_zero, data(*index_tuple), pad_value)
         return data(*index_tuple)
     return tvm.compute(out_shape, _pad, name=name)
@@ -47,7 +47,8 @@ def softmax(x, axis=-1):
     reduced_shape = tuple([dim for (i, dim) in enumerate(shape) if i != axis])
     max_elem = tvm.compute(reduced_shape, _compute_max)
     expsum = tvm.compute(reduced_shape, lambda *indices: _compute_expsum(max_elem, *indices))
-    return tvm.compute(shape, lambda *indices: _normalize(max_elem, expsum, *indices))
+    return tvm.compute(shape, lambda *indices: _normalize(max_elem, expsum, *indices),
+                       attrs={"axis": axis})
 
 
 @tvm.tag_scope(tag='log_softmax_output')
@@ -73,4 +74,5 @@ def log_softmax(x):
     expsum = tvm.compute(
         (m, ), lambda i: tvm.sum(tvm.exp(x[i, k] - max_elem[i]), axis=k))
     return tvm.compute(
-        x.shape, lambda i, j: x[i, j] - max_elem[i] - tvm.log(expsum[i]))
+        x.shape, lambda i, j: x[i, j] - max_elem[i] - tvm.log(expsum[i]),
+        attrs={"axis": 1})
@@ -5,6 +5,7 @@ from __future__ import absolute_import as _abs
 from .conv2d import schedule_conv2d, schedule_conv2d_nhwc
 from .binarize_pack import schedule_binarize_pack
 from .binary_dense import schedule_binary_dense
+from .batch_matmul import schedule_batch_matmul
 from .nn import *
 from .injective import *
 from .pooling import schedule_pool, schedule_global_pool
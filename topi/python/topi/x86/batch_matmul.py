@@ -0,0 +1,25 @@
+"""x86 batch_matmul operators"""
+from __future__ import absolute_import as _abs
+import tvm
+from .. import generic
+from .. import cpp
+
+
+@generic.schedule_batch_matmul.register(["cpu"])
+def schedule_batch_matmul(outs):
+    """Schedule for batch_matmul
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of batch_matmul
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    target = tvm.target.current_target(allow_none=False)
+    cpp_target = cpp.TEST_create_target(str(target))
+    return cpp.x86.schedule_batch_matmul(cpp_target, outs)
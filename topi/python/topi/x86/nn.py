@@ -9,9 +9,31 @@ from .util import get_fp32_len
 from .. import generic, tag, nn
 from ..util import traverse_inline, get_const_tuple
 
+def _vectorize_row_reduction(s, red, vec_len):
+    """Vectorize the reduction of a stage along its contiguous last axis,
+    by accumulating vec_len partial results in a vector."""
+    k = red.op.reduce_axis[0]
+    extent = k.dom.extent
+    if not isinstance(extent, tvm.expr.IntImm) or extent.value % vec_len != 0 \
+            or extent.value <= vec_len:
+        return
+    _, ki = s[red].split(k, factor=vec_len)
+    red_factor = s.rfactor(red, ki)
+    lane = s[red_factor].op.axis[0]
+    s[red_factor].reorder(*(list(s[red_factor].op.axis[1:]) +
+                            [s[red_factor].op.reduce_axis[0], lane]))
+    s[red_factor].vectorize(lane)
+    if s[red].op.axis:
+        s[red_factor].compute_at(s[red], s[red].op.axis[-1])
+
+
 @generic.schedule_softmax.register(["cpu"])
 def schedule_softmax(outs):
-    """Schedule for softmax
+    """Schedule for softmax and log_softmax
+
+    The max and the sum of each row are computed at the outer loop of the
+    output, so the row stays in cache across the three passes over it, and
+    the passes along a contiguous axis are vectorized.
 
     Parameters
     ----------
@@ -28,14 +50,100 @@ def schedule_softmax(outs):
     x = outs[0]
     s = tvm.create_schedule([x.op for x in outs])
     tvm.schedule.AutoInlineInjective(s)
-    if len(s[x].op.axis) >= 5:
-        fused = s[x].fuse(s[x].op.axis[0], s[x].op.axis[1], s[x].op.axis[2])
-        s[x].parallel(fused)
-    elif len(s[x].op.axis) >= 3:
-        fused = s[x].fuse(s[x].op.axis[0], s[x].op.axis[1])
+    if x.op.tag not in ("softmax_output", "log_softmax_output") or "axis" not in x.op.attrs:
+        if len(s[x].op.axis) >= 5:
+            fused = s[x].fuse(s[x].op.axis[0], s[x].op.axis[1], s[x].op.axis[2])
+            s[x].parallel(fused)
+        elif len(s[x].op.axis) >= 3:
+            fused = s[x].fuse(s[x].op.axis[0], s[x].op.axis[1])
+            s[x].parallel(fused)
+        else:
+            s[x].parallel(s[x].op.axis[0])
+        return s
+
+    axis = x.op.attrs["axis"].value
+    _, max_elem, expsum = x.op.input_tensors
+    vec_len = get_fp32_len()
+
+    outer = s[x].op.axis[:axis]
+    if outer:
+        fused = s[x].fuse(*outer)
         s[x].parallel(fused)
+        s[max_elem].compute_at(s[x], fused)
+        s[expsum].compute_at(s[x], fused)
+
+    if axis == len(x.shape) - 1:
+        # reduce along the contiguous row
+        for red in (max_elem, expsum):
+            _vectorize_row_reduction(s, red, vec_len)
+        _, xi = s[x].split(s[x].op.axis[axis], factor=vec_len)
+        s[x].vectorize(xi)
     else:
-        s[x].parallel(s[x].op.axis[0])
+        # reduce across the inner axes, which are contiguous
+        for red in (max_elem, expsum):
+            inner = s[red].op.axis[axis:]
+            s[red].reorder(*([s[red].op.reduce_axis[0]] + list(inner)))
+            _, xi = s[red].split(s[red].fuse(*inner), factor=vec_len)
+            s[red].vectorize(xi)
+        _, xi = s[x].split(s[x].fuse(*s[x].op.axis[axis + 1:]), factor=vec_len)
+        s[x].vectorize(xi)
+    return s
+
+
+@generic.schedule_l2_normalize.register(["cpu"])
+def schedule_l2_normalize(outs):
+    """Schedule for l2 normalize
+
+    The sum of squares is computed at the outer loop of the output over the
+    axes that are not normalized, and both passes are vectorized along the
+    innermost axis when it is not normalized.
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of l2 normalize
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    outs = [outs] if isinstance(outs, tvm.tensor.Tensor) else outs
+    x = outs[0]
+    s = tvm.create_schedule([x.op for x in outs])
+    tvm.schedule.AutoInlineInjective(s)
+
+    def _find_reduction(op):
+        for t in op.input_tensors:
+            if t.op.reduce_axis:
+                return t
+            if isinstance(t.op, tvm.tensor.ComputeOp):
+                ret = _find_reduction(t.op)
+                if ret is not None:
+                    return ret
+        return None
+    sqsum = _find_reduction(x.op)
+    if sqsum is None:
+        return s
+    vec_len = get_fp32_len()
+    # axes before the first normalized axis
+    num_outer = 0
+    for dim in get_const_tuple(sqsum.shape):
+        if dim == 1:
+            break
+        num_outer += 1
+    if num_outer > 0:
+        fused = s[x].fuse(*s[x].op.axis[:num_outer])
+        s[x].parallel(fused)
+        s[sqsum].compute_at(s[x], fused)
+    if get_const_tuple(sqsum.shape)[-1] != 1:
+        inner = s[sqsum].op.axis[num_outer:]
+        s[sqsum].reorder(*(list(s[sqsum].op.reduce_axis) + list(inner)))
+        _, xi = s[sqsum].split(inner[-1], factor=vec_len)
+        s[sqsum].vectorize(xi)
+    _, xi = s[x].split(s[x].op.axis[-1], factor=vec_len)
+    s[x].vectorize(xi)
     return s
 
 
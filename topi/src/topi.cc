@@ -17,6 +17,7 @@
 #include <topi/reduction.h>
 #include <topi/transform.h>
 
+#include <topi/nn/batch_matmul.h>
 #include <topi/nn/batch_norm.h>
 #include <topi/nn/bnn.h>
 #include <topi/nn/dense.h>
@@ -45,9 +46,13 @@
 #include <topi/cuda/vision.h>
 #include <topi/cuda/normalization.h>
 
+#include <topi/x86/batch_matmul.h>
 #include <topi/x86/bnn.h>
+#include <topi/x86/conv2d.h>
 #include <topi/x86/default.h>
+#include <topi/x86/dense.h>
 #include <topi/x86/injective.h>
+#include <topi/x86/softmax.h>
 
 #include <topi/rocm/dense.h>
 #include <topi/rocm/vision.h>
@@ -351,6 +356,12 @@ TVM_REGISTER_GLOBAL("topi.nn.binary_dense")
   *rv = nn::binary_dense(args[0], args[1]);
   });
 
+/* Ops from nn/batch_matmul.h */
+TVM_REGISTER_GLOBAL("topi.nn.batch_matmul")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = nn::batch_matmul(args[0], args[1]);
+  });
+
 /* Ops from nn/dense.h */
 TVM_REGISTER_GLOBAL("topi.nn.dense")
 .set_body([](TVMArgs args, TVMRetValue *rv) {
@@ -485,6 +496,47 @@ TVM_REGISTER_GLOBAL("topi.x86.schedule_injective")
   *rv = topi::x86::schedule_injective(args[0], args[1]);
   });
 
+TVM_REGISTER_GLOBAL("topi.x86.schedule_softmax")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::schedule_softmax(args[0], args[1]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.pack_data_NCHWc")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::pack_data_NCHWc(args[0], args[1]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.pack_kernel_NCHWc")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::pack_kernel_NCHWc(args[0], args[1], args[2]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.conv2d_NCHWc")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::conv2d_NCHWc(args[0], args[1], args[2], args[3],
+                                args[4], args[5], args[6]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.schedule_conv2d_NCHWc")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::schedule_conv2d_NCHWc(args[0], args[1]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.dense")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::dense_x86(args[0], args[1], args[2], args[3]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.schedule_dense")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::schedule_dense(args[0], args[1]);
+  });
+
+TVM_REGISTER_GLOBAL("topi.x86.schedule_batch_matmul")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = topi::x86::schedule_batch_matmul(args[0], args[1]);
+  });
+
 /* ROCm schedules */
 TVM_REGISTER_GLOBAL("topi.rocm.dense_cuda")
 .set_body([](TVMArgs args, TVMRetValue *rv) {
@@ -602,14 +654,19 @@ TVM_REGISTER_GENERIC_FUNC(schedule_injective)
 
 TVM_REGISTER_GENERIC_FUNC(schedule_softmax)
 .set_default(WrapSchedule(topi::generic::default_schedule))
-.register_func({ "cpu" }, WrapSchedule(topi::x86::default_schedule))
+.register_func({ "cpu" }, WrapSchedule(topi::x86::schedule_softmax))
 .register_func({ "cuda", "gpu" }, WrapSchedule(topi::cuda::schedule_softmax));
 
 TVM_REGISTER_GENERIC_FUNC(schedule_dense)
 .set_default(WrapSchedule(topi::generic::default_schedule))
+.register_func({ "cpu" }, WrapSchedule(topi::x86::schedule_dense))
 .register_func({ "cuda", "gpu" }, WrapSchedule(topi::cuda::schedule_dense))
 .register_func({ "rocm" }, WrapSchedule(topi::rocm::schedule_dense));
 
+TVM_REGISTER_GENERIC_FUNC(schedule_batch_matmul)
+.set_default(WrapSchedule(topi::generic::default_schedule))
+.register_func({ "cpu" }, WrapSchedule(topi::x86::schedule_batch_matmul));
+
 TVM_REGISTER_GENERIC_FUNC(schedule_pool)
 .set_default(WrapSchedule(topi::generic::default_schedule))
 .register_func({ "cpu" }, WrapSchedule(topi::x86::default_schedule))
@@ -625,6 +682,10 @@ TVM_REGISTER_GENERIC_FUNC(schedule_reduce)
 .register_func({ "cpu" }, WrapSchedule(topi::x86::default_schedule_auto_inline))
 .register_func({ "cuda", "gpu" }, WrapSchedule(topi::cuda::schedule_reduce));
 
+TVM_REGISTER_GENERIC_FUNC(schedule_conv2d_NCHWc)
+.set_default(WrapSchedule(topi::generic::default_schedule))
+.register_func({ "cpu" }, WrapSchedule(topi::x86::schedule_conv2d_NCHWc));
+
 TVM_REGISTER_GENERIC_FUNC(schedule_binarize_pack)
 .set_default(WrapSchedule(topi::generic::default_schedule))
 .register_func({ "cpu" }, WrapSchedule(topi::x86::schedule_binarize_pack));
@@ -666,6 +727,7 @@ TVM_REGISTER_GENERIC_FUNC(dense)
                             const tvm::Tensor& bias) {
   return topi::nn::dense(data, weight, bias);
 }))
+.register_func({ "cpu" }, WrapDenseOp(topi::x86::dense_x86))
 .register_func({ "cuda", "gpu" }, WrapDenseOp(topi::cuda::dense_cuda))
 .register_func({ "rocm" }, WrapDenseOp(topi::rocm::dense_rocm));
 
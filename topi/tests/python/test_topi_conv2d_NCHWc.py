@@ -113,6 +113,48 @@ def verify_conv2d_NCHWc(batch, in_channel, in_size, num_filter, kernel, stride,
             check_device(device)
 
 
+def verify_conv2d_NCHWc_cpp(batch, in_channel, in_size, num_filter, kernel, stride, padding):
+    device = "llvm"
+    if not tvm.module.enabled(device):
+        print("Skip because %s is not enabled" % device)
+        return
+    target = tvm.target.create(device)
+    oc_block = 8
+    while num_filter % oc_block != 0:
+        oc_block //= 2
+    ic_block = oc_block
+    while in_channel % ic_block != 0:
+        ic_block //= 2
+
+    A = tvm.placeholder((batch, in_channel, in_size, in_size), name='A')
+    W = tvm.placeholder((num_filter, in_channel, kernel, kernel), name='W')
+    # pack the data and weights in the graph
+    A_vec = topi.cpp.x86.pack_data_NCHWc(A, ic_block)
+    W_vec = topi.cpp.x86.pack_kernel_NCHWc(W, ic_block, oc_block)
+    C = topi.cpp.x86.conv2d_NCHWc(A_vec, W_vec, stride, stride, padding, padding, "float32")
+    C = topi.cpp.nn.relu(C)
+    s = topi.cpp.x86.schedule_conv2d_NCHWc(target, [C])
+
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    c_np = np.maximum(topi.testing.conv2d_nchw_python(a_np, w_np, stride, padding), 0)
+    c_np = _transform_data(c_np, oc_block)
+
+    ctx = tvm.cpu(0)
+    a = tvm.nd.array(a_np, ctx)
+    w = tvm.nd.array(w_np, ctx)
+    c = tvm.nd.array(np.zeros(get_const_tuple(C.shape), dtype=C.dtype), ctx)
+    func = tvm.build(s, [A, W, C], device)
+    func(a, w, c)
+    tvm.testing.assert_allclose(c.asnumpy(), c_np, rtol=1e-5)
+
+
+def test_conv2d_NCHWc_cpp():
+    verify_conv2d_NCHWc_cpp(1,   3, 32,  16, 3, 1, 1)
+    verify_conv2d_NCHWc_cpp(1,  32, 28,  64, 1, 1, 0)
+    verify_conv2d_NCHWc_cpp(1,  64, 14,  32, 3, 2, 1)
+
+
 def test_conv2d_NCHWc():
     # ResNet18 workloads
     verify_conv2d_NCHWc(1,   3, 224,  64, 7, 2, 3)
@@ -202,4 +244,5 @@ def test_conv2d_NCHWc():
     verify_conv2d_NCHWc(1,  256,   3, 126, 3, 1, 1)
 
 if __name__ == "__main__":
-    test_conv2d_NCHWc()
\ No newline at end of file
+    test_conv2d_NCHWc()
+    test_conv2d_NCHWc_cpp()
\ No newline at end of file
@@ -3,7 +3,7 @@ import numpy as np
 import tvm
 import topi
 import topi.testing
-from topi.util import get_const_tuple
+from topi.util import get_const_tuple, get_const_int
 from tvm.contrib.pickle_memoize import memoize
 
 from common import get_all_backend
@@ -49,12 +49,61 @@ def verify_dense(batch, in_dim, out_dim, use_bias=True):
     for device in get_all_backend():
         check_device(device)
 
+def verify_dense_cpp(batch, in_dim, out_dim, use_relu=True):
+    A = tvm.placeholder((batch, in_dim), name='A')
+    B = tvm.placeholder((out_dim, in_dim), name='B')
+    C = tvm.placeholder((out_dim,), name='C')
+    dtype = A.dtype
+    a_np = np.random.uniform(size=(batch, in_dim)).astype(dtype)
+    b_np = np.random.uniform(size=(out_dim, in_dim)).astype(dtype)
+    c_np = np.random.uniform(size=(out_dim,)).astype(dtype)
+    d_np = np.dot(a_np, b_np.T) + c_np
+    if use_relu:
+        d_np = np.maximum(d_np, 0.0)
+
+    device = "llvm"
+    if not tvm.module.enabled(device):
+        print("Skip because %s is not enabled" % device)
+        return
+    ctx = tvm.cpu(0)
+    target = tvm.target.create(device)
+    D = topi.cpp.x86.dense(target, A, B, C)
+    if use_relu:
+        D = topi.cpp.nn.relu(D)
+    s = topi.cpp.x86.schedule_dense(target, [D])
+    # the dense is computed under the tiles of the epilogue, so its
+    # buffer is smaller than the output.
+    allocs = []
+    tvm.ir_pass.PostOrderVisit(
+        tvm.lower(s, [A, B, C, D], simple_mode=True),
+        lambda x: allocs.append(x) if isinstance(x, tvm.stmt.Allocate) else None)
+    for alloc in allocs:
+        if alloc.buffer_var.name.startswith("tensor"):
+            size = np.prod([get_const_int(e) for e in alloc.extents])
+            assert size < batch * out_dim
+    a = tvm.nd.array(a_np, ctx)
+    b = tvm.nd.array(b_np, ctx)
+    c = tvm.nd.array(c_np, ctx)
+    d = tvm.nd.array(np.zeros(get_const_tuple(D.shape), dtype=dtype), ctx)
+    f = tvm.build(s, [A, B, C, D], device, name="dense")
+    f(a, b, c, d)
+    tvm.testing.assert_allclose(d.asnumpy(), d_np, rtol=1e-5)
+
 def test_dense():
     verify_dense(1, 1024, 1000, use_bias=True)
     verify_dense(1, 1024, 1000, use_bias=False)
 
     verify_dense(2, 1024, 1000, use_bias=True)
 
+def test_dense_cpp():
+    # small batch does not pack the weight
+    verify_dense_cpp(1, 1024, 1000)
+    verify_dense_cpp(64, 512, 256)
+    # bias add without an activation as the output
+    verify_dense_cpp(1, 1024, 1000, use_relu=False)
+    verify_dense_cpp(64, 512, 256, use_relu=False)
+
 
 if __name__ == "__main__":
     test_dense()
+    test_dense_cpp()
@@ -34,19 +34,19 @@ def verify_softmax(m, n, dtype="float32"):
     a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
     b_np = topi.testing.softmax_python(a_np)
 
-    for device in ['cuda', 'opencl', 'metal', 'rocm', 'vulkan', 'nvptx']:
+    for device in get_all_backend():
         check_device(A, B, a_np, b_np, device, "softmax")
 
 def verify_softmax_4d(shape, dtype="float32"):
     A = tvm.placeholder(shape, dtype=dtype, name='A')
     B = topi.nn.softmax(A, axis=1)
 
-    _, c, h, w = shape
+    n, c, h, w = shape
     a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
-    b_np = topi.testing.softmax_python(a_np.transpose(0, 2, 3, 1).reshape(h*w, c))
-    b_np = b_np.reshape(1, h, w, c).transpose(0, 3, 1, 2)
+    b_np = topi.testing.softmax_python(a_np.transpose(0, 2, 3, 1).reshape(n*h*w, c))
+    b_np = b_np.reshape(n, h, w, c).transpose(0, 3, 1, 2)
 
-    for device in ['cuda', 'opencl', 'metal', 'rocm', 'vulkan', 'nvptx']:
+    for device in get_all_backend():
         check_device(A, B, a_np, b_np, device, "softmax")
 
 def test_softmax():
@@ -54,6 +54,7 @@ def test_softmax():
     verify_softmax(3, 4)
     verify_softmax(32, 10, "float64")
     verify_softmax_4d((1, 16, 256, 256))
+    verify_softmax_4d((2, 16, 7, 9))
 
 def verify_log_softmax(m, n, dtype="float32"):
     A = tvm.placeholder((m, n), dtype=dtype, name='A')